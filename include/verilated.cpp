@@ -25,7 +25,18 @@
 
 #define _VERILATED_CPP_
 #include "verilated_imp.h"
+#include <algorithm>
 #include <cctype>
+#include <new>
+#if VL_SIMD
+# include <immintrin.h>
+#endif
+
+#if defined(__linux)
+# include <pthread.h>
+# include <sched.h>
+# include <sys/mman.h>
+#endif
 
 #define VL_VALUE_STRING_MAX_WIDTH 8192	///< Max static char array for VL_VALUE_STRING
 
@@ -35,6 +46,8 @@
 // Slow path variables
 VerilatedMutex Verilated::m_mutex;
 VerilatedVoidCb Verilated::s_flushCb = NULL;
+bool Verilated::s_threadPinning = false;
+int Verilated::s_pinNext = 0;
 
 // Keep below together in one cache line
 Verilated::Serialized Verilated::s_s;
@@ -86,9 +99,7 @@ void vl_fatal (const char* filename, int linenum, const char* hier, const char*
 
 void VL_FINISH_MT (const char* filename, int linenum, const char* hier) VL_MT_SAFE {
 #ifdef VL_THREADED
-    VerilatedThreadMsgQueue::post(VerilatedMsg([=](){
-		vl_finish(filename, linenum, hier);
-	    }));
+    VerilatedThreadMsgQueue::post(VerilatedMsg(VerilatedMsg::MSG_FINISH, filename, linenum, hier));
 #else
     vl_finish(filename, linenum, hier);
 #endif
@@ -96,9 +107,7 @@ void VL_FINISH_MT (const char* filename, int linenum, const char* hier) VL_MT_SA
 
 void VL_STOP_MT (const char* filename, int linenum, const char* hier) VL_MT_SAFE {
 #ifdef VL_THREADED
-    VerilatedThreadMsgQueue::post(VerilatedMsg([=](){
-		vl_stop(filename, linenum, hier);
-	    }));
+    VerilatedThreadMsgQueue::post(VerilatedMsg(VerilatedMsg::MSG_STOP, filename, linenum, hier));
 #else
     vl_stop(filename, linenum, hier);
 #endif
@@ -106,9 +115,7 @@ void VL_STOP_MT (const char* filename, int linenum, const char* hier) VL_MT_SAFE
 
 void VL_FATAL_MT (const char* filename, int linenum, const char* hier, const char* msg) VL_MT_SAFE {
 #ifdef VL_THREADED
-    VerilatedThreadMsgQueue::post(VerilatedMsg([=](){
-		vl_fatal(filename, linenum, hier, msg);
-	    }));
+    VerilatedThreadMsgQueue::post(VerilatedMsg(VerilatedMsg::MSG_FATAL, filename, linenum, hier, msg));
 #else
     vl_fatal(filename, linenum, hier, msg);
 #endif
@@ -176,11 +183,26 @@ void VL_DBG_MSGF(const char* formatp, ...) VL_MT_SAFE {
 void VL_PRINTF_MT(const char* formatp, ...) VL_MT_SAFE {
     va_list ap;
     va_start(ap, formatp);
-    std::string out = _vl_string_vprintf(formatp, ap);
+    if (Verilated::mtaskId() == 0) {
+        // Outside any mtask, print immediately
+        std::string out = _vl_string_vprintf(formatp, ap);  // Ends ap
+        VL_PRINTF("%s", out.c_str());
+        return;
+    }
+    // Format straight into this thread's arena
+    std::string& arena = VerilatedThreadMsgQueue::arena();
+    size_t begin = arena.size();
+    va_list aq;
+    va_copy(aq, ap);
+    int len = VL_VSNPRINTF(NULL, 0, formatp, aq);
+    va_end(aq);
+    if (VL_LIKELY(len > 0)) {
+        arena.resize(begin + len + 1);
+        VL_VSNPRINTF(&arena[begin], len + 1, formatp, ap);
+        arena.resize(begin + len);  // Drop the terminator
+    }
     va_end(ap);
-    VerilatedThreadMsgQueue::post(VerilatedMsg([=](){
-		VL_PRINTF("%s", out.c_str());
-	    }));
+    VerilatedThreadMsgQueue::postText(begin);
 }
 #endif
 
@@ -191,7 +213,6 @@ Verilated::Serialized::Serialized() {
     s_randReset = 0;
     s_debug = 0;
     s_calcUnusedSigs = false;
-    s_gotFinish = false;
     s_assertOn = true;
     s_fatalOnVpiError = true; // retains old default behaviour
 }
@@ -293,9 +314,249 @@ void _VL_DEBUG_PRINT_W(int lbits, WDataInP iwp) VL_MT_SAFE {
 //===========================================================================
 // Slow math
 
+#if VL_MUL_INT128
+// Wide multiply on 64-bit limbs.  Verilog keeps only the low bits of a
+// product, so the top-level routines compute just the low limbs.
+
+__extension__ typedef unsigned __int128 vluint128_t;
+
+static void vl_limbs_load(QData* limbsp, WDataInP wp, int words) {
+    for (int i=0; i<words/2; ++i) limbsp[i] = _VL_LIMB_Q(wp, i);
+    if (words & 1) limbsp[words/2] = wp[words-1];
+}
+static void vl_limbs_store(WDataOutP wp, const QData* limbsp, int words) {
+    for (int i=0; i<words/2; ++i) _VL_SET_LIMB_Q(wp, i, limbsp[i]);
+    if (words & 1) wp[words-1] = static_cast<IData>(limbsp[words/2]);
+}
+// op[0..n) += ap[0..an), returning the carry out
+static QData vl_limbs_add(QData* op, int n, const QData* ap, int an) {
+    QData carry = 0;
+    for (int i=0; i<n; ++i) {
+	QData a = (i < an) ? ap[i] : 0;
+	QData sum = op[i] + a;
+	QData carryout = (sum < a);
+	sum += carry;
+	carryout |= (sum < carry);
+	op[i] = sum;
+	carry = carryout;
+	if (i >= an && !carry) break;
+    }
+    return carry;
+}
+// op[0..n) -= ap[0..an)
+static void vl_limbs_sub(QData* op, int n, const QData* ap, int an) {
+    QData borrow = 0;
+    for (int i=0; i<n; ++i) {
+	QData a = (i < an) ? ap[i] : 0;
+	QData diff = op[i] - a;
+	QData borrowout = (op[i] < a);
+	borrowout |= (diff < borrow);
+	op[i] = diff - borrow;
+	borrow = borrowout;
+	if (i >= an && !borrow) break;
+    }
+}
+// Schoolbook: op[0..on) = low on limbs of ap[0..n) * bp[0..n)
+static void vl_mul_school(QData* op, int on, const QData* ap, const QData* bp, int n) {
+    for (int i=0; i<on; ++i) op[i] = 0;
+    for (int i=0; i<n && i<on; ++i) {
+	QData carry = 0;
+	int j = 0;
+	for (; j<n && i+j<on; ++j) {
+	    vluint128_t p = static_cast<vluint128_t>(ap[i]) * bp[j] + op[i+j] + carry;
+	    op[i+j] = static_cast<QData>(p);
+	    carry = static_cast<QData>(p >> 64);
+	}
+	if (i+j < on) op[i+j] = carry;
+    }
+}
+// Karatsuba: op[0..2n) = ap[0..n) * bp[0..n), using scratch tp
+static void vl_mul_full(QData* op, const QData* ap, const QData* bp, int n, QData* tp) {
+    if (n < VL_MUL_KARATSUBA_WORDS/2) { vl_mul_school(op, 2*n, ap, bp, n); return; }
+    // a = a1*B^h + a0, so a*b = z2*B^2h + (z1-z2-z0)*B^h + z0 where z1 = (a0+a1)*(b0+b1)
+    int h = (n+1)/2;
+    int m = n - h;
+    vl_mul_full(op, ap, bp, h, tp);  // z0
+    QData* z2p = tp;
+    vl_mul_full(z2p, ap+h, bp+h, m, tp+2*m);
+    for (int i=0; i<2*m; ++i) op[2*h+i] = z2p[i];
+    QData* sap = tp;
+    QData* sbp = sap + (h+1);
+    QData* z1p = sbp + (h+1);
+    for (int i=0; i<h; ++i) { sap[i] = ap[i]; sbp[i] = bp[i]; }
+    sap[h] = vl_limbs_add(sap, h, ap+h, m);
+    sbp[h] = vl_limbs_add(sbp, h, bp+h, m);
+    vl_mul_full(z1p, sap, sbp, h+1, z1p + 2*(h+1));
+    vl_limbs_sub(z1p, 2*(h+1), op, 2*h);
+    vl_limbs_sub(z1p, 2*(h+1), op+2*h, 2*m);
+    vl_limbs_add(op+h, 2*n-h, z1p, 2*(h+1));
+}
+// op[0..n) = low n limbs of ap[0..n) * bp[0..n): the full product of the
+// low halves, plus the two cross products' low halves
+static void vl_mul_low(QData* op, const QData* ap, const QData* bp, int n, QData* tp) {
+    if (n < VL_MUL_KARATSUBA_WORDS/2) { vl_mul_school(op, n, ap, bp, n); return; }
+    int h = (n+1)/2;
+    int m = n - h;
+    QData* z0p = tp;
+    vl_mul_full(z0p, ap, bp, h, tp+2*h);
+    for (int i=0; i<n; ++i) op[i] = z0p[i];
+    QData* crossp = tp;
+    vl_mul_low(crossp, ap+h, bp, m, tp+m);
+    vl_limbs_add(op+h, m, crossp, m);
+    vl_mul_low(crossp, ap, bp+h, m, tp+m);
+    vl_limbs_add(op+h, m, crossp, m);
+}
+
+WDataOutP _vl_mul_w(int words, WDataOutP owp, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
+    int limbs = (words+1)/2;
+    if (words < VL_MUL_KARATSUBA_WORDS) {
+	QData lbuf[VL_MUL_KARATSUBA_WORDS/2];
+	QData rbuf[VL_MUL_KARATSUBA_WORDS/2];
+	QData obuf[VL_MUL_KARATSUBA_WORDS/2];
+	vl_limbs_load(lbuf, lwp, words);
+	vl_limbs_load(rbuf, rwp, words);
+	vl_mul_school(obuf, limbs, lbuf, rbuf, limbs);
+	vl_limbs_store(owp, obuf, words);
+    } else {
+	// Each Karatsuba level needs under 4 limbs of scratch per operand limb,
+	// plus a few for the odd splits.  That fits on the stack to about 8K
+	// bits; wider products are slow enough not to notice a heap buffer.
+	enum { STACK_LIMBS = 2048 };
+	QData stackbuf[STACK_LIMBS];
+	size_t bufLimbs = 3*limbs + 8*limbs + 64*8;
+	QData* heapbufp = (bufLimbs > STACK_LIMBS) ? new QData[bufLimbs] : NULL;
+	QData* lbufp = heapbufp ? heapbufp : stackbuf;
+	QData* rbufp = lbufp + limbs;
+	QData* obufp = rbufp + limbs;
+	vl_limbs_load(lbufp, lwp, words);
+	vl_limbs_load(rbufp, rwp, words);
+	vl_mul_low(obufp, lbufp, rbufp, limbs, obufp + limbs);
+	vl_limbs_store(owp, obufp, words);
+	if (heapbufp) delete [] heapbufp;
+    }
+    // Last output word is dirty
+    return owp;
+}
+
+// Wide divide on 64-bit limbs
+
+__extension__ typedef __int128 vlsint128_t;
+
+// 128 by 64 bit divide of u1:u0 by normalized d, where u1 < d, using
+// dinv from vl_div_preinv_inverse.  Multiplies instead of dividing; see
+// Moller and Granlund, "Improved division by invariant integers".
+static inline QData vl_div_preinv_inverse(QData d) {
+    return static_cast<QData>(~static_cast<vluint128_t>(0) / d);  // floor((2^128-1)/d) - 2^64
+}
+static inline QData vl_div_preinv(QData& remr, QData u1, QData u0, QData d, QData dinv) {
+    vluint128_t q = static_cast<vluint128_t>(dinv) * u1;
+    q += (static_cast<vluint128_t>(u1) << 64) | u0;
+    QData q1 = static_cast<QData>(q >> 64) + 1;
+    QData q0 = static_cast<QData>(q);
+    QData r = u0 - q1*d;
+    if (r > q0) { --q1; r += d; }
+    if (VL_UNLIKELY(r >= d)) { ++q1; r -= d; }
+    remr = r;
+    return q1;
+}
+// Shift limbs left by 0..63 bits, in place, returning the bits shifted out
+static QData vl_limbs_shiftl(QData* limbsp, int n, int s) {
+    if (!s) return 0;
+    QData out = limbsp[n-1] >> (64-s);
+    for (int i=n-1; i>0; --i) limbsp[i] = (limbsp[i] << s) | (limbsp[i-1] >> (64-s));
+    limbsp[0] <<= s;
+    return out;
+}
+
+// Knuth Algorithm D on 64-bit limbs, for _vl_moddiv_w
+static WDataOutP vl_moddiv_limbs(int words, WDataOutP owp, WDataInP lwp, WDataInP rwp,
+				 int umsbp1, int vmsbp1, bool is_modulus) VL_MT_SAFE {
+    int wl = (words+1)/2;
+    int ul = (umsbp1+63)/64;  // aka "m" in the algorithm
+    int vl = (vmsbp1+63)/64;  // aka "n" in the algorithm
+    // un is +1 limb as we may shift during normalization
+    QData store[3*(VL_MULS_MAX_WORDS/2+1)+1];  // Fixed size, as MSVC++ doesn't allow [words] here
+    std::vector<QData> heap;
+    QData* un = store;
+    if (words > VL_MULS_MAX_WORDS) { heap.resize(3*wl+1); un = &heap[0]; }
+    QData* vn = un + wl+1;  // v normalized
+    QData* qn = vn + wl;  // Quotient, then remainder
+    for (int i=0; i<wl; ++i) qn[i] = 0;
+
+    // Normalize so MSB of vn[vl-1] is set; shift dividend by same amount
+    int s = 63 - ((vmsbp1-1) & 63);
+    vl_limbs_load(un, lwp, words);
+    vl_limbs_load(vn, rwp, words);
+    un[ul] = vl_limbs_shiftl(un, ul, s);
+    vl_limbs_shiftl(vn, vl, s);
+
+    if (vl == 1) {  // Single limb divisor, by reciprocal
+	QData d = vn[0];
+	QData dinv = vl_div_preinv_inverse(d);
+	QData r = un[ul];
+	for (int j=ul-1; j>=0; --j) qn[j] = vl_div_preinv(r, r, un[j], d, dinv);
+	if (is_modulus) {
+	    for (int i=0; i<wl; ++i) qn[i] = 0;
+	    qn[0] = r >> s;
+	}
+	vl_limbs_store(owp, qn, words);
+	return owp;
+    }
+
+    // Main loop
+    for (int j = ul - vl; j >= 0; --j) {
+	// Estimate
+	vluint128_t unw128 = (static_cast<vluint128_t>(un[j+vl]) << 64) | un[j+vl-1];
+	vluint128_t qhat = unw128 / vn[vl-1];
+	vluint128_t rhat = unw128 - qhat*vn[vl-1];
+
+      again:
+	if ((qhat >> 64)
+	    || (qhat*vn[vl-2] > ((rhat << 64) | un[j+vl-2]))) {
+	    qhat = qhat - 1;
+	    rhat = rhat + vn[vl-1];
+	    if (!(rhat >> 64)) goto again;
+	}
+
+	vlsint128_t t = 0;  // Must be signed
+	vluint128_t k = 0;
+	for (int i=0; i<vl; ++i) {
+	    vluint128_t p = qhat*vn[i];  // Multiply by estimate
+	    t = static_cast<vlsint128_t>(un[i+j]) - k - static_cast<QData>(p);  // Subtract
+	    un[i+j] = static_cast<QData>(t);
+	    k = (p >> 64) - (t >> 64);
+	}
+	t = static_cast<vlsint128_t>(un[j+vl]) - k;
+	un[j+vl] = static_cast<QData>(t);
+	qn[j] = static_cast<QData>(qhat);  // Save quotient digit
+
+	if (t < 0) {
+	    // Over subtracted; correct by adding back
+	    qn[j]--;
+	    QData carry = 0;
+	    for (int i=0; i<vl; ++i) {
+		vluint128_t sum = static_cast<vluint128_t>(un[i+j]) + vn[i] + carry;
+		un[i+j] = static_cast<QData>(sum);
+		carry = static_cast<QData>(sum >> 64);
+	    }
+	    un[j+vl] += carry;
+	}
+    }
+
+    if (is_modulus) {
+	// Need to reverse normalization on copy to output
+	for (int i=0; i<wl; ++i) qn[i] = 0;
+	for (int i=0; i<vl; ++i) {
+	    qn[i] = s ? ((un[i] >> s) | (un[i+1] << (64-s))) : un[i];
+	}
+    }
+    vl_limbs_store(owp, qn, words);
+    return owp;
+}
+#endif  // VL_MUL_INT128
+
 WDataOutP _vl_moddiv_w(int lbits, WDataOutP owp, WDataInP lwp, WDataInP rwp, bool is_modulus) VL_MT_SAFE {
     // See Knuth Algorithm D.  Computes u/v = q.r
-    // This isn't massively tuned, as wide division is rare
     // for debug see V3Number version
     // Requires clean input
     int words = VL_WORDS_I(lbits);
@@ -307,7 +568,25 @@ WDataOutP _vl_moddiv_w(int lbits, WDataOutP owp, WDataInP lwp, WDataInP rwp, boo
 	|| VL_UNLIKELY(umsbp1==0)) {	// 0/x so short circuit and return 0
 	return owp;
     }
+    if (umsbp1 < vmsbp1) {  // u<v so quotient is zero, remainder is u
+	if (is_modulus) {
+	    for (int i=0; i<words; ++i) owp[i] = lwp[i];
+	}
+	return owp;
+    }
+    if (VL_ONEHOT_W(VL_WORDS_I(vmsbp1), rwp)) {  // Power of two, so shift or mask
+	int shift = vmsbp1-1;
+	if (!is_modulus) return VL_SHIFTR_WWI(lbits, lbits, 32, owp, lwp, shift);
+	for (int i=0; i<VL_BITWORD_I(shift); ++i) owp[i] = lwp[i];
+	if (VL_BITBIT_I(shift)) {
+	    owp[VL_BITWORD_I(shift)] = lwp[VL_BITWORD_I(shift)] & VL_MASK_I(VL_BITBIT_I(shift));
+	}
+	return owp;
+    }
 
+#if VL_MUL_INT128
+    return vl_moddiv_limbs(words, owp, lwp, rwp, umsbp1, vmsbp1, is_modulus);
+#else
     int uw = VL_WORDS_I(umsbp1);  // aka "m" in the algorithm
     int vw = VL_WORDS_I(vmsbp1);  // aka "n" in the algorithm
 
@@ -326,8 +605,12 @@ WDataOutP _vl_moddiv_w(int lbits, WDataOutP owp, WDataInP lwp, WDataInP rwp, boo
     }
 
     // +1 word as we may shift during normalization
-    vluint32_t un[VL_MULS_MAX_WORDS+1]; // Fixed size, as MSVC++ doesn't allow [words] here
-    vluint32_t vn[VL_MULS_MAX_WORDS+1]; // v normalized
+    // Fixed size on the stack, as MSVC++ doesn't allow [words] here; heap if wider
+    vluint32_t unvnstore[2*(VL_MULS_MAX_WORDS+1)];
+    std::vector<vluint32_t> unvnheap;
+    vluint32_t* un = unvnstore;
+    if (words > VL_MULS_MAX_WORDS) { unvnheap.resize(2*(words+1)); un = &unvnheap[0]; }
+    vluint32_t* vn = un + words+1; // v normalized
 
     // Zero for ease of debugging and to save having to zero for shifts
     // Note +1 as loop will use extra word
@@ -400,6 +683,7 @@ WDataOutP _vl_moddiv_w(int lbits, WDataOutP owp, WDataInP lwp, WDataInP rwp, boo
     } else { // division
 	return owp;
     }
+#endif
 }
 
 WDataOutP VL_POW_WWW(int obits, int, int rbits, WDataOutP owp, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
@@ -481,6 +765,219 @@ QData VL_POWSS_QQW(int obits, int, int rbits, QData lhs, WDataInP rwp, bool lsig
     return VL_POW_QQW(obits, rbits, rbits, lhs, rwp);
 }
 
+//===========================================================================
+// SIMD kernels for wide operations
+//
+// Each kernel has an AVX2 and an SSE2 flavor; the first call picks the
+// widest the CPU supports.  Operands are only 4-byte aligned, so all
+// vector loads and stores are unaligned.
+
+#if VL_SIMD
+
+#define VL_SIMD_TARGET_AVX2 __attribute__ ((target ("avx2,popcnt")))
+
+// Bitwise kernels: owp = lwp op rwp
+#define VL_SIMD_BITWISE_AVX2(name, vop, op) \
+    static VL_SIMD_TARGET_AVX2 void name(int words, WDataOutP owp, WDataInP lwp, WDataInP rwp) { \
+	int i = 0; \
+	for (; i+8 <= words; i += 8) { \
+	    __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lwp+i)); \
+	    __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rwp+i)); \
+	    _mm256_storeu_si256(reinterpret_cast<__m256i*>(owp+i), vop(l, r)); \
+	} \
+	for (; i < words; ++i) owp[i] = lwp[i] op rwp[i]; \
+    }
+#define VL_SIMD_BITWISE_SSE2(name, vop, op) \
+    static void name(int words, WDataOutP owp, WDataInP lwp, WDataInP rwp) { \
+	int i = 0; \
+	for (; i+4 <= words; i += 4) { \
+	    __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lwp+i)); \
+	    __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rwp+i)); \
+	    _mm_storeu_si128(reinterpret_cast<__m128i*>(owp+i), vop(l, r)); \
+	} \
+	for (; i < words; ++i) owp[i] = lwp[i] op rwp[i]; \
+    }
+
+VL_SIMD_BITWISE_AVX2(vl_and_avx2, _mm256_and_si256, &)
+VL_SIMD_BITWISE_AVX2(vl_or_avx2, _mm256_or_si256, |)
+VL_SIMD_BITWISE_AVX2(vl_xor_avx2, _mm256_xor_si256, ^)
+VL_SIMD_BITWISE_SSE2(vl_and_sse2, _mm_and_si128, &)
+VL_SIMD_BITWISE_SSE2(vl_or_sse2, _mm_or_si128, |)
+VL_SIMD_BITWISE_SSE2(vl_xor_sse2, _mm_xor_si128, ^)
+
+// Fold a vector accumulator into one word
+static VL_SIMD_TARGET_AVX2 IData vl_fold_or_avx2(__m256i acc) {
+    __m128i v = _mm_or_si128(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    v = _mm_or_si128(v, _mm_srli_si128(v, 8));
+    v = _mm_or_si128(v, _mm_srli_si128(v, 4));
+    return _mm_cvtsi128_si32(v);
+}
+static VL_SIMD_TARGET_AVX2 IData vl_fold_xor_avx2(__m256i acc) {
+    __m128i v = _mm_xor_si128(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    v = _mm_xor_si128(v, _mm_srli_si128(v, 8));
+    v = _mm_xor_si128(v, _mm_srli_si128(v, 4));
+    return _mm_cvtsi128_si32(v);
+}
+static IData vl_fold_or_sse2(__m128i v) {
+    v = _mm_or_si128(v, _mm_srli_si128(v, 8));
+    v = _mm_or_si128(v, _mm_srli_si128(v, 4));
+    return _mm_cvtsi128_si32(v);
+}
+static IData vl_fold_xor_sse2(__m128i v) {
+    v = _mm_xor_si128(v, _mm_srli_si128(v, 8));
+    v = _mm_xor_si128(v, _mm_srli_si128(v, 4));
+    return _mm_cvtsi128_si32(v);
+}
+
+// OR of lwp ^ rwp, as VL_CHANGEXOR_W; zero when equal
+static VL_SIMD_TARGET_AVX2 IData vl_changexor_avx2(int words, WDataInP lwp, WDataInP rwp) {
+    __m256i acc = _mm256_setzero_si256();
+    int i = 0;
+    for (; i+8 <= words; i += 8) {
+	acc = _mm256_or_si256(acc, _mm256_xor_si256(
+				  _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lwp+i)),
+				  _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rwp+i))));
+    }
+    IData od = vl_fold_or_avx2(acc);
+    for (; i < words; ++i) od |= lwp[i] ^ rwp[i];
+    return od;
+}
+static IData vl_changexor_sse2(int words, WDataInP lwp, WDataInP rwp) {
+    __m128i acc = _mm_setzero_si128();
+    int i = 0;
+    for (; i+4 <= words; i += 4) {
+	acc = _mm_or_si128(acc, _mm_xor_si128(
+			       _mm_loadu_si128(reinterpret_cast<const __m128i*>(lwp+i)),
+			       _mm_loadu_si128(reinterpret_cast<const __m128i*>(rwp+i))));
+    }
+    IData od = vl_fold_or_sse2(acc);
+    for (; i < words; ++i) od |= lwp[i] ^ rwp[i];
+    return od;
+}
+
+// Unsigned compare as _VL_CMP_W: skip equal vectors from the top, then
+// compare the first differing vector's words
+static inline int vl_cmp_words(int hi, int lo, WDataInP lwp, WDataInP rwp) {
+    for (int i=hi; i>=lo; --i) {
+	if (lwp[i] > rwp[i]) return 1;
+	if (lwp[i] < rwp[i]) return -1;
+    }
+    return 0;
+}
+static VL_SIMD_TARGET_AVX2 int vl_cmp_avx2(int words, WDataInP lwp, WDataInP rwp) {
+    int i = words & ~7;
+    if (int c = vl_cmp_words(words-1, i, lwp, rwp)) return c;
+    while (i > 0) {
+	i -= 8;
+	__m256i eq = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lwp+i)),
+					_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rwp+i)));
+	if (_mm256_movemask_epi8(eq) != -1) return vl_cmp_words(i+7, i, lwp, rwp);
+    }
+    return 0;
+}
+static int vl_cmp_sse2(int words, WDataInP lwp, WDataInP rwp) {
+    int i = words & ~3;
+    if (int c = vl_cmp_words(words-1, i, lwp, rwp)) return c;
+    while (i > 0) {
+	i -= 4;
+	__m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lwp+i)),
+				     _mm_loadu_si128(reinterpret_cast<const __m128i*>(rwp+i)));
+	if (_mm_movemask_epi8(eq) != 0xffff) return vl_cmp_words(i+3, i, lwp, rwp);
+    }
+    return 0;
+}
+
+// XOR of all words, for VL_REDXOR_W to reduce to one bit
+static VL_SIMD_TARGET_AVX2 IData vl_redxor_avx2(int words, WDataInP lwp) {
+    __m256i acc = _mm256_setzero_si256();
+    int i = 0;
+    for (; i+8 <= words; i += 8) {
+	acc = _mm256_xor_si256(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lwp+i)));
+    }
+    IData r = vl_fold_xor_avx2(acc);
+    for (; i < words; ++i) r ^= lwp[i];
+    return r;
+}
+static IData vl_redxor_sse2(int words, WDataInP lwp) {
+    __m128i acc = _mm_setzero_si128();
+    int i = 0;
+    for (; i+4 <= words; i += 4) {
+	acc = _mm_xor_si128(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(lwp+i)));
+    }
+    IData r = vl_fold_xor_sse2(acc);
+    for (; i < words; ++i) r ^= lwp[i];
+    return r;
+}
+
+// Population count.  At these widths POPCNT beats a vector nibble
+// lookup, so the AVX2 flavor uses it; SSE2 alone implies no POPCNT.
+static VL_SIMD_TARGET_AVX2 IData vl_countones_avx2(int words, WDataInP lwp) {
+    IData r = 0;
+    int i = 0;
+    for (; i+2 <= words; i += 2) r += __builtin_popcountll(_VL_LIMB_Q(lwp, i/2));
+    if (i < words) r += __builtin_popcount(lwp[i]);
+    return r;
+}
+static IData vl_countones_sse2(int words, WDataInP lwp) {
+    IData r = 0;
+    for (int i=0; i < words; ++i) r += VL_COUNTONES_I(lwp[i]);
+    return r;
+}
+
+struct VlSimdKernels {
+    void (*m_andp)(int, WDataOutP, WDataInP, WDataInP);
+    void (*m_orp)(int, WDataOutP, WDataInP, WDataInP);
+    void (*m_xorp)(int, WDataOutP, WDataInP, WDataInP);
+    IData (*m_changexorp)(int, WDataInP, WDataInP);
+    int (*m_cmpp)(int, WDataInP, WDataInP);
+    IData (*m_redxorp)(int, WDataInP);
+    IData (*m_countonesp)(int, WDataInP);
+};
+
+static VlSimdKernels vlSimdSelect() {
+    __builtin_cpu_init();
+    VlSimdKernels k;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+	k.m_andp = vl_and_avx2; k.m_orp = vl_or_avx2; k.m_xorp = vl_xor_avx2;
+	k.m_changexorp = vl_changexor_avx2; k.m_cmpp = vl_cmp_avx2;
+	k.m_redxorp = vl_redxor_avx2; k.m_countonesp = vl_countones_avx2;
+    } else {
+	k.m_andp = vl_and_sse2; k.m_orp = vl_or_sse2; k.m_xorp = vl_xor_sse2;
+	k.m_changexorp = vl_changexor_sse2; k.m_cmpp = vl_cmp_sse2;
+	k.m_redxorp = vl_redxor_sse2; k.m_countonesp = vl_countones_sse2;
+    }
+    return k;
+}
+static inline const VlSimdKernels& vlSimd() VL_MT_SAFE {
+    // Function static, so selected before first use even from static constructors
+    static const VlSimdKernels s_kernels = vlSimdSelect();
+    return s_kernels;
+}
+
+void _vl_simd_and_w(int words, WDataOutP owp, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
+    vlSimd().m_andp(words, owp, lwp, rwp);
+}
+void _vl_simd_or_w(int words, WDataOutP owp, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
+    vlSimd().m_orp(words, owp, lwp, rwp);
+}
+void _vl_simd_xor_w(int words, WDataOutP owp, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
+    vlSimd().m_xorp(words, owp, lwp, rwp);
+}
+IData _vl_simd_changexor_w(int words, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
+    return vlSimd().m_changexorp(words, lwp, rwp);
+}
+int _vl_simd_cmp_w(int words, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
+    return vlSimd().m_cmpp(words, lwp, rwp);
+}
+IData _vl_simd_redxor_w(int words, WDataInP lwp) VL_MT_SAFE {
+    return vlSimd().m_redxorp(words, lwp);
+}
+IData _vl_simd_countones_w(int words, WDataInP lwp) VL_MT_SAFE {
+    return vlSimd().m_countonesp(words, lwp);
+}
+
+#endif  // VL_SIMD
+
 //===========================================================================
 // Formatting
 
@@ -1063,9 +1560,6 @@ IData VL_FOPEN_S(const char* filenamep, const char* modep) VL_MT_SAFE {
 
 void VL_FCLOSE_I(IData fdi) VL_MT_SAFE {
     // While threadsafe, each thread can only access different file handles
-    FILE* fp = VL_CVT_I_FP(fdi);
-    if (VL_UNLIKELY(!fp)) return;
-    fclose(fp);
     VerilatedImp::fdDelete(fdi);
 }
 
@@ -1145,6 +1639,19 @@ std::string VL_SFORMATF_NX(const char* formatp, ...) VL_MT_SAFE {
 }
 
 void VL_WRITEF(const char* formatp, ...) VL_MT_SAFE {
+#ifdef VL_THREADED
+    if (Verilated::mtaskId()) {
+        // Format straight into this thread's arena, printed at end of eval
+        std::string& arena = VerilatedThreadMsgQueue::arena();
+        size_t begin = arena.size();
+        va_list ap;
+        va_start(ap, formatp);
+        _vl_vsformat(arena, formatp, ap);
+        va_end(ap);
+        VerilatedThreadMsgQueue::postText(begin);
+        return;
+    }
+#endif
     static VL_THREAD_LOCAL std::string output;  // static only for speed
     output = "";
     va_list ap;
@@ -1155,19 +1662,29 @@ void VL_WRITEF(const char* formatp, ...) VL_MT_SAFE {
     VL_PRINTF_MT("%s", output.c_str());
 }
 
+void VerilatedFd::vwritef(const char* formatp, va_list ap) VL_MT_SAFE {
+    VerilatedLockGuard lock(m_mutex);
+    if (VL_UNLIKELY(!m_fp)) return;
+    if (VL_LIKELY(m_buffered)) {
+	_vl_vsformat(m_buf, formatp, ap);
+	if (VL_UNLIKELY(m_buf.size() >= BUFFER_BYTES)) flushBuf();
+    } else {
+	static VL_THREAD_LOCAL std::string output;  // static only for speed
+	output = "";
+	_vl_vsformat(output, formatp, ap);
+	fputs(output.c_str(), m_fp);
+    }
+}
+
 void VL_FWRITEF(IData fpi, const char* formatp, ...) VL_MT_SAFE {
-    // While threadsafe, each thread can only access different file handles
-    static VL_THREAD_LOCAL std::string output;  // static only for speed
-    output = "";
-    FILE* fp = VL_CVT_I_FP(fpi);
-    if (VL_UNLIKELY(!fp)) return;
+    // Descriptor lookup takes no lock, and writes only the descriptor's
+    VerilatedFd* fdp = VerilatedImp::fdToFd(fpi);
+    if (VL_UNLIKELY(!fdp)) return;
 
     va_list ap;
     va_start(ap,formatp);
-    _vl_vsformat(output, formatp, ap);
+    fdp->vwritef(formatp, ap);
     va_end(ap);
-
-    fputs(output.c_str(), fp);
 }
 
 IData VL_FSCANF_IX(IData fpi, const char* formatp, ...) VL_MT_SAFE {
@@ -1612,6 +2129,7 @@ Verilated::ThreadLocal::ThreadLocal()
     t_mtaskId(0),
     t_endOfEvalReqd(0),
 #endif
+    t_contextp(NULL),
     t_dpiScopep(NULL), t_dpiFilename(0), t_dpiLineno(0) {
 }
 Verilated::ThreadLocal::~ThreadLocal() {
@@ -1636,10 +2154,6 @@ void Verilated::calcUnusedSigs(bool flag) VL_MT_SAFE {
     VerilatedLockGuard lock(m_mutex);
     s_s.s_calcUnusedSigs = flag;
 }
-void Verilated::gotFinish(bool flag) VL_MT_SAFE {
-    VerilatedLockGuard lock(m_mutex);
-    s_s.s_gotFinish = flag;
-}
 void Verilated::assertOn(bool flag) VL_MT_SAFE {
     VerilatedLockGuard lock(m_mutex);
     s_s.s_assertOn = flag;
@@ -1677,6 +2191,7 @@ void Verilated::flushCb(VerilatedVoidCb cb) VL_MT_SAFE {
 }
 
 void Verilated::flushCall() VL_MT_SAFE {
+    VerilatedImp::fdFlushAll();
     VerilatedLockGuard lock(m_mutex);
     if (s_flushCb) (*s_flushCb)();
     fflush(stderr);
@@ -1684,19 +2199,22 @@ void Verilated::flushCall() VL_MT_SAFE {
 }
 
 void Verilated::commandArgs(int argc, const char** argv) VL_MT_SAFE {
-    VerilatedLockGuard lock(m_mutex);
-    s_args.argc = argc;
-    s_args.argv = argv;
-    VerilatedImp::commandArgs(argc,argv);
+    {
+	VerilatedLockGuard lock(m_mutex);
+	s_args.argc = argc;
+	s_args.argv = argv;
+    }
+    threadContextp()->commandArgs(argc, argv);
 }
 
 const char* Verilated::commandArgsPlusMatch(const char* prefixp) VL_MT_SAFE {
-    const std::string& match = VerilatedImp::argPlusMatch(prefixp);
-    static VL_THREAD_LOCAL char outstr[VL_VALUE_STRING_MAX_WIDTH];
-    if (match == "") return "";
-    strncpy(outstr, match.c_str(), VL_VALUE_STRING_MAX_WIDTH);
-    outstr[VL_VALUE_STRING_MAX_WIDTH-1] = '\0';
-    return outstr;
+    return threadContextp()->commandArgsPlusMatch(prefixp);
+}
+
+VerilatedContext* Verilated::defaultContextp() VL_MT_SAFE {
+    // Function static, so constructed before any model's use of it
+    static VerilatedContext s_defaultContext;
+    return &s_defaultContext;
 }
 
 void Verilated::overWidthError(const char* signame) VL_MT_SAFE {
@@ -1707,6 +2225,63 @@ void Verilated::overWidthError(const char* signame) VL_MT_SAFE {
     VL_FATAL_MT("unknown",0,"", msg.c_str());
 }
 
+void Verilated::threadPinning(bool flag) VL_MT_SAFE {
+    VerilatedLockGuard lock(m_mutex);
+    s_threadPinning = flag;
+}
+
+bool Verilated::threadPinning() VL_MT_SAFE {
+    VerilatedLockGuard lock(m_mutex);
+    return s_threadPinning;
+}
+
+static const std::vector<int>& vlPinCpus() VL_MT_SAFE {
+    // CPUs in the affinity mask at first use; function static, so read once
+    static std::vector<int> s_cpus;
+    static bool s_read = false;
+    if (!s_read) {
+#if defined(__linux)
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        if (0 == sched_getaffinity(0, sizeof(cpuset), &cpuset)) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &cpuset)) s_cpus.push_back(cpu);
+            }
+        }
+#endif
+        s_read = true;
+    }
+    return s_cpus;
+}
+
+int Verilated::pinCpuBase(int count, bool reserve) VL_MT_SAFE {
+    VerilatedLockGuard lock(m_mutex);
+    const std::vector<int>& cpus = vlPinCpus();
+    // A pool larger than the allowed CPUs would pile workers on one CPU
+    if (!s_threadPinning || count > static_cast<int>(cpus.size())) return -1;
+    int base = s_pinNext;
+    if (reserve) s_pinNext = (s_pinNext + count) % cpus.size();
+    return base;
+}
+
+int Verilated::pinCpu(int base, int index) VL_MT_SAFE {
+    VerilatedLockGuard lock(m_mutex);
+    const std::vector<int>& cpus = vlPinCpus();
+    return cpus[(base + index) % cpus.size()];
+}
+
+void Verilated::pinThread(int cpu) VL_MT_SAFE {
+#if defined(__linux)
+    // Best effort; an unpinned thread is only slower
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu, &cpuset);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+#else
+    if (0 && cpu) {}
+#endif
+}
+
 void Verilated::quiesce() VL_MT_SAFE {
 #ifdef VL_THREADED
     // Wait until all threads under this evaluation are quiet
@@ -1719,7 +2294,7 @@ void Verilated::internalsDump() VL_MT_SAFE {
 }
 
 void Verilated::scopesDump() VL_MT_SAFE {
-    VerilatedImp::scopesDump();
+    threadContextp()->scopesDump();
 }
 
 const VerilatedScope* Verilated::scopeFind(const char* namep) VL_MT_SAFE {
@@ -1749,16 +2324,59 @@ void Verilated::endOfEvalGuts(VerilatedEvalMsgQueue* evalMsgQp) VL_MT_SAFE {
 //===========================================================================
 // VerilatedImp:: Methods
 
+//===========================================================================
+// VerilatedContext:: Methods
+
+VerilatedContext::VerilatedContext()
+    : m_gotFinish(false), m_timeSet(false), m_time(0)
+    , m_impp(new VerilatedContextImp), m_coveragep(NULL), m_vpip(NULL) {
+}
+VerilatedContext::~VerilatedContext() {
+    if (m_coveragep) { delete m_coveragep; m_coveragep = NULL; }
+    if (m_vpip) { delete m_vpip; m_vpip = NULL; }
+    delete m_impp; m_impp = NULL;
+    // Don't leave this thread's Verilated:: statics referring to freed state
+    if (Verilated::threadContextp() == this) Verilated::threadContextp(NULL);
+}
+
+void VerilatedContext::gotFinish(bool flag) VL_MT_SAFE {
+    VerilatedLockGuard lock(m_mutex);
+    m_gotFinish = flag;
+}
+
+void VerilatedContext::commandArgs(int argc, const char** argv) VL_MT_SAFE {
+    VerilatedImp::commandArgs(m_impp, argc, argv);
+}
+void VerilatedContext::commandArgsAdd(int argc, const char** argv) VL_MT_SAFE {
+    VerilatedImp::commandArgsAdd(m_impp, argc, argv);
+}
+
+const char* VerilatedContext::commandArgsPlusMatch(const char* prefixp) VL_MT_SAFE {
+    const std::string& match = VerilatedImp::argPlusMatch(m_impp, prefixp);
+    static VL_THREAD_LOCAL char outstr[VL_VALUE_STRING_MAX_WIDTH];
+    if (match == "") return "";
+    strncpy(outstr, match.c_str(), VL_VALUE_STRING_MAX_WIDTH);
+    outstr[VL_VALUE_STRING_MAX_WIDTH-1] = '\0';
+    return outstr;
+}
+
+void VerilatedContext::scopesDump() const VL_MT_SAFE {
+    VerilatedImp::scopesDump(m_impp);
+}
+
 void VerilatedImp::internalsDump() VL_MT_SAFE {
-    VerilatedLockGuard lock(s_s.m_argMutex);
+    VerilatedContextImp* cimpp = contextImpp();
     VL_PRINTF_MT("internalsDump:\n");
     versionDump();
     VL_PRINTF_MT("  Argv:");
-    for (ArgVec::const_iterator it=s_s.m_argVec.begin(); it!=s_s.m_argVec.end(); ++it) {
-        VL_PRINTF_MT(" %s",it->c_str());
+    {
+	VerilatedLockGuard lock(cimpp->m_argMutex);
+	for (ArgVec::const_iterator it=cimpp->m_argVec.begin(); it!=cimpp->m_argVec.end(); ++it) {
+	    VL_PRINTF_MT(" %s",it->c_str());
+	}
     }
     VL_PRINTF_MT("\n");
-    scopesDump();
+    scopesDump(cimpp);
     exportsDump();
     userDump();
 }
@@ -1767,27 +2385,33 @@ void VerilatedImp::versionDump() VL_MT_SAFE {
                  Verilated::productName(), Verilated::productVersion());
 }
 
-void VerilatedImp::commandArgs(int argc, const char** argv) VL_EXCLUDES(s_s.m_argMutex) {
-    VerilatedLockGuard lock(s_s.m_argMutex);
-    s_s.m_argVec.clear();  // Always clear
-    commandArgsAddGuts(argc, argv);
+void VerilatedImp::commandArgs(VerilatedContextImp* cimpp, int argc, const char** argv)
+    VL_EXCLUDES(cimpp->m_argMutex) {
+    VerilatedLockGuard lock(cimpp->m_argMutex);
+    cimpp->m_argVec.clear();  // Always clear
+    commandArgsAddGuts(cimpp, argc, argv);
 }
-void VerilatedImp::commandArgsAdd(int argc, const char** argv) VL_EXCLUDES(s_s.m_argMutex) {
-    VerilatedLockGuard lock(s_s.m_argMutex);
-    commandArgsAddGuts(argc, argv);
+void VerilatedImp::commandArgsAdd(VerilatedContextImp* cimpp, int argc, const char** argv)
+    VL_EXCLUDES(cimpp->m_argMutex) {
+    VerilatedLockGuard lock(cimpp->m_argMutex);
+    commandArgsAddGuts(cimpp, argc, argv);
 }
-void VerilatedImp::commandArgsAddGuts(int argc, const char** argv) VL_REQUIRES(s_s.m_argMutex) {
-    if (!s_s.m_argVecLoaded) s_s.m_argVec.clear();
+void VerilatedImp::commandArgsAddGuts(VerilatedContextImp* cimpp, int argc, const char** argv)
+    VL_REQUIRES(cimpp->m_argMutex) {
+    if (!cimpp->m_argVecLoaded) cimpp->m_argVec.clear();
     for (int i=0; i<argc; ++i) {
-        s_s.m_argVec.push_back(argv[i]);
+        cimpp->m_argVec.push_back(argv[i]);
     }
-    s_s.m_argVecLoaded = true;  // Can't just test later for empty vector, no arguments is ok
+    cimpp->m_argVecLoaded = true;  // Can't just test later for empty vector, no arguments is ok
 }
 
 //======================================================================
 // VerilatedSyms:: Methods
 
-VerilatedSyms::VerilatedSyms() {
+VerilatedSyms::VerilatedSyms(VerilatedContext* contextp)
+    : __Vm_contextp(contextp ? contextp : Verilated::defaultContextp()) {
+    // Construction is in the model's context, e.g. for coverage inserts
+    Verilated::threadContextp(__Vm_contextp);
 #ifdef VL_THREADED
     __Vm_evalMsgQp = new VerilatedEvalMsgQueue;
 #endif
@@ -1798,6 +2422,272 @@ VerilatedSyms::~VerilatedSyms() {
 #endif
 }
 
+//===========================================================================
+// VerilatedAllocated:: Methods
+
+// Allocated objects are preceded by a header recording how to free them,
+// a cache line long so the object stays aligned
+struct VerilatedAllocHeader {
+    VerilatedAllocator* m_allocatorp;  ///< Allocator, or NULL for operator new
+    size_t m_size;  ///< Size allocated, including the header
+};
+
+VL_THREAD_LOCAL void* VerilatedAllocated::t_placedObjp = NULL;
+VL_THREAD_LOCAL VerilatedAllocator* VerilatedAllocated::t_placedAllocatorp = NULL;
+
+void* VerilatedAllocated::operator new(size_t size, VerilatedAllocator* allocatorp) {
+    size_t allocSize = size + VL_CACHE_LINE_BYTES;
+    void* memp = allocatorp ? allocatorp->allocate(allocSize) : ::operator new(allocSize);
+    VerilatedAllocHeader* headerp = static_cast<VerilatedAllocHeader*>(memp);
+    headerp->m_allocatorp = allocatorp;
+    headerp->m_size = allocSize;
+    t_placedObjp = static_cast<char*>(memp) + VL_CACHE_LINE_BYTES;
+    t_placedAllocatorp = allocatorp;
+    return t_placedObjp;
+}
+VerilatedAllocator* VerilatedAllocated::placedAllocatorp(const void* objp) VL_MT_SAFE {
+    // Objects on the stack or inside others were never placed, so don't match
+    if (objp != t_placedObjp) return NULL;
+    t_placedObjp = NULL;
+    return t_placedAllocatorp;
+}
+void VerilatedAllocated::operator delete(void* objp) {
+    if (!objp) return;
+    if (objp == t_placedObjp) t_placedObjp = NULL;  // Constructor threw, or never asked
+    void* memp = static_cast<char*>(objp) - VL_CACHE_LINE_BYTES;
+    VerilatedAllocHeader* headerp = static_cast<VerilatedAllocHeader*>(memp);
+    if (headerp->m_allocatorp) headerp->m_allocatorp->deallocate(memp, headerp->m_size);
+    else ::operator delete(memp);
+}
+
+//===========================================================================
+// VerilatedHugePageAllocator:: Methods
+
+#ifdef VL_THREADED
+static void vlFirstTouch(char* startp, size_t bytes, int cpu) VL_MT_SAFE {
+    if (cpu >= 0) Verilated::pinThread(cpu);
+    memset(startp, 0, bytes);
+}
+#endif
+
+void* VerilatedHugePageAllocator::allocate(size_t size) {
+    const size_t pageBytes = HUGE_PAGE_BYTES;
+    size_t bytes = (size + pageBytes - 1) / pageBytes * pageBytes;
+    char* memp = NULL;
+#if defined(__linux) && defined(MADV_HUGEPAGE)
+    // Over-allocate to trim to a huge page boundary, as mmap only aligns to small pages
+    void* mapp = mmap(NULL, bytes + pageBytes, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (VL_UNLIKELY(mapp == MAP_FAILED)) {
+        VL_FATAL_MT(__FILE__, __LINE__, "", "Out of memory allocating model in huge pages");
+    }
+    char* mapStartp = static_cast<char*>(mapp);
+    memp = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(mapStartp) + pageBytes - 1)
+                                   / pageBytes * pageBytes);
+    if (memp != mapStartp) munmap(mapStartp, memp - mapStartp);
+    munmap(memp + bytes, mapStartp + pageBytes - memp);
+    // Best effort; without transparent huge pages, the memory is just ordinary
+    madvise(memp, bytes, MADV_HUGEPAGE);
+#else
+    // Over-allocate to align to a cache line, keeping operator new's pointer
+    // just below; operator new aligns at least for a pointer, so it fits
+    char* rawp = static_cast<char*>(::operator new(bytes + VL_CACHE_LINE_BYTES));
+    memp = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(rawp) + VL_CACHE_LINE_BYTES)
+                                   / VL_CACHE_LINE_BYTES * VL_CACHE_LINE_BYTES);
+    reinterpret_cast<char**>(memp)[-1] = rawp;
+    // Zeroed below, by first touch
+#endif
+    // Each thread first writes a contiguous share of whole pages, so its
+    // node backs them.  The caller, which runs the model's eval, writes
+    // the first share and any remainder.  When pinning, the others run
+    // on the CPUs the model's pool will reserve next.
+#ifdef VL_THREADED
+    int threads = m_firstTouchThreads;
+    size_t pages = bytes / pageBytes;
+    if (threads < 1 || static_cast<size_t>(threads) > pages) threads = 1;
+    size_t share = pages / threads * pageBytes;
+    int pinBase = Verilated::pinCpuBase(threads, false);
+    std::vector<std::thread*> touchers;
+    for (int i = 1; i < threads; ++i) {
+        int cpu = pinBase >= 0 ? Verilated::pinCpu(pinBase, i) : -1;
+        touchers.push_back(new std::thread(vlFirstTouch, memp + i * share, share, cpu));
+    }
+    memset(memp, 0, share);
+    memset(memp + threads * share, 0, bytes - threads * share);
+    for (std::vector<std::thread*>::iterator it = touchers.begin(); it != touchers.end(); ++it) {
+        (*it)->join();
+        delete *it;
+    }
+#else
+    memset(memp, 0, bytes);
+#endif
+    return memp;
+}
+
+void VerilatedHugePageAllocator::deallocate(void* memp, size_t size) {
+#if defined(__linux) && defined(MADV_HUGEPAGE)
+    const size_t pageBytes = HUGE_PAGE_BYTES;
+    munmap(memp, (size + pageBytes - 1) / pageBytes * pageBytes);
+#else
+    if (0 && size) {}
+    ::operator delete(reinterpret_cast<char**>(memp)[-1]);
+#endif
+}
+
+//===========================================================================
+// VerilatedSettleProf:: Methods
+
+// Models to report with Verilated::profSettleDump, in construction order
+static VerilatedMutex s_settleProfsMutex;
+static std::vector<VerilatedSettleProf*> s_settleProfs;
+
+VerilatedSettleProf::VerilatedSettleProf(const char* modelNamep, int vars,
+                                         const char* const* varNamesp) VL_MT_SAFE
+    : m_modelNamep(modelNamep), m_vars(vars), m_varNamesp(varNamesp)
+    , m_varChangesp(new vluint64_t[vars]) {
+    clear();
+    VerilatedLockGuard lock(s_settleProfsMutex);
+    s_settleProfs.push_back(this);
+}
+
+VerilatedSettleProf::~VerilatedSettleProf() VL_MT_SAFE {
+    {
+        VerilatedLockGuard lock(s_settleProfsMutex);
+        s_settleProfs.erase(std::find(s_settleProfs.begin(), s_settleProfs.end(), this));
+    }
+    delete[] m_varChangesp; m_varChangesp = NULL;
+}
+
+void VerilatedSettleProf::clear() {
+    for (int var = 0; var < m_vars; ++var) m_varChangesp[var] = 0;
+    for (int i = 0; i < ITERATION_BUCKETS; ++i) m_evalIterations[i] = 0;
+    m_initialIterations = 0;
+    m_initialChanges = 0;
+}
+
+void VerilatedSettleProf::initialDone(int iterations) {
+    // Settling the initial state is a one-off, and would swamp the
+    // per-variable counts of short runs, so it is only reported in total
+    m_initialIterations = iterations;
+    for (int var = 0; var < m_vars; ++var) {
+        m_initialChanges += m_varChangesp[var];
+        m_varChangesp[var] = 0;
+    }
+}
+
+namespace {
+    struct VerilatedSettleProfCmp {
+        const VerilatedSettleProf* m_profp;
+        explicit VerilatedSettleProfCmp(const VerilatedSettleProf* profp) : m_profp(profp) {}
+        bool operator() (int lhs, int rhs) const {
+            if (m_profp->varChanges(lhs) != m_profp->varChanges(rhs)) {
+                return m_profp->varChanges(lhs) > m_profp->varChanges(rhs);
+            }
+            return lhs < rhs;
+        }
+    };
+}
+
+void VerilatedSettleProf::report(FILE* fp) const {
+    vluint64_t evals = 0;
+    for (int i = 0; i < ITERATION_BUCKETS; ++i) evals += m_evalIterations[i];
+    fprintf(fp, "Settle profile of model %s\n", m_modelNamep);
+    fprintf(fp, "  Initial settle: %d iterations, %" VL_PRI64 "u changes (not counted below)\n",
+            m_initialIterations, m_initialChanges);
+    fprintf(fp, "  Evals: %" VL_PRI64 "u\n", evals);
+    fprintf(fp, "  Iterations per eval:\n");
+    for (int i = 0; i < ITERATION_BUCKETS; ++i) {
+        if (!m_evalIterations[i]) continue;
+        fprintf(fp, "    %3d%s %12" VL_PRI64 "u  %6.2f%%\n", i,
+                (i == ITERATION_BUCKETS-1) ? "+" : " ", m_evalIterations[i],
+                100.0 * m_evalIterations[i] / evals);
+    }
+    std::vector<int> vars;
+    for (int var = 0; var < m_vars; ++var) {
+        if (m_varChangesp[var]) vars.push_back(var);
+    }
+    std::sort(vars.begin(), vars.end(), VerilatedSettleProfCmp(this));
+    fprintf(fp, "  Changes forcing another iteration:\n");
+    for (std::vector<int>::const_iterator it = vars.begin(); it != vars.end(); ++it) {
+        fprintf(fp, "    %12" VL_PRI64 "u  %s\n", m_varChangesp[*it], m_varNamesp[*it]);
+    }
+}
+
+void Verilated::profSettleDump(const char* filenamep) VL_MT_SAFE {
+    FILE* fp = filenamep ? fopen(filenamep, "w") : stdout;
+    if (VL_UNLIKELY(!fp)) {
+        VL_PRINTF_MT("%%Warning: Can't write %s\n", filenamep);
+        return;
+    }
+    {
+        VerilatedLockGuard lock(s_settleProfsMutex);
+        for (std::vector<VerilatedSettleProf*>::const_iterator it = s_settleProfs.begin();
+             it != s_settleProfs.end(); ++it) {
+            (*it)->report(fp);
+        }
+    }
+    if (fp != stdout) fclose(fp);
+    else fflush(stdout);
+}
+
+//===========================================================================
+// VerilatedBranchProf:: Methods
+
+// Models to report with Verilated::profBranchesDump, in construction order
+static VerilatedMutex s_branchProfsMutex;
+static std::vector<VerilatedBranchProf*> s_branchProfs;
+
+VerilatedBranchProf::VerilatedBranchProf(const char* modelNamep, int points,
+                                         const char* const* keysp, const int* armsp) VL_MT_SAFE
+    : m_modelNamep(modelNamep), m_points(points), m_keysp(keysp), m_armsp(armsp)
+    , m_counters(0), m_countsp(NULL) {
+    for (int point = 0; point < m_points; ++point) m_counters += m_armsp[point];
+    m_countsp = new Count[m_counters];
+    clear();
+    VerilatedLockGuard lock(s_branchProfsMutex);
+    s_branchProfs.push_back(this);
+}
+
+VerilatedBranchProf::~VerilatedBranchProf() VL_MT_SAFE {
+    {
+        VerilatedLockGuard lock(s_branchProfsMutex);
+        s_branchProfs.erase(std::find(s_branchProfs.begin(), s_branchProfs.end(), this));
+    }
+    delete[] m_countsp; m_countsp = NULL;
+}
+
+void VerilatedBranchProf::clear() {
+    for (int counter = 0; counter < m_counters; ++counter) m_countsp[counter] = 0;
+}
+
+void VerilatedBranchProf::dumpData(FILE* fp) const {
+    // VLPROF branch <key> <count of arm 0> <count of arm 1> ...
+    int counter = 0;
+    for (int point = 0; point < m_points; ++point) {
+        fprintf(fp, "VLPROF branch %s", m_keysp[point]);
+        for (int arm = 0; arm < m_armsp[point]; ++arm) {
+            fprintf(fp, " %" VL_PRI64 "u", count(counter++));
+        }
+        fprintf(fp, "\n");
+    }
+}
+
+void Verilated::profBranchesDump(const char* filenamep) VL_MT_SAFE {
+    FILE* fp = fopen(filenamep, "w");
+    if (VL_UNLIKELY(!fp)) {
+        VL_PRINTF_MT("%%Warning: Can't write %s\n", filenamep);
+        return;
+    }
+    {
+        VerilatedLockGuard lock(s_branchProfsMutex);
+        for (std::vector<VerilatedBranchProf*>::const_iterator it = s_branchProfs.begin();
+             it != s_branchProfs.end(); ++it) {
+            (*it)->dumpData(fp);
+        }
+    }
+    fclose(fp);
+}
+
 //===========================================================================
 // VerilatedModule:: Methods
 
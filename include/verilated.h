@@ -70,9 +70,14 @@ typedef const WData* WDataInP;	///< Array input to a function
 typedef       WData* WDataOutP;	///< Array output from a function
 
 typedef void (*VerilatedVoidCb)(void);
+/// Predicate ending a model's eval_cycles() early when true, see --eval-cycles
+typedef bool (*VerilatedEvalPredicate)(void* userp);
 
 class SpTraceVcd;
 class SpTraceVcdCFile;
+class VerilatedAllocator;
+class VerilatedContext;
+class VerilatedContextImp;
 class VerilatedEvalMsgQueue;
 class VerilatedScopeNameMap;
 class VerilatedVar;
@@ -254,6 +259,11 @@ public:
 /// Constructor declaration for C++, ala SP_CTOR_IMPL
 # define VL_CTOR_IMP(modname)		modname::modname(const char* __VCname) : VerilatedModule(__VCname)
 
+/// Constructor declaration for a C++ top module, which may be given a context and allocator
+# define VL_CTOR_CONTEXT_IMP(modname)	modname::modname(const char* __VCname, VerilatedContext* __VCcontextp, \
+							 VerilatedAllocator* __VCallocatorp) \
+	: VerilatedModule(__VCname)
+
 /// Constructor declaration for SystemC, ala SP_CTOR_IMPL
 # define VL_SC_CTOR_IMP(modname)	modname::modname(sc_module_name)
 
@@ -270,18 +280,156 @@ public:
 # define VL_VPRINTF vprintf  ///< Print ala vprintf, called from main thread; may redefine if desired
 #endif
 
+//===========================================================================
+/// Base for objects placed with the VerilatedAllocator given to a model:
+/// the symbol table, and through forwarding operators the top module
+
+class VerilatedAllocated {
+    static VL_THREAD_LOCAL void* t_placedObjp;  ///< Object this thread last placed
+    static VL_THREAD_LOCAL VerilatedAllocator* t_placedAllocatorp;  ///< Its allocator
+public:
+    static void* operator new(size_t size) { return operator new(size, NULL); }
+    static void* operator new(size_t size, VerilatedAllocator* allocatorp);
+    static void operator delete(void* objp);
+    static void operator delete(void* objp, VerilatedAllocator*) { operator delete(objp); }
+    /// Allocator of the object this thread just placed with operator new,
+    /// if that was objp, else NULL; for a constructor to find its allocator.
+    /// Each placement is only returned once.
+    static VerilatedAllocator* placedAllocatorp(const void* objp) VL_MT_SAFE;
+};
+
 //===========================================================================
 /// Verilator symbol table base class
+///
+/// The symbol table holds the state of all but the top module, so is
+/// allocated with the allocator given to the model's constructor, if any.
 
-class VerilatedSyms {
+class VerilatedSyms : public VerilatedAllocated {
 public:  // But for internal use only
+    VerilatedContext* __Vm_contextp;  ///< Context the model runs in
 #ifdef VL_THREADED
     VerilatedEvalMsgQueue* __Vm_evalMsgQp;
 #endif
-    VerilatedSyms();
+    explicit VerilatedSyms(VerilatedContext* contextp);
     ~VerilatedSyms();
 };
 
+//===========================================================================
+/// Allocator for the state of a model, given to its constructor
+
+class VerilatedAllocator {
+public:
+    VerilatedAllocator() {}
+    virtual ~VerilatedAllocator() {}
+    /// Return zeroed memory of at least the given size, aligned to a cache line
+    virtual void* allocate(size_t size) = 0;
+    /// Release memory from allocate(), with the size it was given
+    virtual void deallocate(void* memp, size_t size) = 0;
+};
+
+/// Allocator placing model state in 2MB transparent huge pages, to reduce
+/// TLB misses on models with large state.  With firstTouchThreads of N,
+/// N threads each first write a share of the pages, so NUMA systems spread
+/// the pages across the nodes of the threads.  With Verilated::threadPinning,
+/// they are pinned to the CPUs the model's --threads N pool will get.  On
+/// systems without huge pages, this allocates ordinary memory.
+
+class VerilatedHugePageAllocator : public VerilatedAllocator {
+    int m_firstTouchThreads;  ///< Threads to first write pages, 0 for the caller only
+public:
+    enum { HUGE_PAGE_BYTES = 2*1024*1024 };
+    explicit VerilatedHugePageAllocator(int firstTouchThreads = 0)
+        : m_firstTouchThreads(firstTouchThreads) {}
+    virtual ~VerilatedHugePageAllocator() {}
+    virtual void* allocate(size_t size);
+    virtual void deallocate(void* memp, size_t size);
+};
+
+//===========================================================================
+/// Settle loop statistics of a model built with --prof-settle: for each
+/// change-detected variable, how often its change forced another settle
+/// iteration, and a histogram of the iterations each eval() took.  The
+/// first eval()'s settle of the initial state is kept apart from these.
+/// Updated only by the thread calling eval().
+
+class VerilatedSettleProf {
+public:
+    enum { ITERATION_BUCKETS = 32 };  ///< Last bucket also counts evals with more iterations
+private:
+    const char* m_modelNamep;  ///< Name of the model
+    int m_vars;  ///< Number of change-detected variables
+    const char* const* m_varNamesp;  ///< Name of each variable
+    vluint64_t* m_varChangesp;  ///< Changes found of each variable
+    vluint64_t m_evalIterations[ITERATION_BUCKETS];  ///< Evals by iterations taken
+    int m_initialIterations;  ///< Iterations of the initial settle
+    vluint64_t m_initialChanges;  ///< Changes found of all variables in the initial settle
+    VL_UNCOPYABLE(VerilatedSettleProf);
+public:
+    // CONSTRUCTORS
+    VerilatedSettleProf(const char* modelNamep, int vars, const char* const* varNamesp) VL_MT_SAFE;
+    ~VerilatedSettleProf() VL_MT_SAFE;
+    // METHODS - called by the model
+    inline void changed(int var) { ++m_varChangesp[var]; }
+    inline void evalDone(int iterations) {
+        ++m_evalIterations[(iterations < ITERATION_BUCKETS) ? iterations : (ITERATION_BUCKETS-1)];
+    }
+    /// Move the changes counted so far to the initial settle's totals
+    void initialDone(int iterations);
+    // METHODS - for reporting
+    const char* modelName() const { return m_modelNamep; }
+    int vars() const { return m_vars; }
+    const char* varName(int var) const { return m_varNamesp[var]; }
+    vluint64_t varChanges(int var) const { return m_varChangesp[var]; }
+    vluint64_t evalIterations(int iterations) const { return m_evalIterations[iterations]; }
+    int initialIterations() const { return m_initialIterations; }
+    vluint64_t initialChanges() const { return m_initialChanges; }
+    /// Zero the statistics
+    void clear();
+    /// Print the histogram and the variables by changes, most first
+    void report(FILE* fp) const;
+};
+
+//===========================================================================
+/// Branch counts of a model built with --prof-branches: for each if and
+/// case statement, how often each of its arms was taken.  Counters of all
+/// branch points are in one array, in order of the points.
+/// Updated without locking by the threads evaluating the model; with
+/// VL_THREADED the counters are relaxed atomics, so counts are not lost.
+
+class VerilatedBranchProf {
+#ifdef VL_THREADED
+    typedef std::atomic<vluint64_t> Count;
+#else
+    typedef vluint64_t Count;
+#endif
+    const char* m_modelNamep;  ///< Name of the model
+    int m_points;  ///< Number of branch points
+    const char* const* m_keysp;  ///< Profile key of each point
+    const int* m_armsp;  ///< Number of arms of each point
+    int m_counters;  ///< Number of arms of all points
+    Count* m_countsp;  ///< Times each arm was taken
+    VL_UNCOPYABLE(VerilatedBranchProf);
+public:
+    // CONSTRUCTORS
+    VerilatedBranchProf(const char* modelNamep, int points, const char* const* keysp,
+                        const int* armsp) VL_MT_SAFE;
+    ~VerilatedBranchProf() VL_MT_SAFE;
+    // METHODS - called by the model
+#ifdef VL_THREADED
+    inline void taken(int counter) { m_countsp[counter].fetch_add(1, std::memory_order_relaxed); }
+#else
+    inline void taken(int counter) { ++m_countsp[counter]; }
+#endif
+    // METHODS - for reporting
+    const char* modelName() const { return m_modelNamep; }
+    int counters() const { return m_counters; }
+    vluint64_t count(int counter) const { return m_countsp[counter]; }
+    /// Zero the counts
+    void clear();
+    /// Write the counts of each point, for Verilator's --prof-branches-data
+    void dumpData(FILE* fp) const;
+};
+
 //===========================================================================
 /// Verilator global class information class
 /// This class is initialized by main thread only. Reading post-init is thread safe.
@@ -321,6 +469,67 @@ public:  // But internals only - called from VerilatedModule's
     }
 };
 
+//===========================================================================
+/// Base class for objects deleted through a base pointer
+
+class VerilatedVirtualBase {
+public:
+    VerilatedVirtualBase() {}
+    virtual ~VerilatedVirtualBase() {}
+};
+
+//===========================================================================
+/// Simulation context shared by one or more models
+///
+/// A context holds the state of one simulation: its time, command
+/// arguments, $finish status, open files, scope names, coverage, and VPI
+/// callbacks and errors.  Each model is constructed into a context, by
+/// default Verilated::defaultContextp(), so independent simulations may
+/// run in one process, each on its own thread with its own context.  The Verilated:: methods for this state
+/// refer to the current thread's context; see Verilated::threadContextp().
+
+class VerilatedContext {
+    // MEMBERS
+    VerilatedMutex	m_mutex;	///< Protects m_gotFinish writes
+    bool		m_gotFinish;	///< A $finish statement executed
+    bool		m_timeSet;	///< time() was ever set, else use sc_time_stamp()
+    vluint64_t		m_time;		///< Simulation time, if m_timeSet
+    VerilatedContextImp* m_impp;	///< Slow path state (verilated_imp.h)
+    VerilatedVirtualBase* m_coveragep;	///< Coverage database (verilated_cov.cpp), or NULL
+    VerilatedVirtualBase* m_vpip;	///< VPI callbacks and errors (verilated_vpi.cpp), or NULL
+    VL_UNCOPYABLE(VerilatedContext);
+public:
+    // CONSTRUCTORS
+    VerilatedContext();
+    ~VerilatedContext();
+    // METHODS - User called
+    /// Set the simulation time returned by $time.  Until first set, $time
+    /// calls the application's sc_time_stamp() as with earlier versions.
+    void time(vluint64_t value) VL_MT_SAFE { m_time = value; m_timeSet = true; }
+    vluint64_t time() const VL_MT_SAFE { return m_time; }  ///< Return time set
+    void timeInc(vluint64_t add) VL_MT_SAFE { time(m_time + add); }  ///< Advance time
+    /// Did the simulation $finish?
+    void gotFinish(bool flag) VL_MT_SAFE;
+    bool gotFinish() const VL_MT_SAFE { return m_gotFinish; }  ///< Return if got a $finish
+    /// Record command line arguments, for retrieval by $test$plusargs/$value$plusargs
+    void commandArgs(int argc, const char** argv) VL_MT_SAFE;
+    void commandArgs(int argc, char** argv) VL_MT_SAFE {
+        commandArgs(argc, const_cast<const char**>(argv)); }
+    void commandArgsAdd(int argc, const char** argv) VL_MT_SAFE;
+    /// Match plusargs with a given prefix. Returns static char* valid only for a single call
+    const char* commandArgsPlusMatch(const char* prefixp) VL_MT_SAFE;
+    /// For debugging, print text list of all scope names in the context
+    void scopesDump() const VL_MT_SAFE;
+public:
+    // METHODS - INTERNAL USE ONLY (but public due to what uses it)
+    double timeStamp() const VL_MT_SAFE;  ///< Time for VL_TIME_Q, defined after the macros
+    VerilatedContextImp* impp() const VL_MT_SAFE { return m_impp; }
+    VerilatedVirtualBase* coveragep() const VL_MT_SAFE { return m_coveragep; }
+    void coveragep(VerilatedVirtualBase* covp) VL_MT_UNSAFE { m_coveragep = covp; }
+    VerilatedVirtualBase* vpip() const VL_MT_SAFE { return m_vpip; }
+    void vpip(VerilatedVirtualBase* vpip) VL_MT_UNSAFE { m_vpip = vpip; }
+};
+
 //===========================================================================
 /// Verilator global static information class
 
@@ -330,12 +539,13 @@ class Verilated {
     static VerilatedMutex m_mutex;  ///< Mutex for s_s/s_ns members, when VL_THREADED
 
     static VerilatedVoidCb  s_flushCb;		///< Flush callback function
+    static bool s_threadPinning;	///< Pin thread pool workers to CPUs
+    static int s_pinNext;		///< Next CPU of the affinity set to hand a pool
 
     static struct Serialized {   // All these members serialized/deserialized
 	// Fast path
 	int		s_debug;		///< See accessors... only when VL_DEBUG set
 	bool		s_calcUnusedSigs;	///< Waves file on, need all signals calculated
-	bool		s_gotFinish;		///< A $finish statement executed
 	bool		s_assertOn;		///< Assertions are enabled
         bool		s_fatalOnVpiError;	///< Stop on vpi error/unsupported
         // Slow path
@@ -359,6 +569,7 @@ class Verilated {
         vluint32_t t_mtaskId;  ///< Current mtask# executing on this thread
 	vluint32_t t_endOfEvalReqd;  ///< Messages may be pending, thread needs endOf-eval calls
 #endif
+	VerilatedContext* t_contextp;  ///< Context of the model last evaluated
 	const VerilatedScope* t_dpiScopep;  ///< DPI context scope
 	const char* t_dpiFilename;  ///< DPI context filename
 	int t_dpiLineno;  ///< DPI context line number
@@ -374,6 +585,15 @@ private:
 public:
     // METHODS - User called
 
+    /// Context used by models constructed without one
+    static VerilatedContext* defaultContextp() VL_MT_SAFE;
+    /// Context of the current thread: the context of the model this thread
+    /// last constructed or evaluated, else defaultContextp().  The methods
+    /// below for time, arguments, $finish, and scopes refer to it.
+    static VerilatedContext* threadContextp() VL_MT_SAFE {
+        return VL_LIKELY(t_s.t_contextp) ? t_s.t_contextp : defaultContextp(); }
+    static void threadContextp(VerilatedContext* contextp) VL_MT_SAFE { t_s.t_contextp = contextp; }
+
     /// Select initial value of otherwise uninitialized signals.
     ////
     /// 0 = Set to zeros
@@ -395,9 +615,9 @@ public:
     static void calcUnusedSigs(bool flag) VL_MT_SAFE;
     static bool calcUnusedSigs() VL_MT_SAFE {  ///< Return calcUnusedSigs value
         return s_s.s_calcUnusedSigs; }
-    /// Did the simulation $finish?
-    static void gotFinish(bool flag) VL_MT_SAFE;
-    static bool gotFinish() VL_MT_SAFE { return s_s.s_gotFinish; }  ///< Return if got a $finish
+    /// Did the simulation $finish?  (In the thread's context)
+    static void gotFinish(bool flag) VL_MT_SAFE { threadContextp()->gotFinish(flag); }
+    static bool gotFinish() VL_MT_SAFE { return threadContextp()->gotFinish(); }  ///< Return if got a $finish
     /// Allow traces to at some point be enabled (disables some optimizations)
     static void traceEverOn(bool flag) VL_MT_SAFE {
 	if (flag) { calcUnusedSigs(flag); }
@@ -408,6 +628,11 @@ public:
     /// Enable/disable vpi fatal
     static void fatalOnVpiError(bool flag) VL_MT_SAFE;
     static bool fatalOnVpiError() VL_MT_SAFE { return s_s.s_fatalOnVpiError; }
+    /// Pin the threads of models constructed afterwards to CPUs (default off).
+    /// Each model's thread pool takes the next CPUs in turn from those the
+    /// process may run on (e.g. with taskset), so models share them out.
+    static void threadPinning(bool flag) VL_MT_SAFE;
+    static bool threadPinning() VL_MT_SAFE;
     /// Flush callback for VCD waves
     static void flushCb(VerilatedVoidCb cb) VL_MT_SAFE;
     static void flushCall() VL_MT_SAFE;
@@ -416,7 +641,8 @@ public:
     static void commandArgs(int argc, const char** argv) VL_MT_SAFE;
     static void commandArgs(int argc, char** argv) VL_MT_SAFE {
         commandArgs(argc, const_cast<const char**>(argv)); }
-    static void commandArgsAdd(int argc, const char** argv);
+    static void commandArgsAdd(int argc, const char** argv) VL_MT_SAFE {
+        threadContextp()->commandArgsAdd(argc, argv); }
     static CommandArgValues* getCommandArgs() VL_MT_SAFE { return &s_args; }
     /// Match plusargs with a given prefix. Returns static char* valid only for a single call
     static const char* commandArgsPlusMatch(const char* prefixp) VL_MT_SAFE;
@@ -439,6 +665,14 @@ public:
     /// releases - contact the authors before production use.
     static void scopesDump() VL_MT_SAFE;
 
+    /// Write the settle loop statistics of all models built with
+    /// --prof-settle to filenamep, or stdout if NULL.
+    static void profSettleDump(const char* filenamep = NULL) VL_MT_SAFE;
+
+    /// Write the branch counts of all models built with --prof-branches
+    /// to filenamep, for a later Verilator run with --prof-branches-data.
+    static void profBranchesDump(const char* filenamep) VL_MT_SAFE;
+
 public:
     // METHODS - INTERNAL USE ONLY (but public due to what uses it)
     // Internal: Create a new module name by concatenating two strings
@@ -447,6 +681,14 @@ public:
     // Internal: Throw signal assertion
     static void overWidthError(const char* signame) VL_MT_SAFE;
 
+    // Internal: Index of the first of count CPUs for the next thread pool,
+    // reserving them if reserve, else -1 when not pinning or too few CPUs
+    static int pinCpuBase(int count, bool reserve) VL_MT_SAFE;
+    // Internal: CPU for a pool's thread index, given its pinCpuBase
+    static int pinCpu(int base, int index) VL_MT_SAFE;
+    // Internal: Pin the calling thread to a CPU, where supported
+    static void pinThread(int cpu) VL_MT_SAFE;
+
     // Internal: Find scope
     static const VerilatedScope* scopeFind(const char* namep) VL_MT_SAFE;
     static const VerilatedScopeNameMap* scopeNameMap() VL_MT_SAFE;
@@ -483,6 +725,15 @@ public:
         // if there are no transactions.
         endOfEvalGuts(evalMsgQp);
     }
+    /// Write the timing recorded by models built with --prof-threads, as a
+    /// Chrome trace (chrome://tracing) JSON file, and a summary of each
+    /// model's schedule to summaryfilenamep, or stdout if NULL.  If
+    /// datafilenamep is given, also write the measured mtask costs there,
+    /// for a later Verilator run with --prof-threads-data.
+    /// Only available with multithreaded models (verilated_threads.cpp).
+    static void profThreadsDump(const char* tracefilenamep,
+                                const char* summaryfilenamep = NULL,
+                                const char* datafilenamep = NULL) VL_MT_SAFE;
 #endif
 
 private:
@@ -551,6 +802,19 @@ inline QData VL_RDTSC_Q() { vluint64_t val; VL_RDTSC(val); return val; }
 
 /// Math
 extern WDataOutP _vl_moddiv_w(int lbits, WDataOutP owp, WDataInP lwp, WDataInP rwp, bool is_modulus);
+#if VL_MUL_INT128
+extern WDataOutP _vl_mul_w(int words, WDataOutP owp, WDataInP lwp, WDataInP rwp) VL_MT_SAFE;
+#endif
+#if VL_SIMD
+/// SIMD kernels, for VL_SIMD_MIN_WORDS or more words
+extern void _vl_simd_and_w(int words, WDataOutP owp, WDataInP lwp, WDataInP rwp) VL_MT_SAFE;
+extern void _vl_simd_or_w(int words, WDataOutP owp, WDataInP lwp, WDataInP rwp) VL_MT_SAFE;
+extern void _vl_simd_xor_w(int words, WDataOutP owp, WDataInP lwp, WDataInP rwp) VL_MT_SAFE;
+extern IData _vl_simd_changexor_w(int words, WDataInP lwp, WDataInP rwp) VL_MT_SAFE;
+extern int _vl_simd_cmp_w(int words, WDataInP lwp, WDataInP rwp) VL_MT_SAFE;
+extern IData _vl_simd_redxor_w(int words, WDataInP lwp) VL_MT_SAFE;
+extern IData _vl_simd_countones_w(int words, WDataInP lwp) VL_MT_SAFE;
+#endif
 
 /// File I/O
 extern IData VL_FGETS_IXI(int obits, void* destp, IData fpi);
@@ -682,10 +946,13 @@ extern void _VL_DEBUG_PRINT_W(int lbits, WDataInP iwp);
 # define VL_TIME_Q() (static_cast<QData>(sc_time_stamp().to_default_time_units()*VL_TIME_MULTIPLIER))
 # define VL_TIME_D() (static_cast<double>(sc_time_stamp().to_default_time_units()*VL_TIME_MULTIPLIER))
 #else
-# define VL_TIME_I() (static_cast<IData>(sc_time_stamp()*VL_TIME_MULTIPLIER))
-# define VL_TIME_Q() (static_cast<QData>(sc_time_stamp()*VL_TIME_MULTIPLIER))
-# define VL_TIME_D() (static_cast<double>(sc_time_stamp()*VL_TIME_MULTIPLIER))
+# define VL_TIME_I() (static_cast<IData>(Verilated::threadContextp()->timeStamp()*VL_TIME_MULTIPLIER))
+# define VL_TIME_Q() (static_cast<QData>(Verilated::threadContextp()->timeStamp()*VL_TIME_MULTIPLIER))
+# define VL_TIME_D() (static_cast<double>(Verilated::threadContextp()->timeStamp()*VL_TIME_MULTIPLIER))
 extern double sc_time_stamp();
+inline double VerilatedContext::timeStamp() const VL_MT_SAFE {
+    return VL_LIKELY(m_timeSet) ? static_cast<double>(m_time) : sc_time_stamp();
+}
 #endif
 
 /// Evaluate expression if debug enabled
@@ -995,6 +1262,9 @@ static inline IData VL_REDXOR_64(QData r) VL_PURE {
 #endif
 }
 static inline IData VL_REDXOR_W(int words, WDataInP lwp) VL_MT_SAFE {
+#if VL_SIMD
+    if (words >= VL_SIMD_MIN_WORDS) return VL_REDXOR_32(_vl_simd_redxor_w(words, lwp));
+#endif
     IData r = lwp[0];
     for (int i=1; i < words; ++i) r ^= lwp[i];
     return VL_REDXOR_32(r);
@@ -1013,6 +1283,9 @@ static inline IData VL_COUNTONES_Q(QData lhs) VL_PURE {
     return VL_COUNTONES_I(static_cast<IData>(lhs)) + VL_COUNTONES_I(static_cast<IData>(lhs>>32));
 }
 static inline IData VL_COUNTONES_W(int words, WDataInP lwp) VL_MT_SAFE {
+#if VL_SIMD
+    if (words >= VL_SIMD_MIN_WORDS) return _vl_simd_countones_w(words, lwp);
+#endif
     IData r = 0;
     for (int i=0; (i < words); ++i) r+=VL_COUNTONES_I(lwp[i]);
     return r;
@@ -1104,22 +1377,34 @@ static inline IData VL_MOSTSETBITP1_W(int words, WDataInP lwp) VL_MT_SAFE {
 
 // EMIT_RULE: VL_AND:  oclean=lclean||rclean; obits=lbits; lbits==rbits;
 static inline WDataOutP VL_AND_W(int words, WDataOutP owp,WDataInP lwp,WDataInP rwp) VL_MT_SAFE {
+#if VL_SIMD
+    if (words >= VL_SIMD_MIN_WORDS) { _vl_simd_and_w(words, owp, lwp, rwp); return(owp); }
+#endif
     for (int i=0; (i < words); ++i) owp[i] = (lwp[i] & rwp[i]);
     return(owp);
 }
 // EMIT_RULE: VL_OR:   oclean=lclean&&rclean; obits=lbits; lbits==rbits;
 static inline WDataOutP VL_OR_W(int words, WDataOutP owp,WDataInP lwp,WDataInP rwp) VL_MT_SAFE {
+#if VL_SIMD
+    if (words >= VL_SIMD_MIN_WORDS) { _vl_simd_or_w(words, owp, lwp, rwp); return(owp); }
+#endif
     for (int i=0; (i < words); ++i) owp[i] = (lwp[i] | rwp[i]);
     return(owp);
 }
 // EMIT_RULE: VL_CHANGEXOR:  oclean=1; obits=32; lbits==rbits;
 static inline IData VL_CHANGEXOR_W(int words, WDataInP lwp,WDataInP rwp) VL_MT_SAFE {
+#if VL_SIMD
+    if (words >= VL_SIMD_MIN_WORDS) return _vl_simd_changexor_w(words, lwp, rwp);
+#endif
     IData od = 0;
     for (int i=0; (i < words); ++i) od |= (lwp[i] ^ rwp[i]);
     return(od);
 }
 // EMIT_RULE: VL_XOR:  oclean=lclean&&rclean; obits=lbits; lbits==rbits;
 static inline WDataOutP VL_XOR_W(int words, WDataOutP owp,WDataInP lwp,WDataInP rwp) VL_MT_SAFE {
+#if VL_SIMD
+    if (words >= VL_SIMD_MIN_WORDS) { _vl_simd_xor_w(words, owp, lwp, rwp); return(owp); }
+#endif
     for (int i=0; (i < words); ++i) owp[i] = (lwp[i] ^ rwp[i]);
     return(owp);
 }
@@ -1143,28 +1428,70 @@ static inline WDataOutP VL_NOT_W(int words, WDataOutP owp,WDataInP lwp) VL_MT_SA
 // EMIT_RULE: VL_GT:  oclean=clean; lclean==clean; rclean==clean; obits=1; lbits==rbits;
 // EMIT_RULE: VL_GTE: oclean=clean; lclean==clean; rclean==clean; obits=1; lbits==rbits;
 // EMIT_RULE: VL_LTE: oclean=clean; lclean==clean; rclean==clean; obits=1; lbits==rbits;
-#define VL_NEQ_W(words,lwp,rwp)		(!VL_EQ_W(words,lwp,rwp))
-#define VL_LT_W(words,lwp,rwp)		(_VL_CMP_W(words,lwp,rwp)<0)
-#define VL_LTE_W(words,lwp,rwp)		(_VL_CMP_W(words,lwp,rwp)<=0)
-#define VL_GT_W(words,lwp,rwp)		(_VL_CMP_W(words,lwp,rwp)>0)
-#define VL_GTE_W(words,lwp,rwp)		(_VL_CMP_W(words,lwp,rwp)>=0)
+
+// Internal usage, for VL_WIDE_LIMB64: words 2*limb and 2*limb+1 as one quad.
+// Compilers merge the word accesses into single 64-bit loads and stores.
+static inline QData _VL_LIMB_Q(WDataInP wp, int limb) VL_PURE {
+    return (static_cast<QData>(wp[2*limb])
+	    | (static_cast<QData>(wp[2*limb+1]) << VL_ULL(32)));
+}
+static inline void _VL_SET_LIMB_Q(WDataOutP wp, int limb, QData data) VL_MT_SAFE {
+    wp[2*limb] = static_cast<IData>(data);
+    wp[2*limb+1] = static_cast<IData>(data >> VL_ULL(32));
+}
 
 // Output clean, <lhs> AND <rhs> MUST BE CLEAN
 static inline IData VL_EQ_W(int words, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
+#if VL_SIMD
+    if (words >= VL_SIMD_MIN_WORDS) return(_vl_simd_changexor_w(words, lwp, rwp)==0);
+#endif
+#if VL_WIDE_LIMB64
+    QData nequal = (words & 1) ? (lwp[words-1] ^ rwp[words-1]) : 0;
+    for (int i=0; i < words/2; ++i) nequal |= (_VL_LIMB_Q(lwp,i) ^ _VL_LIMB_Q(rwp,i));
+#else
     int nequal=0;
     for (int i=0; (i < words); ++i) nequal |= (lwp[i] ^ rwp[i]);
+#endif
     return(nequal==0);
 }
 
 // Internal usage
 static inline int _VL_CMP_W(int words, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
+#if VL_SIMD
+    if (words >= VL_SIMD_MIN_WORDS) return _vl_simd_cmp_w(words, lwp, rwp);
+#endif
+#if VL_WIDE_LIMB64
+    if (words & 1) {
+	if (lwp[words-1] > rwp[words-1]) return 1;
+	if (lwp[words-1] < rwp[words-1]) return -1;
+    }
+    for (int i=words/2-1; i>=0; --i) {
+	QData l = _VL_LIMB_Q(lwp,i);
+	QData r = _VL_LIMB_Q(rwp,i);
+	if (l > r) return 1;
+	if (l < r) return -1;
+    }
+#else
     for (int i=words-1; i>=0; --i) {
 	if (lwp[i] > rwp[i]) return 1;
 	if (lwp[i] < rwp[i]) return -1;
     }
+#endif
     return(0); // ==
 }
 
+// Functions rather than macros, so they also have width templates below
+static inline IData VL_NEQ_W(int words, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
+    return !VL_EQ_W(words,lwp,rwp); }
+static inline IData VL_LT_W(int words, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
+    return _VL_CMP_W(words,lwp,rwp)<0; }
+static inline IData VL_LTE_W(int words, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
+    return _VL_CMP_W(words,lwp,rwp)<=0; }
+static inline IData VL_GT_W(int words, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
+    return _VL_CMP_W(words,lwp,rwp)>0; }
+static inline IData VL_GTE_W(int words, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
+    return _VL_CMP_W(words,lwp,rwp)>=0; }
+
 #define VL_LTS_IWW(obits,lbits,rbbits,lwp,rwp)		(_VL_CMPS_W(lbits,lwp,rwp)<0)
 #define VL_LTES_IWW(obits,lbits,rbits,lwp,rwp)		(_VL_CMPS_W(lbits,lwp,rwp)<=0)
 #define VL_GTS_IWW(obits,lbits,rbits,lwp,rwp)		(_VL_CMPS_W(lbits,lwp,rwp)>0)
@@ -1224,11 +1551,8 @@ static inline int _VL_CMPS_W(int lbits, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
     IData rsign = VL_SIGN_I(lbits,rwp[i]);
     if (!lsign && rsign) return  1; // + > -
     if (lsign && !rsign) return -1; // - < +
-    for (; i>=0; --i) {
-	if (lwp[i] > rwp[i]) return 1;
-	if (lwp[i] < rwp[i]) return -1;
-    }
-    return(0); // ==
+    // Same sign, so compares as unsigned
+    return _VL_CMP_W(words, lwp, rwp);
 }
 
 //=========================================================================
@@ -1245,16 +1569,54 @@ static inline int _VL_CMPS_W(int lbits, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
 #define VL_MODDIV_WWW(lbits,owp,lwp,rwp) (_vl_moddiv_w(lbits,owp,lwp,rwp,1))
 
 static inline WDataOutP VL_ADD_W(int words, WDataOutP owp,WDataInP lwp,WDataInP rwp) VL_MT_SAFE {
+#if VL_WIDE_LIMB64
+    QData carry = 0;
+    for (int i=0; i<words/2; ++i) {
+	QData l = _VL_LIMB_Q(lwp,i);
+	QData sum = l + _VL_LIMB_Q(rwp,i);
+	QData carryout = (sum < l);
+	sum += carry;
+	carryout |= (sum < carry);
+	_VL_SET_LIMB_Q(owp, i, sum);
+	carry = carryout;
+    }
+    if (words & 1) owp[words-1] = lwp[words-1] + rwp[words-1] + static_cast<IData>(carry);
+#else
     QData carry = 0;
     for (int i=0; i<words; ++i) {
 	carry = carry + static_cast<QData>(lwp[i]) + static_cast<QData>(rwp[i]);
 	owp[i] = (carry & VL_ULL(0xffffffff));
 	carry = (carry >> VL_ULL(32)) & VL_ULL(0xffffffff);
     }
+#endif
+    return(owp);
+}
+
+#if VL_WIDE_LIMB64
+// Internal usage, lhs - rhs with borrow across 64-bit limbs
+static inline WDataOutP _VL_SUB_LIMB_W(int words, WDataOutP owp, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
+    QData borrow = 0;
+    for (int i=0; i<words/2; ++i) {
+	QData l = lwp ? _VL_LIMB_Q(lwp,i) : 0;
+	QData r = _VL_LIMB_Q(rwp,i);
+	QData diff = l - r;
+	QData borrowout = (l < r);
+	borrowout |= (diff < borrow);
+	diff -= borrow;
+	_VL_SET_LIMB_Q(owp, i, diff);
+	borrow = borrowout;
+    }
+    if (words & 1) {
+	owp[words-1] = (lwp ? lwp[words-1] : 0) - rwp[words-1] - static_cast<IData>(borrow);
+    }
     return(owp);
 }
+#endif
 
 static inline WDataOutP VL_SUB_W(int words, WDataOutP owp,WDataInP lwp,WDataInP rwp) VL_MT_SAFE {
+#if VL_WIDE_LIMB64
+    return _VL_SUB_LIMB_W(words, owp, lwp, rwp);
+#else
     QData carry = 0;
     for (int i=0; i<words; ++i) {
 	carry = carry + static_cast<QData>(lwp[i]) + static_cast<QData>(static_cast<IData>(~rwp[i]));
@@ -1263,6 +1625,7 @@ static inline WDataOutP VL_SUB_W(int words, WDataOutP owp,WDataInP lwp,WDataInP
 	carry = (carry >> VL_ULL(32)) & VL_ULL(0xffffffff);
     }
     return(owp);
+#endif
 }
 
 // Optimization bug in GCC 2.96 and presumably all-pre GCC 3 versions need this workaround,
@@ -1272,6 +1635,9 @@ static inline IData  VL_NEGATE_I(IData data) VL_PURE { return -data; }
 static inline QData  VL_NEGATE_Q(QData data) VL_PURE { return -data; }
 
 static inline WDataOutP VL_NEGATE_W(int words, WDataOutP owp, WDataInP lwp) VL_MT_SAFE {
+#if VL_WIDE_LIMB64
+    return _VL_SUB_LIMB_W(words, owp, NULL, lwp);
+#else
     QData carry = 0;
     for (int i=0; i<words; ++i) {
 	carry = carry + static_cast<QData>(static_cast<IData>(~lwp[i]));
@@ -1280,18 +1646,23 @@ static inline WDataOutP VL_NEGATE_W(int words, WDataOutP owp, WDataInP lwp) VL_M
 	carry = (carry >> VL_ULL(32)) & VL_ULL(0xffffffff);
     }
     return(owp);
+#endif
 }
 
 static inline WDataOutP VL_MUL_W(int words, WDataOutP owp,WDataInP lwp,WDataInP rwp) VL_MT_SAFE {
+#if VL_MUL_INT128
+    // Wider products are faster on 64-bit limbs than the call costs
+    if (words > VL_MUL_INLINE_WORDS) return _vl_mul_w(words, owp, lwp, rwp);
+#endif
+    // Only the low words of the product are kept, so each row stops there
     for (int i=0; i<words; ++i) owp[i] = 0;
     for (int lword=0; lword<words; ++lword) {
-	for (int rword=0; rword<words; ++rword) {
-	    QData mul = static_cast<QData>(lwp[lword]) * static_cast<QData>(rwp[rword]);
-	    for (int qword=lword+rword; qword<words; ++qword) {
-		mul += static_cast<QData>(owp[qword]);
-		owp[qword] = (mul & VL_ULL(0xffffffff));
-		mul = (mul >> VL_ULL(32)) & VL_ULL(0xffffffff);
-	    }
+	QData carry = 0;  // Product plus word plus carry never overflows 64 bits
+	for (int rword=0; lword+rword<words; ++rword) {
+	    carry += static_cast<QData>(lwp[lword]) * static_cast<QData>(rwp[rword]);
+	    carry += static_cast<QData>(owp[lword+rword]);
+	    owp[lword+rword] = static_cast<IData>(carry);
+	    carry = carry >> VL_ULL(32);
 	}
     }
     // Last output word is dirty
@@ -1310,39 +1681,9 @@ static inline QData VL_MULS_QQQ(int,int lbits,int, QData lhs,QData rhs) VL_PURE
 }
 
 static inline WDataOutP VL_MULS_WWW(int,int lbits,int, WDataOutP owp,WDataInP lwp,WDataInP rwp) VL_MT_SAFE {
-    int words = VL_WORDS_I(lbits);
-    // cppcheck-suppress variableScope
-    WData lwstore[VL_MULS_MAX_WORDS]; // Fixed size, as MSVC++ doesn't allow [words] here
-    // cppcheck-suppress variableScope
-    WData rwstore[VL_MULS_MAX_WORDS];
-    WDataInP lwusp = lwp;
-    WDataInP rwusp = rwp;
-    IData lneg = VL_SIGN_I(lbits,lwp[words-1]);
-    if (lneg) { // Negate lhs
-	lwusp = lwstore;
-	VL_NEGATE_W(words, lwstore, lwp);
-	lwstore[words-1] &= VL_MASK_I(lbits);  // Clean it
-    }
-    IData rneg = VL_SIGN_I(lbits,rwp[words-1]);
-    if (rneg) { // Negate rhs
-	rwusp = rwstore;
-	VL_NEGATE_W(words, rwstore, rwp);
-	rwstore[words-1] &= VL_MASK_I(lbits);  // Clean it
-    }
-    VL_MUL_W(words,owp,lwusp,rwusp);
-    owp[words-1] &= VL_MASK_I(lbits);  // Clean.  Note it's ok for the multiply to overflow into the sign bit
-    if ((lneg ^ rneg) & 1) {      // Negate output  (not using NEGATE, as owp==lwp)
-	QData carry = 0;
-	for (int i=0; i<words; ++i) {
-	    carry = carry + static_cast<QData>(static_cast<IData>(~owp[i]));
-	    if (i==0) carry++;  // Negation of temp2
-	    owp[i] = (carry & VL_ULL(0xffffffff));
-	    carry = (carry >> VL_ULL(32)) & VL_ULL(0xffffffff);
-	}
-	//Not needed: owp[words-1] |= 1<<VL_BITBIT_I(lbits-1);  // Set sign bit
-    }
-    // Last output word is dirty
-    return(owp);
+    // The low lbits of a two's complement product do not depend on the
+    // operands' signs, so this is the unsigned multiply
+    return VL_MUL_W(VL_WORDS_I(lbits), owp, lwp, rwp);
 }
 
 static inline IData VL_DIVS_III(int lbits, IData lhs,IData rhs) VL_PURE {
@@ -1490,6 +1831,53 @@ WDataOutP VL_POWSS_WWQ(int obits, int, int rbits,
 QData VL_POWSS_QQW(int obits, int, int rbits,
                    QData lhs, WDataInP rwp, bool lsign, bool rsign);
 
+//===================================================================
+// Width-specialized wide operators
+//
+// V3EmitC calls wide operators as VL_ADD_W<words>(owp,lwp,rwp) rather
+// than VL_ADD_W(words,owp,lwp,rwp).  Each width used then compiles into
+// its own copy with a constant word count, which the compiler can unroll
+// or vectorize even where it would not inline the generic helper.
+
+#define _VL_WORDS_TEMPLATE_OLR(name) \
+    template <int words> VL_ATTR_FLATTEN static inline \
+    WDataOutP name(WDataOutP owp, WDataInP lwp, WDataInP rwp) VL_MT_SAFE { \
+	return name(words, owp, lwp, rwp); }
+#define _VL_WORDS_TEMPLATE_OL(name) \
+    template <int words> VL_ATTR_FLATTEN static inline \
+    WDataOutP name(WDataOutP owp, WDataInP lwp) VL_MT_SAFE { \
+	return name(words, owp, lwp); }
+#define _VL_WORDS_TEMPLATE_LR(name) \
+    template <int words> VL_ATTR_FLATTEN static inline \
+    IData name(WDataInP lwp, WDataInP rwp) VL_MT_SAFE { \
+	return name(words, lwp, rwp); }
+#define _VL_WORDS_TEMPLATE_L(name) \
+    template <int words> VL_ATTR_FLATTEN static inline \
+    IData name(WDataInP lwp) VL_MT_SAFE { \
+	return name(words, lwp); }
+
+_VL_WORDS_TEMPLATE_OLR(VL_ADD_W)
+_VL_WORDS_TEMPLATE_OLR(VL_SUB_W)
+_VL_WORDS_TEMPLATE_OLR(VL_MUL_W)
+_VL_WORDS_TEMPLATE_OLR(VL_AND_W)
+_VL_WORDS_TEMPLATE_OLR(VL_OR_W)
+_VL_WORDS_TEMPLATE_OLR(VL_XOR_W)
+_VL_WORDS_TEMPLATE_OLR(VL_XNOR_W)
+_VL_WORDS_TEMPLATE_OL(VL_NEGATE_W)
+_VL_WORDS_TEMPLATE_OL(VL_NOT_W)
+_VL_WORDS_TEMPLATE_LR(VL_EQ_W)
+_VL_WORDS_TEMPLATE_LR(VL_NEQ_W)
+_VL_WORDS_TEMPLATE_LR(VL_LT_W)
+_VL_WORDS_TEMPLATE_LR(VL_LTE_W)
+_VL_WORDS_TEMPLATE_LR(VL_GT_W)
+_VL_WORDS_TEMPLATE_LR(VL_GTE_W)
+_VL_WORDS_TEMPLATE_L(VL_REDOR_W)
+_VL_WORDS_TEMPLATE_L(VL_REDXOR_W)
+_VL_WORDS_TEMPLATE_L(VL_COUNTONES_W)
+_VL_WORDS_TEMPLATE_L(VL_ONEHOT_W)
+_VL_WORDS_TEMPLATE_L(VL_ONEHOT0_W)
+_VL_WORDS_TEMPLATE_L(VL_CLOG2_W)
+
 //===================================================================
 // Concat/replication
 
@@ -87,7 +87,7 @@ public:
 /// All value and keys are indexed into a unique number.  Thus we can greatly reduce
 /// the storage requirements for otherwise identical keys.
 
-class VerilatedCovImp : VerilatedCovImpBase {
+class VerilatedCovImp : VerilatedCovImpBase, public VerilatedVirtualBase {
 private:
     // TYPES
     typedef std::map<std::string,int> ValueIndexMap;
@@ -104,31 +104,36 @@ private:
     VerilatedCovImpItem* m_insertp VL_GUARDED_BY(m_mutex);  ///< Item about to insert
     const char*         m_insertFilenamep VL_GUARDED_BY(m_mutex);  ///< Filename about to insert
     int                 m_insertLineno VL_GUARDED_BY(m_mutex);  ///< Line number about to insert
+    int                 m_nextIndex VL_GUARDED_BY(m_mutex);  ///< Next value index
 
     // CONSTRUCTORS
     VerilatedCovImp() {
 	m_insertp = NULL;
 	m_insertFilenamep = NULL;
 	m_insertLineno = 0;
+	m_nextIndex = KEY_UNDEF+1;
     }
     VL_UNCOPYABLE(VerilatedCovImp);
 public:
-    ~VerilatedCovImp() { clearGuts(); }
+    virtual ~VerilatedCovImp() { clearGuts(); }
+    /// Database of the thread's context, created on first use
     static VerilatedCovImp& imp() VL_MT_SAFE {
-	static VerilatedCovImp s_singleton;
-	return s_singleton;
+	static VerilatedMutex s_createMutex;
+	VerilatedContext* contextp = Verilated::threadContextp();
+	VerilatedLockGuard lock(s_createMutex);
+	if (VL_UNLIKELY(!contextp->coveragep())) contextp->coveragep(new VerilatedCovImp);
+	return *static_cast<VerilatedCovImp*>(contextp->coveragep());
     }
 
 private:
     // PRIVATE METHODS
     int valueIndex(const std::string& value) VL_REQUIRES(m_mutex) {
-	static int nextIndex = KEY_UNDEF+1;
 	ValueIndexMap::iterator iter = m_valueIndexes.find(value);
 	if (iter != m_valueIndexes.end()) return iter->second;
-	nextIndex++;  assert(nextIndex>0);
-	m_valueIndexes.insert(std::make_pair(value, nextIndex));
-	m_indexValues.insert(std::make_pair(nextIndex, value));
-	return nextIndex;
+	m_nextIndex++;  assert(m_nextIndex>0);
+	m_valueIndexes.insert(std::make_pair(value, m_nextIndex));
+	m_indexValues.insert(std::make_pair(m_nextIndex, value));
+	return m_nextIndex;
     }
     static std::string dequote(const std::string& text) VL_PURE {
 	// Quote any special characters
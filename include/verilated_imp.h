@@ -39,8 +39,8 @@
 #include <deque>
 #include <string>
 #ifdef VL_THREADED
-# include <functional>
-# include <queue>
+# include <atomic>
+# include <cstdarg>
 #endif
 
 class VerilatedScope;
@@ -49,86 +49,88 @@ class VerilatedScope;
 // Threaded message passing
 
 #ifdef VL_THREADED
-/// Message, enqueued on an mtask, and consumed on the main eval thread
+/// Message, enqueued on an mtask, and consumed on the main eval thread.
+/// Fixed size and copyable by value, so queueing a message never
+/// allocates.  Printf text is not held in the message, but is a range of
+/// the producing thread's text arena.
 class VerilatedMsg {
 public:
     // TYPES
-    struct Cmp {
-        bool operator() (const VerilatedMsg& a, const VerilatedMsg& b) const {
-            return a.mtaskId() < b.mtaskId(); }
-    };
+    enum MsgType { MSG_PRINTF, MSG_FINISH, MSG_STOP, MSG_FATAL };
 private:
     // MEMBERS
     vluint32_t          m_mtaskId;      ///< MTask that did enqueue
-    std::function<void()> m_cb; 	///< Lambda to execute when message received
+    MsgType             m_type;         ///< Action to take
+    int                 m_linenum;      ///< Line number for $finish etc
+    const char*         m_filename;     ///< Filename for $finish etc
+    const char*         m_hier;         ///< Hierarchy for $finish etc
+    const char*         m_msgp;         ///< Fatal message
+    size_t              m_textBegin;    ///< Printf text start in the thread's arena
+    size_t              m_textEnd;      ///< Printf text end in the thread's arena
 public:
     // CONSTRUCTORS
-    VerilatedMsg(const std::function<void()>& cb)
-        : m_mtaskId(Verilated::mtaskId()), m_cb(cb) {}
+    VerilatedMsg(MsgType type, const char* filename, int linenum, const char* hier,
+                 const char* msgp = NULL)
+        : m_mtaskId(Verilated::mtaskId()), m_type(type), m_linenum(linenum)
+        , m_filename(filename), m_hier(hier), m_msgp(msgp), m_textBegin(0), m_textEnd(0) {}
+    VerilatedMsg(size_t textBegin, size_t textEnd)
+        : m_mtaskId(Verilated::mtaskId()), m_type(MSG_PRINTF), m_linenum(0)
+        , m_filename(NULL), m_hier(NULL), m_msgp(NULL)
+        , m_textBegin(textBegin), m_textEnd(textEnd) {}
+    VerilatedMsg()
+        : m_mtaskId(0), m_type(MSG_PRINTF), m_linenum(0)
+        , m_filename(NULL), m_hier(NULL), m_msgp(NULL), m_textBegin(0), m_textEnd(0) {}
     ~VerilatedMsg() {}
     // METHODS
     vluint32_t mtaskId() const { return m_mtaskId; }
-    /// Execute the lambda function
-    void run() const { m_cb(); }
-};
-
-/// Each thread has a queue it pushes to
-/// This assumes no thread starts pushing the next tick until the previous has drained.
-/// If more aggressiveness is needed, a double-buffered scheme might work well.
-class VerilatedEvalMsgQueue  {
-    typedef std::multiset<VerilatedMsg, VerilatedMsg::Cmp> VerilatedThreadQueue;
-
-    std::atomic<vluint64_t> m_depth;  ///< Current depth of queue (see comments below)
-
-    VerilatedMutex m_mutex;  ///< Mutex protecting queue
-    VerilatedThreadQueue m_queue VL_GUARDED_BY(m_mutex);  ///< Message queue
-public:
-    // CONSTRUCTORS
-    VerilatedEvalMsgQueue() : m_depth(0) {
-        assert(atomic_is_lock_free(&m_depth));
-    }
-    ~VerilatedEvalMsgQueue() { }
-private:
-    VL_UNCOPYABLE(VerilatedEvalMsgQueue);
-public:
-    // METHODS
-    //// Add message to queue (called by producer)
-    void post(const VerilatedMsg& msg) VL_EXCLUDES(m_mutex) {
-	VerilatedLockGuard lock(m_mutex);
-	m_queue.insert(msg);  // Pass by value to copy the message into queue
-	++m_depth;
-    }
-    /// Service queue until completion (called by consumer)
-    void process() VL_EXCLUDES(m_mutex) {
-	// Tracking m_depth is redundant to e.g. getting the mutex and looking at queue size,
-	// but on the reader side it's 4x faster to test an atomic then getting a mutex
-	while (m_depth) {
-	    // Wait for a message to be added to the queue
-	    // We don't use unique_lock as want to unlock with the message copy still in scope
-	    m_mutex.lock();
-	    assert(!m_queue.empty()); // Otherwise m_depth is wrong
-	    // Unfortunately to release the lock we need to copy the message
-	    // (Or have the message be a pointer, but then new/delete cost on each message)
-	    // We assume messages are small, so copy
-	    auto it = m_queue.begin();
-	    const VerilatedMsg msg = *(it);
-	    m_queue.erase(it);
-	    m_mutex.unlock();
-	    m_depth--;  // Ok if outside critical section as only this code checks the value
-	    {
-                VL_DEBUG_IF(VL_DBG_MSGF("Executing callback from mtaskId=%d\n", msg.mtaskId()););
-                msg.run();
-	    }
-	}
+    bool isPrintf() const { return m_type == MSG_PRINTF; }
+    size_t textBegin() const { return m_textBegin; }
+    size_t textEnd() const { return m_textEnd; }
+    void textEnd(size_t end) { m_textEnd = end; }
+    /// Execute the message's action, once, on the eval thread.
+    /// Printf messages are instead written by the eval queue.
+    void run() {
+        switch (m_type) {
+        case MSG_PRINTF: break;
+        case MSG_FINISH: vl_finish(m_filename, m_linenum, m_hier); break;
+        case MSG_STOP: vl_stop(m_filename, m_linenum, m_hier); break;
+        case MSG_FATAL: vl_fatal(m_filename, m_linenum, m_hier, m_msgp); break;
+        }
     }
 };
 
-/// Each thread has a local queue to build up messages until the end of the eval() call
-class VerilatedThreadMsgQueue  {
-    std::queue<VerilatedMsg> m_queue;
+/// Each thread has a local queue to build up messages until the end of the eval() call.
+/// A bounded single-producer/single-consumer ring: the owning thread posts,
+/// and the eval thread drains it in endOfEval, after the producer's mtasks
+/// are done.  If the ring fills, further messages spill to an overflow
+/// queue, which is only then touched, until the ring is drained.
+///
+/// $display and other printf text is appended, without locking, to the
+/// thread's text arena, and consecutive text from one mtask shares a
+/// single message.  The eval thread writes the text of all threads in
+/// one print per eval, and then empties the arenas for reuse.
+class VerilatedThreadMsgQueue {
+    // TYPES
+    enum { RING_SIZE = 256 };  // Power of 2
+    enum { ARENA_RESERVE = 16384 };  // Initial arena bytes
+    // MEMBERS
+    VerilatedMsg m_ring[RING_SIZE];  ///< Message slots
+    std::atomic<vluint32_t> m_head;  ///< Next slot to write, written by producer
+    std::atomic<vluint32_t> m_tail;  ///< Next slot to read, written by consumer
+    std::deque<VerilatedMsg> m_overflow;  ///< Messages that didn't fit the ring
+    vluint32_t m_unflushed;  ///< Messages posted since last flush, producer only
+    std::string m_arena;  ///< Printf text of messages not yet written
+    VerilatedMsg* m_openTextp;  ///< Last printf message, may be extended until flush
+    std::atomic<bool> m_listed;  ///< On an eval queue's ready list
+    VerilatedThreadMsgQueue* m_nextp;  ///< Next on the eval queue's ready list
+    friend class VerilatedEvalMsgQueue;
 public:
     // CONSTRUCTORS
-    VerilatedThreadMsgQueue() { }
+    VerilatedThreadMsgQueue()
+        : m_head(0), m_tail(0), m_unflushed(0), m_openTextp(NULL)
+        , m_listed(false), m_nextp(NULL) {
+        m_arena.reserve(ARENA_RESERVE);
+    }
     ~VerilatedThreadMsgQueue() {
 	// The only call of this with a non-empty queue is a fatal error.
 	// So this does not flush the queue, as the destination queue is not known to this class.
@@ -140,30 +142,279 @@ private:
 	static VL_THREAD_LOCAL VerilatedThreadMsgQueue t_s;
 	return t_s;
     }
+    VerilatedMsg* push(const VerilatedMsg& msg) {
+        VerilatedMsg* slotp;
+        vluint32_t head = m_head.load(std::memory_order_relaxed);
+        if (VL_LIKELY(m_overflow.empty()
+                      && head - m_tail.load(std::memory_order_acquire) < RING_SIZE)) {
+            slotp = &m_ring[head & (RING_SIZE-1)];
+            *slotp = msg;
+            m_head.store(head+1, std::memory_order_release);
+        } else {
+            m_overflow.push_back(msg);
+            slotp = &m_overflow.back();
+        }
+        ++m_unflushed;
+        return slotp;
+    }
+    /// Post the arena text appended since textBegin
+    void pushText(size_t textBegin) {
+        size_t textEnd = m_arena.size();
+        if (VL_UNLIKELY(textBegin == textEnd)) return;
+        // The eval thread reads no message until the flush at the end of
+        // the thread's mtasks, so the last one may still be extended
+        if (m_openTextp && m_openTextp->mtaskId() == Verilated::mtaskId()
+            && m_openTextp->textEnd() == textBegin) {
+            m_openTextp->textEnd(textEnd);
+        } else {
+            Verilated::endOfEvalReqdInc();
+            m_openTextp = push(VerilatedMsg(textBegin, textEnd));
+        }
+    }
+    // Consumer side
+    bool empty() const {
+        return (m_tail.load(std::memory_order_relaxed) == m_head.load(std::memory_order_acquire)
+                && m_overflow.empty());
+    }
+    VerilatedMsg& front() {
+        vluint32_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail != m_head.load(std::memory_order_acquire)) return m_ring[tail & (RING_SIZE-1)];
+        return m_overflow.front();
+    }
+    void pop() {
+        vluint32_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail != m_head.load(std::memory_order_acquire)) {
+            m_tail.store(tail+1, std::memory_order_release);
+        } else {
+            m_overflow.pop_front();
+        }
+    }
 public:
+    /// This thread's text arena; append text then call postText (called by producer)
+    static std::string& arena() VL_MT_SAFE { return threadton().m_arena; }
+    /// Post text appended to arena() since textBegin (called by producer, in an mtask)
+    static void postText(size_t textBegin) VL_MT_SAFE { threadton().pushText(textBegin); }
     /// Add message to queue, called by producer
     static void post(const VerilatedMsg& msg) VL_MT_SAFE {
         // Handle calls to threaded routines outside
         // of any mtask -- if an initial block calls $finish, say.
         if (Verilated::mtaskId() == 0) {
             // No queueing, just do the action immediately
-            msg.run();
+            VerilatedMsg runMsg = msg;
+            runMsg.run();
         } else {
             Verilated::endOfEvalReqdInc();
-            threadton().m_queue.push(msg);  // Pass by value to copy the message into queue
+            threadton().push(msg);
         }
     }
-    /// Push all messages to the eval's queue
-    static void flush(VerilatedEvalMsgQueue* evalMsgQp) VL_MT_SAFE {
-	while (!threadton().m_queue.empty()) {
-	    evalMsgQp->post(threadton().m_queue.front());
-	    threadton().m_queue.pop();
-	    Verilated::endOfEvalReqdDec();
-	}
+    /// Hand this thread's messages to the eval's queue
+    static void flush(VerilatedEvalMsgQueue* evalMsgQp) VL_MT_SAFE;
+};
+
+/// Per-model queue of the thread rings holding messages for this eval.
+/// Threads list their ring, lock-free, at the end of their mtasks; the eval
+/// thread then merges the listed rings in mtask order.
+class VerilatedEvalMsgQueue  {
+    std::atomic<VerilatedThreadMsgQueue*> m_readyp;  ///< Rings with messages
+    std::string m_output;  ///< Printf text gathered for one print, consumer only
+public:
+    // CONSTRUCTORS
+    VerilatedEvalMsgQueue() : m_readyp(NULL) { }
+    ~VerilatedEvalMsgQueue() { }
+private:
+    VL_UNCOPYABLE(VerilatedEvalMsgQueue);
+public:
+    // METHODS
+    /// List a thread's ring (called by producer, once per eval)
+    void post(VerilatedThreadMsgQueue* qp) VL_MT_SAFE {
+        VerilatedThreadMsgQueue* headp = m_readyp.load(std::memory_order_relaxed);
+        do {
+            qp->m_nextp = headp;
+        } while (!m_readyp.compare_exchange_weak(headp, qp, std::memory_order_release,
+                                                 std::memory_order_relaxed));
+    }
+    /// Service queue until completion (called by consumer)
+    void process() VL_MT_SAFE {
+        // Messages are run in mtask order, so output is the same as a
+        // single threaded model's regardless of thread timing
+        VerilatedThreadMsgQueue* listp = m_readyp.exchange(NULL, std::memory_order_acquire);
+        if (VL_LIKELY(!listp)) return;
+        std::vector<VerilatedThreadMsgQueue*> rings;
+        for (VerilatedThreadMsgQueue* qp = listp; qp; qp = qp->m_nextp) rings.push_back(qp);
+        while (1) {
+            VerilatedThreadMsgQueue* bestp = NULL;
+            for (std::vector<VerilatedThreadMsgQueue*>::iterator it = rings.begin();
+                 it != rings.end(); ++it) {
+                if ((*it)->empty()) continue;
+                if (!bestp || (*it)->front().mtaskId() < bestp->front().mtaskId()) bestp = *it;
+            }
+            if (!bestp) break;
+            VL_DEBUG_IF(VL_DBG_MSGF("Executing callback from mtaskId=%d\n", bestp->front().mtaskId()););
+            // Copy out first, the action may post more (e.g. $stop's message)
+            VerilatedMsg msg = bestp->front();
+            bestp->pop();
+            if (msg.isPrintf()) {
+                m_output.append(bestp->m_arena, msg.textBegin(), msg.textEnd() - msg.textBegin());
+            } else {
+                writeOutput();  // Text before $finish etc. appears before its effects
+                msg.run();
+            }
+        }
+        writeOutput();
+        for (std::vector<VerilatedThreadMsgQueue*>::iterator it = rings.begin();
+             it != rings.end(); ++it) {
+            (*it)->m_arena.clear();  // Keeps capacity
+            (*it)->m_listed.store(false, std::memory_order_release);
+        }
+    }
+private:
+    void writeOutput() {
+        if (m_output.empty()) return;
+        VL_PRINTF("%s", m_output.c_str());
+        m_output.clear();
     }
 };
+
+inline void VerilatedThreadMsgQueue::flush(VerilatedEvalMsgQueue* evalMsgQp) VL_MT_SAFE {
+    VerilatedThreadMsgQueue& q = threadton();
+    if (!q.m_listed.load(std::memory_order_acquire) && !q.empty()) {
+        q.m_listed.store(true, std::memory_order_relaxed);
+        evalMsgQp->post(&q);
+    }
+    q.m_openTextp = NULL;
+    for (; q.m_unflushed; --q.m_unflushed) Verilated::endOfEvalReqdDec();
+}
 #endif // VL_THREADED
 
+//======================================================================
+// VerilatedFd
+
+/// One file descriptor of a context's table.  Once created for a table
+/// slot it lives as long as the context, and is reused when the slot is
+/// reopened, so lookups may hold it without a table lock.  Writes are
+/// gathered in a per-descriptor buffer, so high volume $fwrite costs
+/// neither a shared lock nor a stdio call each.  Anything else needing
+/// the FILE* takes it with flushedFp(), which first writes the buffer.
+class VerilatedFd {
+    // MEMBERS
+    VerilatedMutex      m_mutex;  ///< Protect m_fp, m_buf
+    FILE*               m_fp VL_GUARDED_BY(m_mutex);  ///< Open file, or NULL when free
+    bool                m_buffered;  ///< Buffer writes; not stdin/out/err, which interleave with $display
+    std::string         m_buf VL_GUARDED_BY(m_mutex);  ///< Pending writes
+public:
+    enum { BUFFER_BYTES = 65536 };  ///< Buffered bytes that trigger a write
+    // CONSTRUCTORS
+    VerilatedFd(FILE* fp, bool buffered) : m_fp(fp), m_buffered(buffered) {
+	if (m_buffered) m_buf.reserve(BUFFER_BYTES);
+    }
+    ~VerilatedFd() {
+	VerilatedLockGuard lock(m_mutex);
+	flushBuf();
+    }
+private:
+    VL_UNCOPYABLE(VerilatedFd);
+    void flushBuf() VL_REQUIRES(m_mutex) {
+	if (m_buf.empty()) return;
+	if (VL_LIKELY(m_fp)) fwrite(m_buf.data(), 1, m_buf.size(), m_fp);
+	m_buf.clear();
+    }
+public:
+    // METHODS
+    /// Format $fwrite text and write it, or buffer it
+    void vwritef(const char* formatp, va_list ap) VL_MT_SAFE;
+    /// Return the FILE*, or NULL if closed, with pending writes written
+    FILE* flushedFp() VL_MT_SAFE {
+	VerilatedLockGuard lock(m_mutex);
+	flushBuf();
+	return m_fp;
+    }
+    void open(FILE* fp) VL_MT_SAFE {
+	VerilatedLockGuard lock(m_mutex);
+	m_fp = fp;
+    }
+    /// Close the file, returning false if not open
+    bool close() VL_MT_SAFE {
+	VerilatedLockGuard lock(m_mutex);
+	if (VL_UNLIKELY(!m_fp)) return false;
+	flushBuf();
+	fclose(m_fp);
+	m_fp = NULL;
+	return true;
+    }
+};
+
+#ifdef VL_THREADED
+typedef std::atomic<VerilatedFd*> VerilatedFdSlot;
+#else
+typedef VerilatedFd* VerilatedFdSlot;
+#endif
+
+//======================================================================
+// VerilatedContextImp
+
+class VerilatedContextImp {
+    // Slow path state of a VerilatedContext
+    friend class VerilatedImp;
+    friend class VerilatedContext;
+
+    // TYPES
+    typedef std::vector<std::string> ArgVec;
+
+    // MEMBERS
+    // Nothing here is save-restored; users expected to re-register appropriately
+
+    VerilatedMutex      m_argMutex;  ///< Protect m_argVec, m_argVecLoaded
+    ArgVec              m_argVec VL_GUARDED_BY(m_argMutex);  ///< Argument list (NOT save-restored, may want different results)
+    bool                m_argVecLoaded VL_GUARDED_BY(m_argMutex);  ///< Ever loaded argument list
+
+    VerilatedMutex      m_nameMutex;  ///< Protect m_nameMap
+    VerilatedScopeNameMap m_nameMap VL_GUARDED_BY(m_nameMutex);  ///< Map of <scope_name, scope pointer>
+
+    // File I/O
+    // Fixed size, so lookups need no lock; slots only go from NULL to a
+    // descriptor, which is then only reopened, so never freed while in use
+    enum { FD_TABLE_SIZE = 1024 };  ///< Maximum open descriptors, including stdin/out/err
+    VerilatedFdSlot     m_fds[FD_TABLE_SIZE];  ///< Descriptors, by index
+    VerilatedMutex      m_fdMutex;  ///< Protect m_fds stores, m_fdFree
+    std::deque<IData>   m_fdFree VL_GUARDED_BY(m_fdMutex);  ///< List of free descriptors (SLOW - FOPEN/CLOSE only)
+
+public: // But only for verilated*.cpp
+    // CONSTRUCTORS
+    VerilatedContextImp()
+	: m_argVecLoaded(false) {
+	for (IData idx = 0; idx < FD_TABLE_SIZE; ++idx) fdSlot(idx, NULL);
+	fdSlot(0, new VerilatedFd(stdin, false));
+	fdSlot(1, new VerilatedFd(stdout, false));
+	fdSlot(2, new VerilatedFd(stderr, false));
+	// Reverse, so the lowest free descriptor is used first
+	for (IData idx = FD_TABLE_SIZE - 1; idx >= 3; --idx) m_fdFree.push_back(idx);
+    }
+    ~VerilatedContextImp() {
+	// Close files the simulation left open, writing any buffered data
+	for (IData idx = 3; idx < FD_TABLE_SIZE; ++idx) {
+	    if (VerilatedFd* fdp = fdSlot(idx)) { fdp->close(); delete fdp; }
+	}
+	for (IData idx = 0; idx < 3; ++idx) delete fdSlot(idx);
+    }
+    // METHODS
+    VerilatedFd* fdSlot(IData idx) const VL_MT_SAFE {
+#ifdef VL_THREADED
+	return m_fds[idx].load(std::memory_order_acquire);
+#else
+	return m_fds[idx];
+#endif
+    }
+    void fdSlot(IData idx, VerilatedFd* fdp) VL_MT_SAFE {
+#ifdef VL_THREADED
+	m_fds[idx].store(fdp, std::memory_order_release);
+#else
+	m_fds[idx] = fdp;
+#endif
+    }
+private:
+    VL_UNCOPYABLE(VerilatedContextImp);
+};
+
 //======================================================================
 // VerilatedImp
 
@@ -171,7 +422,7 @@ class VerilatedImp {
     // Whole class is internal use only - Global information shared between verilated*.cpp files.
 
     // TYPES
-    typedef std::vector<std::string> ArgVec;
+    typedef VerilatedContextImp::ArgVec ArgVec;
     typedef std::map<std::pair<const void*,void*>,void*> UserMap;
     typedef std::map<const char*, int, VerilatedCStrCmp>  ExportNameMap;
 
@@ -179,35 +430,20 @@ class VerilatedImp {
     static VerilatedImp	s_s;		///< Static Singleton; One and only static this
 
     // Nothing here is save-restored; users expected to re-register appropriately
-
-    VerilatedMutex      m_argMutex;  ///< Protect m_argVec, m_argVecLoaded
-    ArgVec              m_argVec VL_GUARDED_BY(m_argMutex);  ///< Argument list (NOT save-restored, may want different results)
-    bool                m_argVecLoaded VL_GUARDED_BY(m_argMutex);  ///< Ever loaded argument list
+    // Per-simulation state is in VerilatedContextImp
 
     VerilatedMutex      m_userMapMutex;  ///< Protect m_userMap
     UserMap             m_userMap VL_GUARDED_BY(m_userMapMutex);  ///< Map of <(scope,userkey), userData>
 
-    VerilatedMutex      m_nameMutex;  ///< Protect m_nameMap
-    VerilatedScopeNameMap m_nameMap VL_GUARDED_BY(m_nameMutex);  ///< Map of <scope_name, scope pointer>
     // Slow - somewhat static:
     VerilatedMutex      m_exportMutex;  ///< Protect m_nameMap
     ExportNameMap       m_exportMap VL_GUARDED_BY(m_exportMutex);  ///< Map of <export_func_proto, func number>
     int                 m_exportNext VL_GUARDED_BY(m_exportMutex);  ///< Next export funcnum
 
-    // File I/O
-    VerilatedMutex      m_fdMutex;  ///< Protect m_fdps, m_fdFree
-    std::vector<FILE*>  m_fdps VL_GUARDED_BY(m_fdMutex);  ///< File descriptors
-    std::deque<IData>   m_fdFree VL_GUARDED_BY(m_fdMutex);  ///< List of free descriptors (SLOW - FOPEN/CLOSE only)
-
 public: // But only for verilated*.cpp
     // CONSTRUCTORS
     VerilatedImp()
-	: m_argVecLoaded(false), m_exportNext(0) {
-	m_fdps.resize(3);
-	m_fdps[0] = stdin;
-	m_fdps[1] = stdout;
-	m_fdps[2] = stderr;
-    }
+	: m_exportNext(0) {}
     ~VerilatedImp() {}
 private:
     VL_UNCOPYABLE(VerilatedImp);
@@ -216,21 +452,35 @@ public:
     static void internalsDump() VL_MT_SAFE;
     static void versionDump() VL_MT_SAFE;
 
+    // METHODS - contexts
+    /// Slow path state of the thread's context
+    static VerilatedContextImp* contextImpp() VL_MT_SAFE {
+	return Verilated::threadContextp()->impp(); }
+    /// Slow path state of the context a scope's model was constructed in
+    static VerilatedContextImp* contextImpp(const VerilatedScope* scopep) VL_MT_SAFE {
+	return scopep->symsp()->__Vm_contextp->impp(); }
+
     // METHODS - arguments
 public:
-    static void commandArgs(int argc, const char** argv) VL_EXCLUDES(s_s.m_argMutex);
-    static void commandArgsAdd(int argc, const char** argv) VL_EXCLUDES(s_s.m_argMutex);
-    static std::string argPlusMatch(const char* prefixp) VL_EXCLUDES(s_s.m_argMutex) {
-	VerilatedLockGuard lock(s_s.m_argMutex);
+    static void commandArgs(VerilatedContextImp* cimpp, int argc, const char** argv)
+	VL_EXCLUDES(cimpp->m_argMutex);
+    static void commandArgsAdd(VerilatedContextImp* cimpp, int argc, const char** argv)
+	VL_EXCLUDES(cimpp->m_argMutex);
+    static std::string argPlusMatch(const char* prefixp) VL_MT_SAFE {
+	return argPlusMatch(contextImpp(), prefixp);
+    }
+    static std::string argPlusMatch(VerilatedContextImp* cimpp, const char* prefixp)
+	VL_EXCLUDES(cimpp->m_argMutex) {
+	VerilatedLockGuard lock(cimpp->m_argMutex);
 	// Note prefixp does not include the leading "+"
 	size_t len = strlen(prefixp);
-	if (VL_UNLIKELY(!s_s.m_argVecLoaded)) {
-	    s_s.m_argVecLoaded = true;  // Complain only once
+	if (VL_UNLIKELY(!cimpp->m_argVecLoaded)) {
+	    cimpp->m_argVecLoaded = true;  // Complain only once
 	    VL_FATAL_MT("unknown",0,"",
 			"%Error: Verilog called $test$plusargs or $value$plusargs without"
 			" testbench C first calling Verilated::commandArgs(argc,argv).");
 	}
-	for (ArgVec::const_iterator it=s_s.m_argVec.begin(); it!=s_s.m_argVec.end(); ++it) {
+	for (ArgVec::const_iterator it=cimpp->m_argVec.begin(); it!=cimpp->m_argVec.end(); ++it) {
 	    if ((*it)[0]=='+') {
 		if (0==strncmp(prefixp, it->c_str()+1, len)) return *it;
 	    }
@@ -238,7 +488,8 @@ public:
 	return "";
     }
 private:
-    static void commandArgsAddGuts(int argc, const char** argv) VL_REQUIRES(s_s.m_argMutex);
+    static void commandArgsAddGuts(VerilatedContextImp* cimpp, int argc, const char** argv)
+	VL_REQUIRES(cimpp->m_argMutex);
 
 public:
     // METHODS - user scope tracking
@@ -283,31 +534,37 @@ private:
 
 public: // But only for verilated*.cpp
     // METHODS - scope name
+    // Scopes are named within their model's context; lookups are in the thread's
     static void scopeInsert(const VerilatedScope* scopep) VL_MT_SAFE {
 	// Slow ok - called once/scope at construction
-	VerilatedLockGuard lock(s_s.m_nameMutex);
-	VerilatedScopeNameMap::iterator it=s_s.m_nameMap.find(scopep->name());
-	if (it == s_s.m_nameMap.end()) {
-	    s_s.m_nameMap.insert(it, std::make_pair(scopep->name(),scopep));
+	VerilatedContextImp* cimpp = contextImpp(scopep);
+	VerilatedLockGuard lock(cimpp->m_nameMutex);
+	VerilatedScopeNameMap::iterator it=cimpp->m_nameMap.find(scopep->name());
+	if (it == cimpp->m_nameMap.end()) {
+	    cimpp->m_nameMap.insert(it, std::make_pair(scopep->name(),scopep));
 	}
     }
     static inline const VerilatedScope* scopeFind(const char* namep) VL_MT_SAFE {
-	VerilatedLockGuard lock(s_s.m_nameMutex);  // If too slow, can assume this is only VL_MT_SAFE_POSINIT
-	VerilatedScopeNameMap::const_iterator it=s_s.m_nameMap.find(namep);
-	if (VL_LIKELY(it != s_s.m_nameMap.end())) return it->second;
+	VerilatedContextImp* cimpp = contextImpp();
+	VerilatedLockGuard lock(cimpp->m_nameMutex);  // If too slow, can assume this is only VL_MT_SAFE_POSINIT
+	VerilatedScopeNameMap::const_iterator it=cimpp->m_nameMap.find(namep);
+	if (VL_LIKELY(it != cimpp->m_nameMap.end())) return it->second;
 	else return NULL;
     }
     static void scopeErase(const VerilatedScope* scopep) VL_MT_SAFE {
 	// Slow ok - called once/scope at destruction
-	VerilatedLockGuard lock(s_s.m_nameMutex);
 	userEraseScope(scopep);
-	VerilatedScopeNameMap::iterator it=s_s.m_nameMap.find(scopep->name());
-	if (it != s_s.m_nameMap.end()) s_s.m_nameMap.erase(it);
+	if (!scopep->symsp()) return;  // Never configured, so never inserted
+	VerilatedContextImp* cimpp = contextImpp(scopep);
+	VerilatedLockGuard lock(cimpp->m_nameMutex);
+	VerilatedScopeNameMap::iterator it=cimpp->m_nameMap.find(scopep->name());
+	if (it != cimpp->m_nameMap.end() && it->second == scopep) cimpp->m_nameMap.erase(it);
     }
-    static void scopesDump() VL_MT_SAFE {
-	VerilatedLockGuard lock(s_s.m_nameMutex);
+    static void scopesDump(VerilatedContextImp* cimpp) VL_MT_SAFE {
+	VerilatedLockGuard lock(cimpp->m_nameMutex);
 	VL_PRINTF_MT("  scopesDump:\n");
-	for (VerilatedScopeNameMap::const_iterator it=s_s.m_nameMap.begin(); it!=s_s.m_nameMap.end(); ++it) {
+	for (VerilatedScopeNameMap::const_iterator it=cimpp->m_nameMap.begin();
+	     it!=cimpp->m_nameMap.end(); ++it) {
 	    const VerilatedScope* scopep = it->second;
 	    scopep->scopeDump();
 	}
@@ -315,7 +572,7 @@ public: // But only for verilated*.cpp
     }
     static const VerilatedScopeNameMap* scopeNameMap() VL_MT_SAFE_POSTINIT {
 	// Thread save only assuming this is called only after model construction completed
-        return &s_s.m_nameMap;
+        return &contextImpp()->m_nameMap;
     }
 
 public: // But only for verilated*.cpp
@@ -368,33 +625,47 @@ public: // But only for verilated*.cpp
 
 public: // But only for verilated*.cpp
     // METHODS - file IO
+    // Descriptors are per context, so each simulation has its own
     static IData fdNew(FILE* fp) VL_MT_SAFE {
 	if (VL_UNLIKELY(!fp)) return 0;
 	// Bit 31 indicates it's a descriptor not a MCD
-	VerilatedLockGuard lock(s_s.m_fdMutex);
-	if (s_s.m_fdFree.empty()) {
-	    // Need to create more space in m_fdps and m_fdFree
-	    size_t start = s_s.m_fdps.size();
-	    s_s.m_fdps.resize(start*2);
-	    for (size_t i=start; i<start*2; ++i) s_s.m_fdFree.push_back(static_cast<IData>(i));
+	VerilatedContextImp* cimpp = contextImpp();
+	VerilatedLockGuard lock(cimpp->m_fdMutex);
+	if (VL_UNLIKELY(cimpp->m_fdFree.empty())) {
+	    // Table full; fail as if the open had
+	    fclose(fp);
+	    return 0;
 	}
-	IData idx = s_s.m_fdFree.back(); s_s.m_fdFree.pop_back();
-	s_s.m_fdps[idx] = fp;
+	IData idx = cimpp->m_fdFree.back(); cimpp->m_fdFree.pop_back();
+	if (VerilatedFd* fdp = cimpp->fdSlot(idx)) fdp->open(fp);
+	else cimpp->fdSlot(idx, new VerilatedFd(fp, true));
 	return (idx | (1UL<<31));  // bit 31 indicates not MCD
     }
+    /// Close a descriptor's file
     static void fdDelete(IData fdi) VL_MT_SAFE {
+	VerilatedContextImp* cimpp = contextImpp();
+	VerilatedFd* fdp = fdToFd(fdi);
+	if (VL_UNLIKELY(!fdp)) return;
+	VerilatedLockGuard lock(cimpp->m_fdMutex);
+	if (VL_UNLIKELY(!fdp->close())) return;  // Already free
+	cimpp->m_fdFree.push_back(VL_MASK_I(31) & fdi);
+    }
+    /// Descriptor, or NULL if never opened; wait free
+    static inline VerilatedFd* fdToFd(IData fdi) VL_MT_SAFE {
 	IData idx = VL_MASK_I(31) & fdi;
-	VerilatedLockGuard lock(s_s.m_fdMutex);
-	if (VL_UNLIKELY(!(fdi & (1ULL<<31)) || idx >= s_s.m_fdps.size())) return;
-	if (VL_UNLIKELY(!s_s.m_fdps[idx])) return;  // Already free
-	s_s.m_fdps[idx] = NULL;
-	s_s.m_fdFree.push_back(idx);
+	if (VL_UNLIKELY(!(fdi & (1ULL<<31)) || idx >= VerilatedContextImp::FD_TABLE_SIZE)) return NULL;
+	return contextImpp()->fdSlot(idx);
     }
     static inline FILE* fdToFp(IData fdi) VL_MT_SAFE {
-	IData idx = VL_MASK_I(31) & fdi;
-	VerilatedLockGuard lock(s_s.m_fdMutex);  // This might get slow, if it does we can cache it
-	if (VL_UNLIKELY(!(fdi & (1ULL<<31)) || idx >= s_s.m_fdps.size())) return NULL;
-	return s_s.m_fdps[idx];
+	VerilatedFd* fdp = fdToFd(fdi);
+	return VL_LIKELY(fdp) ? fdp->flushedFp() : NULL;
+    }
+    /// Write all buffered descriptors of the calling thread's context
+    static void fdFlushAll() VL_MT_SAFE {
+	VerilatedContextImp* cimpp = contextImpp();
+	for (IData idx = 3; idx < VerilatedContextImp::FD_TABLE_SIZE; ++idx) {
+	    if (VerilatedFd* fdp = cimpp->fdSlot(idx)) fdp->flushedFp();
+	}
     }
 };
 
@@ -0,0 +1,304 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//=============================================================================
+//
+// THIS MODULE IS PUBLICLY LICENSED
+//
+// Copyright 2012-2018 by Wilson Snyder.  This program is free software;
+// you can redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License Version 2.0.
+//
+// This is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+//=============================================================================
+///
+/// \file
+/// \brief Thread pool for Verilated models
+///
+//=============================================================================
+
+#include "verilatedos.h"
+#include "verilated_threads.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+// Spins before an idle worker starts yielding its CPU each check
+#ifndef VL_WORKER_SPINS
+# define VL_WORKER_SPINS 50000
+#endif
+
+// Records preallocated per thread with --prof-threads
+#ifndef VL_PROF_THREADS_RECORDS
+# define VL_PROF_THREADS_RECORDS (1<<16)
+#endif
+
+//=============================================================================
+// VlWorkerThread
+
+VlWorkerThread::VlWorkerThread(int cpu)
+    : m_fnp(NULL)
+    , m_evenCycle(false)
+    , m_symtab(NULL)
+    , m_generation(0)
+    , m_exiting(false)
+    , m_cpu(cpu)
+    , m_thread(startWorker, this) {
+}
+
+VlWorkerThread::~VlWorkerThread() {
+    m_exiting.store(true, std::memory_order_release);
+    m_thread.join();
+}
+
+void VlWorkerThread::workerLoop() {
+    vluint32_t seen = 0;
+    while (1) {
+        // Busy-wait for the next task, backing off once idle a while
+        vluint32_t spins = 0;
+        while (m_generation.load(std::memory_order_acquire) == seen) {
+            if (VL_UNLIKELY(m_exiting.load(std::memory_order_acquire))) return;
+            if (VL_LIKELY(spins < VL_WORKER_SPINS)) {
+                ++spins;
+                VL_CPU_RELAX();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        ++seen;
+        m_fnp(m_evenCycle, m_symtab);
+    }
+}
+
+void VlWorkerThread::startWorker(VlWorkerThread* workerp) {
+    if (workerp->m_cpu >= 0) Verilated::pinThread(workerp->m_cpu);
+    workerp->workerLoop();
+}
+
+//=============================================================================
+// VlThreadPool
+
+VerilatedMutex VlThreadPool::s_poolsMutex;
+std::vector<VlThreadPool*> VlThreadPool::s_pools;
+
+VlThreadPool::VlThreadPool(int nThreads, bool profiling)
+    : m_profiling(profiling)
+    , m_profStartTick(0)
+    , m_profStartUs(0) {
+    if (m_profiling) {
+        m_profTraces.resize(nThreads);
+        for (int i = 0; i < nThreads; ++i) m_profTraces[i].reserve(VL_PROF_THREADS_RECORDS);
+        VL_RDTSC(m_profStartTick);
+        m_profStartUs = wallUs();
+        VerilatedLockGuard lock(s_poolsMutex);
+        s_pools.push_back(this);
+    }
+    // --threads must not exceed the host's processors, or spinning
+    // mtasks will starve the thread they're waiting on
+    unsigned cpus = std::thread::hardware_concurrency();
+    if (cpus && static_cast<unsigned>(nThreads) > cpus) {
+        VL_PRINTF_MT("%%Warning: System has %u CPUs but model was Verilated with"
+                     " --threads %d; may run slow.\n", cpus, nThreads);
+    }
+    // Index 0 of the reservation is left to the caller, which is not pinned
+    int pinBase = Verilated::pinCpuBase(nThreads, true);
+    for (int i = 1; i < nThreads; ++i) {
+        m_workers.push_back(new VlWorkerThread(pinBase >= 0 ? Verilated::pinCpu(pinBase, i) : -1));
+    }
+}
+
+VlThreadPool::~VlThreadPool() {
+    for (std::vector<VlWorkerThread*>::iterator it = m_workers.begin(); it != m_workers.end(); ++it) {
+        delete *it;
+    }
+    if (m_profiling) {
+        VerilatedLockGuard lock(s_poolsMutex);
+        s_pools.erase(std::find(s_pools.begin(), s_pools.end(), this));
+    }
+}
+
+//=============================================================================
+// VlThreadPool profiling
+
+double VlThreadPool::wallUs() {
+    return std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void VlThreadPool::profileMTask(vluint32_t mtaskId, vluint32_t thread,
+                                vluint32_t predictStart, vluint32_t predictCost,
+                                const char* blocksp) {
+    if (mtaskId >= m_profMTasks.size()) m_profMTasks.resize(mtaskId+1);
+    m_profMTasks[mtaskId].m_thread = thread;
+    m_profMTasks[mtaskId].m_predictStart = predictStart;
+    m_profMTasks[mtaskId].m_predictCost = predictCost;
+    m_profMTasks[mtaskId].m_blocksp = blocksp;
+}
+
+void VlThreadPool::profileDep(vluint32_t fromMTaskId, vluint32_t toMTaskId) {
+    if (toMTaskId >= m_profMTasks.size()) m_profMTasks.resize(toMTaskId+1);
+    m_profMTasks[toMTaskId].m_deps.push_back(fromMTaskId);
+}
+
+void VlThreadPool::profileDump(FILE* tracefp, bool& firstEvent, int pid,
+                               double ticksPerUs, FILE* summaryfp) {
+    // Trace events, one per record
+    for (size_t thread = 0; thread < m_profTraces.size(); ++thread) {
+        const ProfileTrace& trace = m_profTraces[thread];
+        for (ProfileTrace::const_iterator it = trace.begin(); it != trace.end(); ++it) {
+            double startUs = (it->m_startTime - m_profStartTick) / ticksPerUs;
+            double durUs = (it->m_endTime - it->m_startTime) / ticksPerUs;
+            fprintf(tracefp, "%s\n{\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,",
+                    firstEvent ? "" : ",", pid, static_cast<int>(thread), startUs, durUs);
+            firstEvent = false;
+            if (it->m_type == VlProfileRec::TYPE_EVAL) {
+                fprintf(tracefp, "\"name\":\"eval\",\"cat\":\"eval\"}");
+            } else {
+                vluint32_t id = it->m_mtaskId;
+                const ProfileMTask* mtaskp = (id < m_profMTasks.size()) ? &m_profMTasks[id] : NULL;
+                fprintf(tracefp, "\"name\":\"mt%u\",\"cat\":\"mtask\",\"args\":{"
+                        "\"predictStart\":%u,\"predictCost\":%u}}",
+                        id, mtaskp ? mtaskp->m_predictStart : 0, mtaskp ? mtaskp->m_predictCost : 0);
+            }
+        }
+    }
+
+    // Summary.  Each thread runs each of its mtasks once per eval, so the
+    // n'th record of an mtask belongs to the n'th eval.
+    std::vector<std::vector<double> > mtaskDurs (m_profMTasks.size());
+    std::vector<double> threadBusy (m_profTraces.size(), 0.0);
+    double evalUs = 0;
+    size_t evals = 0;
+    for (size_t thread = 0; thread < m_profTraces.size(); ++thread) {
+        const ProfileTrace& trace = m_profTraces[thread];
+        for (ProfileTrace::const_iterator it = trace.begin(); it != trace.end(); ++it) {
+            double durUs = (it->m_endTime - it->m_startTime) / ticksPerUs;
+            if (it->m_type == VlProfileRec::TYPE_EVAL) {
+                evalUs += durUs;
+                ++evals;
+            } else {
+                threadBusy[thread] += durUs;
+                if (it->m_mtaskId < mtaskDurs.size()) mtaskDurs[it->m_mtaskId].push_back(durUs);
+            }
+        }
+    }
+    // Measured critical path: longest dependency chain of measured mtask
+    // times, per eval.  Ids follow the schedule, so upstream ids are lower.
+    size_t cpEvals = evals;
+    for (size_t id = 1; id < mtaskDurs.size(); ++id) cpEvals = std::min(cpEvals, mtaskDurs[id].size());
+    double cpUs = 0;
+    std::vector<double> finish (m_profMTasks.size());
+    for (size_t eval = 0; eval < cpEvals; ++eval) {
+        double longest = 0;
+        for (size_t id = 1; id < m_profMTasks.size(); ++id) {
+            double start = 0;
+            const std::vector<vluint32_t>& deps = m_profMTasks[id].m_deps;
+            for (std::vector<vluint32_t>::const_iterator it = deps.begin(); it != deps.end(); ++it) {
+                start = std::max(start, finish[*it]);
+            }
+            finish[id] = start + mtaskDurs[id][eval];
+            longest = std::max(longest, finish[id]);
+        }
+        cpUs += longest;
+    }
+    // Predicted critical path, in cost units
+    vluint64_t cpPredict = 0;
+    std::vector<vluint64_t> predictFinish (m_profMTasks.size());
+    for (size_t id = 1; id < m_profMTasks.size(); ++id) {
+        vluint64_t start = 0;
+        const std::vector<vluint32_t>& deps = m_profMTasks[id].m_deps;
+        for (std::vector<vluint32_t>::const_iterator it = deps.begin(); it != deps.end(); ++it) {
+            start = std::max(start, predictFinish[*it]);
+        }
+        predictFinish[id] = start + m_profMTasks[id].m_predictCost;
+        cpPredict = std::max(cpPredict, predictFinish[id]);
+    }
+
+    fprintf(summaryfp, "Thread profile, model %d: %d threads, %d mtasks\n", pid,
+            static_cast<int>(m_profTraces.size()), static_cast<int>(m_profMTasks.size()) - 1);
+    if (!evals) {
+        fprintf(summaryfp, "  No evals recorded\n");
+        return;
+    }
+    fprintf(summaryfp, "  Evals recorded:           %d\n", static_cast<int>(evals));
+    fprintf(summaryfp, "  Mean eval time:           %.3f us\n", evalUs / evals);
+    if (cpEvals) {
+        fprintf(summaryfp, "  Mean critical path:       %.3f us (%.1f%% of eval)\n",
+                cpUs / cpEvals, 100.0 * (cpUs / cpEvals) / (evalUs / evals));
+    }
+    fprintf(summaryfp, "  Predicted critical path:  %" VL_PRI64 "u cost units\n", cpPredict);
+    for (size_t thread = 0; thread < m_profTraces.size(); ++thread) {
+        double waitUs = evalUs - threadBusy[thread];
+        if (waitUs < 0) waitUs = 0;  // Thread 0's eval record can't contain workers' startup skew
+        fprintf(summaryfp, "  Thread %-3d utilization %5.1f%%, busy %.3f us, waiting %.3f us%s\n",
+                static_cast<int>(thread), 100.0 * threadBusy[thread] / evalUs,
+                threadBusy[thread], waitUs,
+                (m_profTraces[thread].size() == m_profTraces[thread].capacity()) ? " (records full)" : "");
+    }
+}
+
+void VlThreadPool::profileDumpData(FILE* datafp) {
+    // Mean ticks of each mtask, with the logic they cover, for Verilator
+    // to read back with --prof-threads-data
+    std::vector<vluint64_t> ticks (m_profMTasks.size(), 0);
+    std::vector<vluint64_t> runs (m_profMTasks.size(), 0);
+    for (size_t thread = 0; thread < m_profTraces.size(); ++thread) {
+        const ProfileTrace& trace = m_profTraces[thread];
+        for (ProfileTrace::const_iterator it = trace.begin(); it != trace.end(); ++it) {
+            if (it->m_type != VlProfileRec::TYPE_MTASK_RUN || it->m_mtaskId >= ticks.size()) continue;
+            ticks[it->m_mtaskId] += it->m_endTime - it->m_startTime;
+            ++runs[it->m_mtaskId];
+        }
+    }
+    for (size_t id = 1; id < m_profMTasks.size(); ++id) {
+        if (!runs[id]) continue;
+        fprintf(datafp, "VLPROF mtask %d ticks %.1f cost %u blocks %s\n",
+                static_cast<int>(id), static_cast<double>(ticks[id]) / runs[id],
+                m_profMTasks[id].m_predictCost, m_profMTasks[id].m_blocksp);
+    }
+}
+
+void VlThreadPool::profileDumpAll(const char* tracefilenamep, const char* summaryfilenamep,
+                                  const char* datafilenamep) {
+    VerilatedLockGuard lock(s_poolsMutex);
+    FILE* tracefp = fopen(tracefilenamep, "w");
+    if (VL_UNLIKELY(!tracefp)) {
+        VL_PRINTF_MT("%%Warning: Can't write %s\n", tracefilenamep);
+        return;
+    }
+    FILE* summaryfp = summaryfilenamep ? fopen(summaryfilenamep, "w") : stdout;
+    if (VL_UNLIKELY(!summaryfp)) {
+        VL_PRINTF_MT("%%Warning: Can't write %s\n", summaryfilenamep);
+        summaryfp = stdout;
+    }
+    FILE* datafp = datafilenamep ? fopen(datafilenamep, "w") : NULL;
+    if (VL_UNLIKELY(datafilenamep && !datafp)) {
+        VL_PRINTF_MT("%%Warning: Can't write %s\n", datafilenamep);
+    }
+    fprintf(tracefp, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    bool firstEvent = true;
+    int pid = 0;
+    for (std::vector<VlThreadPool*>::iterator it = s_pools.begin(); it != s_pools.end(); ++it, ++pid) {
+        VlThreadPool* poolp = *it;
+        // Calibrate VL_RDTSC ticks against the wall clock since construction
+        vluint64_t tick; VL_RDTSC(tick);
+        double us = wallUs() - poolp->m_profStartUs;
+        double ticksPerUs = (tick != poolp->m_profStartTick && us > 0)
+            ? (tick - poolp->m_profStartTick) / us : 1.0;
+        poolp->profileDump(tracefp, firstEvent, pid, ticksPerUs, summaryfp);
+        if (datafp) poolp->profileDumpData(datafp);
+    }
+    fprintf(tracefp, "\n]}\n");
+    fclose(tracefp);
+    if (datafp) fclose(datafp);
+    if (summaryfp != stdout) fclose(summaryfp);
+    else fflush(stdout);
+}
+
+void Verilated::profThreadsDump(const char* tracefilenamep, const char* summaryfilenamep,
+                                const char* datafilenamep) VL_MT_SAFE {
+    VlThreadPool::profileDumpAll(tracefilenamep, summaryfilenamep, datafilenamep);
+}
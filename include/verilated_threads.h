@@ -0,0 +1,211 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//=============================================================================
+//
+// THIS MODULE IS PUBLICLY LICENSED
+//
+// Copyright 2012-2018 by Wilson Snyder.  This program is free software;
+// you can redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License Version 2.0.
+//
+// This is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+//=============================================================================
+///
+/// \file
+/// \brief Thread pool and macro-task synchronization for Verilated models
+///
+/// Used by models compiled with --threads greater than 1.  Each eval
+/// hands every worker its thread function, a static schedule of mtasks;
+/// the functions synchronize among themselves with VlMTaskVertex
+/// counters.  Nothing blocks in the kernel: all waits spin.
+///
+//=============================================================================
+
+#ifndef _VERILATED_THREADS_H_
+#define _VERILATED_THREADS_H_ 1
+
+#include "verilatedos.h"
+#include "verilated.h"
+
+#ifndef VL_THREADED
+# error "verilated_threads.h requires VL_THREADED; compile with --threads"
+#endif
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/// Thread function, called with the eval's cycle parity and the symbol table
+typedef void (*VlExecFnp)(bool, void*);
+
+//=============================================================================
+/// VlMTaskVertex - Count of upstream mtasks that have completed.
+///
+/// The count goes up on even evals and down on odd evals, so the counter
+/// never needs resetting between evals; an mtask is ready when the count
+/// has reached the number of upstream dependencies (even) or zero (odd).
+
+class VlMTaskVertex {
+    // MEMBERS
+    std::atomic<vluint32_t> m_upstreamDepsDone;  ///< Upstream dependencies done, this eval
+    const vluint32_t m_upstreamDepCount;  ///< Number of upstream dependencies
+    VL_UNCOPYABLE(VlMTaskVertex);
+public:
+    // CONSTRUCTORS
+    explicit VlMTaskVertex(vluint32_t upstreamDepCount)
+        : m_upstreamDepsDone(0), m_upstreamDepCount(upstreamDepCount) {}
+    ~VlMTaskVertex() {}
+    // METHODS
+    /// Called by an upstream mtask when it completes
+    inline void signalUpstreamDone(bool evenCycle) {
+        if (evenCycle) {
+            m_upstreamDepsDone.fetch_add(1, std::memory_order_release);
+        } else {
+            m_upstreamDepsDone.fetch_sub(1, std::memory_order_release);
+        }
+    }
+    inline bool areUpstreamDepsDone(bool evenCycle) const {
+        vluint32_t target = evenCycle ? m_upstreamDepCount : 0;
+        return m_upstreamDepsDone.load(std::memory_order_acquire) == target;
+    }
+    /// Spin until all upstream mtasks have signaled this eval
+    inline void waitUntilUpstreamDone(bool evenCycle) const {
+        while (VL_UNLIKELY(!areUpstreamDepsDone(evenCycle))) {
+            VL_CPU_RELAX();
+        }
+    }
+};
+
+//=============================================================================
+/// VlProfileRec - One timing record of --prof-threads, in VL_RDTSC ticks
+
+class VlProfileRec {
+public:
+    // TYPES
+    enum VlProfileType { TYPE_MTASK_RUN, TYPE_EVAL };
+    // MEMBERS
+    VlProfileType m_type;  ///< Record type
+    vluint32_t m_mtaskId;  ///< MTask, for TYPE_MTASK_RUN
+    vluint64_t m_startTime;  ///< Tick at start
+    vluint64_t m_endTime;  ///< Tick at end
+    // METHODS
+    inline void startRecord(vluint64_t time, vluint32_t mtaskId) {
+        m_type = TYPE_MTASK_RUN;
+        m_mtaskId = mtaskId;
+        m_startTime = time;
+        m_endTime = time;
+    }
+    inline void startEval(vluint64_t time) {
+        m_type = TYPE_EVAL;
+        m_mtaskId = 0;
+        m_startTime = time;
+        m_endTime = time;
+    }
+    inline void endRecord(vluint64_t time) { m_endTime = time; }
+};
+
+//=============================================================================
+/// VlWorkerThread - One worker of the pool, running a thread function per eval
+///
+/// Handing off work must not cost a system call; at MHz eval rates a
+/// futex wake per eval would swamp any parallel gain.  So the eval thread
+/// publishes the task by bumping an atomic generation, and the worker
+/// busy-waits for it, backing off to yielding the CPU when idle for long.
+
+class VlWorkerThread {
+    // MEMBERS
+    // Task slot, written by the eval thread only while the worker is idle
+    VlExecFnp m_fnp;  ///< Function to execute
+    bool m_evenCycle;  ///< Cycle parity to pass
+    void* m_symtab;  ///< Symbol table to pass
+    std::atomic<vluint32_t> m_generation;  ///< Bumped when a task is published
+    std::atomic<bool> m_exiting;  ///< Destructor requests thread exit
+    int m_cpu;  ///< CPU to pin to, or -1
+    std::thread m_thread;  ///< The worker thread; last so constructed last
+    VL_UNCOPYABLE(VlWorkerThread);
+public:
+    // CONSTRUCTORS
+    explicit VlWorkerThread(int cpu);
+    ~VlWorkerThread();
+    // METHODS
+    /// Hand the worker its function for this eval.  The worker must have
+    /// finished the previous one, which the mtask counters guarantee.
+    inline void addTask(VlExecFnp fnp, bool evenCycle, void* symtab) {
+        m_fnp = fnp;
+        m_evenCycle = evenCycle;
+        m_symtab = symtab;
+        m_generation.fetch_add(1, std::memory_order_release);
+    }
+private:
+    void workerLoop();
+    static void startWorker(VlWorkerThread* workerp);
+};
+
+//=============================================================================
+/// VlThreadPool - Workers for a model; thread 0 is the thread calling eval()
+
+class VlThreadPool {
+    // TYPES
+    typedef std::vector<VlProfileRec> ProfileTrace;
+    struct ProfileMTask {
+        vluint32_t m_thread;  ///< Scheduled thread
+        vluint32_t m_predictStart;  ///< Predicted start, in cost units
+        vluint32_t m_predictCost;  ///< Predicted cost
+        std::vector<vluint32_t> m_deps;  ///< Upstream mtask ids
+        const char* m_blocksp;  ///< Profile keys and costs of its logic
+        ProfileMTask() : m_thread(0), m_predictStart(0), m_predictCost(0), m_blocksp("") {}
+    };
+    // MEMBERS
+    std::vector<VlWorkerThread*> m_workers;  ///< Worker for each thread but thread 0
+    // For --prof-threads
+    bool m_profiling;  ///< Recording into m_profTraces
+    std::vector<ProfileTrace> m_profTraces;  ///< Per-thread records, preallocated
+    std::vector<ProfileMTask> m_profMTasks;  ///< Schedule, indexed by mtask id
+    vluint64_t m_profStartTick;  ///< VL_RDTSC at construction, for calibration
+    double m_profStartUs;  ///< Wall clock at construction, microseconds
+    // Pools to dump with Verilated::profThreadsDump, in construction order
+    static VerilatedMutex s_poolsMutex;
+    static std::vector<VlThreadPool*> s_pools VL_GUARDED_BY(s_poolsMutex);
+    VL_UNCOPYABLE(VlThreadPool);
+public:
+    // CONSTRUCTORS
+    /// Construct with the total number of threads, including the eval() caller.
+    /// With Verilated::threadPinning, workers are pinned to the next CPUs
+    /// of the process's affinity set where supported.  With profiling, each
+    /// thread records up to VL_PROF_THREADS_RECORDS mtask runs.
+    VlThreadPool(int nThreads, bool profiling);
+    ~VlThreadPool();
+    // METHODS
+    int numThreads() const { return m_workers.size() + 1; }
+    /// Worker running thread index+1, for the model's eval to hand tasks
+    VlWorkerThread* workerp(int index) {
+        assert(index >= 0);
+        assert(index < static_cast<int>(m_workers.size()));
+        return m_workers[index];
+    }
+    /// Next timing record for the thread, or NULL if not profiling or full
+    inline VlProfileRec* profileAppend(int thread) {
+        if (VL_LIKELY(!m_profiling)) return NULL;
+        ProfileTrace& trace = m_profTraces[thread];
+        if (VL_UNLIKELY(trace.size() == trace.capacity())) return NULL;  // Never reallocate
+        trace.push_back(VlProfileRec());
+        return &trace.back();
+    }
+    /// Describe the schedule, for the profile summary (called by model constructor)
+    void profileMTask(vluint32_t mtaskId, vluint32_t thread,
+                      vluint32_t predictStart, vluint32_t predictCost, const char* blocksp);
+    void profileDep(vluint32_t fromMTaskId, vluint32_t toMTaskId);
+    /// Write all pools' records as a Chrome trace, their summaries, and
+    /// the measured mtask costs for --prof-threads-data
+    static void profileDumpAll(const char* tracefilenamep, const char* summaryfilenamep,
+                               const char* datafilenamep);
+private:
+    void profileDump(FILE* tracefp, bool& firstEvent, int pid, double ticksPerUs, FILE* summaryfp);
+    void profileDumpData(FILE* datafp);
+    static double wallUs();
+};
+
+#endif
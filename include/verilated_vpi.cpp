@@ -323,7 +323,7 @@ struct VerilatedVpiTimedCbsCmp {
 
 class VerilatedVpiError;
 
-class VerilatedVpiImp {
+class VerilatedVpiImp : public VerilatedVirtualBase {
     enum { CB_ENUM_MAX_VALUE = cbAtEndOfSimTime+1 };  // Maxium callback reason
     typedef std::list<VerilatedVpioCb*> VpioCbList;
     typedef std::set<std::pair<QData,VerilatedVpioCb*>,VerilatedVpiTimedCbsCmp > VpioTimedCbs;
@@ -337,12 +337,18 @@ class VerilatedVpiImp {
     VerilatedVpiError*  m_errorInfop;  // Container for vpi error info
     VerilatedAssertOneThread m_assertOne;  ///< Assert only called from single thread
 
-    static VerilatedVpiImp s_s;  // Singleton
+    /// State of the thread's context, created on first use.  No lock, as
+    /// like VPI itself a context is only used by one thread at a time.
+    static VerilatedVpiImp& s() VL_MT_UNSAFE_ONE {
+        VerilatedContext* contextp = Verilated::threadContextp();
+        if (VL_UNLIKELY(!contextp->vpip())) contextp->vpip(new VerilatedVpiImp);
+        return *static_cast<VerilatedVpiImp*>(contextp->vpip());
+    }
 
 public:
     VerilatedVpiImp() { m_errorInfop=NULL; }
-    ~VerilatedVpiImp() {}
-    static void assertOneCheck() { s_s.m_assertOne.check(); }
+    virtual ~VerilatedVpiImp();
+    static void assertOneCheck() { s().m_assertOne.check(); }
     static void cbReasonAdd(VerilatedVpioCb* vop) {
         if (vop->reason() == cbValueChange) {
             if (VerilatedVpioVar* varop = VerilatedVpioVar::castp(vop->cb_datap()->obj)) {
@@ -352,13 +358,13 @@ public:
         if (VL_UNLIKELY(vop->reason() >= CB_ENUM_MAX_VALUE)) {
             VL_FATAL_MT(__FILE__,__LINE__,"", "vpi bb reason too large");
         }
-        s_s.m_cbObjLists[vop->reason()].push_back(vop);
+        s().m_cbObjLists[vop->reason()].push_back(vop);
     }
     static void cbTimedAdd(VerilatedVpioCb* vop) {
-        s_s.m_timedCbs.insert(std::make_pair(vop->time(), vop));
+        s().m_timedCbs.insert(std::make_pair(vop->time(), vop));
     }
     static void cbReasonRemove(VerilatedVpioCb* cbp) {
-        VpioCbList& cbObjList = s_s.m_cbObjLists[cbp->reason()];
+        VpioCbList& cbObjList = s().m_cbObjLists[cbp->reason()];
         // We do not remove it now as we may be iterating the list,
         // instead set to NULL and will cleanup later
         for (VpioCbList::iterator it=cbObjList.begin(); it!=cbObjList.end(); ++it) {
@@ -366,15 +372,15 @@ public:
         }
     }
     static void cbTimedRemove(VerilatedVpioCb* cbp) {
-        VpioTimedCbs::iterator it=s_s.m_timedCbs.find(std::make_pair(cbp->time(),cbp));
-        if (VL_LIKELY(it != s_s.m_timedCbs.end())) {
-            s_s.m_timedCbs.erase(it);
+        VpioTimedCbs::iterator it=s().m_timedCbs.find(std::make_pair(cbp->time(),cbp));
+        if (VL_LIKELY(it != s().m_timedCbs.end())) {
+            s().m_timedCbs.erase(it);
         }
     }
     static void callTimedCbs() VL_MT_UNSAFE_ONE {
         assertOneCheck();
         QData time = VL_TIME_Q();
-        for (VpioTimedCbs::iterator it=s_s.m_timedCbs.begin(); it!=s_s.m_timedCbs.end(); ) {
+        for (VpioTimedCbs::iterator it=s().m_timedCbs.begin(); it!=s().m_timedCbs.end(); ) {
             if (VL_UNLIKELY(it->first <= time)) {
                 VerilatedVpioCb* vop = it->second;
                 ++it;  // iterator may be deleted by callback
@@ -385,15 +391,15 @@ public:
         }
     }
     static QData cbNextDeadline() {
-        VpioTimedCbs::const_iterator it=s_s.m_timedCbs.begin();
-        if (VL_LIKELY(it!=s_s.m_timedCbs.end())) {
+        VpioTimedCbs::const_iterator it=s().m_timedCbs.begin();
+        if (VL_LIKELY(it!=s().m_timedCbs.end())) {
             return it->first;
         } else {
             return ~VL_ULL(0);  // maxquad
         }
     }
     static void callCbs(vluint32_t reason) {
-        VpioCbList& cbObjList = s_s.m_cbObjLists[reason];
+        VpioCbList& cbObjList = s().m_cbObjLists[reason];
         for (VpioCbList::iterator it=cbObjList.begin(); it!=cbObjList.end();) {
             if (VL_UNLIKELY(!*it)) {  // Deleted earlier, cleanup
                 it = cbObjList.erase(it);
@@ -406,7 +412,7 @@ public:
     }
     static void callValueCbs() VL_MT_UNSAFE_ONE {
         assertOneCheck();
-        VpioCbList& cbObjList = s_s.m_cbObjLists[cbValueChange];
+        VpioCbList& cbObjList = s().m_cbObjLists[cbValueChange];
         typedef std::set<VerilatedVpioVar*> VpioVarSet;
         VpioVarSet update;  // set of objects to update after callbacks
         for (VpioCbList::iterator it=cbObjList.begin(); it!=cbObjList.end();) {
@@ -509,7 +515,6 @@ public:
 
 //======================================================================
 
-VerilatedVpiImp VerilatedVpiImp::s_s;  // Singleton
 VL_THREAD_LOCAL vluint8_t* VerilatedVpio::t_freeHead = NULL;
 
 //======================================================================
@@ -526,12 +531,16 @@ void VerilatedVpi::callValueCbs() VL_MT_UNSAFE_ONE {
 //======================================================================
 // VerilatedVpiImp implementation
 
+VerilatedVpiImp::~VerilatedVpiImp() {
+    if (m_errorInfop) { delete m_errorInfop; m_errorInfop = NULL; }
+}
+
 VerilatedVpiError* VerilatedVpiImp::error_info() VL_MT_UNSAFE_ONE {
     VerilatedVpiImp::assertOneCheck();
-    if (VL_UNLIKELY(!s_s.m_errorInfop)) {
-        s_s.m_errorInfop = new VerilatedVpiError();
+    if (VL_UNLIKELY(!s().m_errorInfop)) {
+        s().m_errorInfop = new VerilatedVpiError();
     }
-    return s_s.m_errorInfop;
+    return s().m_errorInfop;
 }
 
 //======================================================================
@@ -42,6 +42,7 @@
 # else
 #  define VL_ATTR_PRINTF(fmtArgNum) __attribute__ ((format (printf, fmtArgNum, fmtArgNum+1)))
 # endif
+# define VL_ATTR_FLATTEN __attribute__ ((flatten))
 # define VL_ATTR_PURE __attribute__ ((pure))
 # define VL_ATTR_UNUSED __attribute__ ((unused))
 # define VL_FUNC  __func__
@@ -77,6 +78,9 @@
 #ifndef VL_ATTR_NORETURN
 # define VL_ATTR_NORETURN		///< Function does not ever return
 #endif
+#ifndef VL_ATTR_FLATTEN
+# define VL_ATTR_FLATTEN		///< Inline all calls within this function
+#endif
 #ifndef VL_ATTR_PRINTF
 # define VL_ATTR_PRINTF(fmtArgNum)	///< Function with printf format checking
 #endif
@@ -311,6 +315,48 @@ typedef unsigned long long	vluint64_t;	///< 64-bit unsigned type
 /// Words this number of bits needs (1 bit=1 word)
 #define VL_WORDS_I(nbits) (((nbits)+(VL_WORDSIZE-1))/VL_WORDSIZE)
 
+/// Wide math helpers treat each pair of words as one 64-bit limb, halving
+/// loop trips and carries.  Values are still stored as 32-bit words, so
+/// traces, VPI, DPI and save/restore see no change.  On by default for
+/// 64-bit hosts; compile with -DVL_WIDE_LIMB64=0 for word at a time.
+#ifndef VL_WIDE_LIMB64
+# if defined(__LP64__) || defined(_WIN64)
+#  define VL_WIDE_LIMB64 1
+# else
+#  define VL_WIDE_LIMB64 0
+# endif
+#endif
+
+/// Wide bitwise, compare and reduction helpers hand operands of at least
+/// VL_SIMD_MIN_WORDS words to SSE2/AVX2 kernels picked by cpuid at startup.
+/// Define VL_NO_SIMD for the portable loops only.
+#if !defined(VL_NO_SIMD) && defined(__x86_64__) \
+    && (defined(__clang__) || (__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+# define VL_SIMD 1
+#else
+# define VL_SIMD 0
+#endif
+/// Wide multiply uses 64x64->128 limb products where the compiler has
+/// __int128, and Karatsuba from VL_MUL_KARATSUBA_WORDS words up.  Products
+/// of up to VL_MUL_INLINE_WORDS words stay inline on 32-bit words.
+#if VL_WIDE_LIMB64 && defined(__SIZEOF_INT128__)
+# define VL_MUL_INT128 1
+#else
+# define VL_MUL_INT128 0
+#endif
+#ifndef VL_MUL_KARATSUBA_WORDS
+# define VL_MUL_KARATSUBA_WORDS 64  ///< Smallest product in words to split with Karatsuba
+#endif
+#if VL_MUL_KARATSUBA_WORDS < 8
+# error "VL_MUL_KARATSUBA_WORDS must be at least 8; narrower splits would not shrink"
+#endif
+#ifndef VL_MUL_INLINE_WORDS
+# define VL_MUL_INLINE_WORDS 8  ///< Widest product in words multiplied inline
+#endif
+#ifndef VL_SIMD_MIN_WORDS
+# define VL_SIMD_MIN_WORDS 16  ///< Narrower operands stay inline; keep in sync with V3Expand
+#endif
+
 //=========================================================================
 // Class definition helpers
 
@@ -374,6 +420,10 @@ typedef unsigned long long	vluint64_t;	///< 64-bit unsigned type
 //=========================================================================
 // Threading related OS-specific functions
 
+#ifndef VL_CACHE_LINE_BYTES
+# define VL_CACHE_LINE_BYTES 64  ///< Bytes in a cache line, for padding against false sharing
+#endif
+
 #if VL_THREADED
 # if defined(__i386__) || defined(__x86_64__)
 /// For more efficient busy waiting on SMT CPUs, let the processor know
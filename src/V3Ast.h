@@ -760,7 +760,9 @@ class WidthVP;
 class LinkVP;
 class OrderBlockNU;
 class OrderVarNU;
+class V3Graph;
 class V3GraphVertex;
+class ExecMTask;
 class VSymEnt;
 
 class VNUser {
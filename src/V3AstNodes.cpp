@@ -31,6 +31,8 @@
 #include "V3Ast.h"
 #include "V3File.h"
 #include "V3Global.h"
+#include "V3Graph.h"
+#include "V3PartitionGraph.h"
 
 //======================================================================
 // Special methods
@@ -1159,6 +1161,17 @@ void AstCCall::dump(ostream& str) {
 	funcp()->dump(str);
     }
 }
+void AstMTaskBody::dump(ostream& str) {
+    this->AstNode::dump(str);
+    if (execMTaskp()) str<<" "<<execMTaskp()->name();
+}
+AstExecGraph::AstExecGraph(FileLine* fl)
+    : AstNode(fl) {
+    m_depGraphp = new V3Graph;
+}
+AstExecGraph::~AstExecGraph() {
+    delete m_depGraphp; VL_DANGLING(m_depGraphp);
+}
 void AstCFunc::dump(ostream& str) {
     this->AstNode::dump(str);
     if (slow()) str<<" [SLOW]";
@@ -36,6 +36,14 @@
     Ast ##name * cloneTree(bool cloneNext) { return static_cast<Ast ##name *>(AstNode::cloneTree(cloneNext)); } \
     Ast ##name * clonep() const { return static_cast<Ast ##name *>(AstNode::clonep()); }
 
+// As above, for nodes that need their own destructor
+#define ASTNODE_NODE_FUNCS_NO_DTOR(name) \
+    virtual AstType type() const { return AstType::at ## name; } \
+    virtual AstNode* clone() { return new Ast ##name (*this); } \
+    virtual void accept(AstNVisitor& v) { v.visit(this); } \
+    Ast ##name * cloneTree(bool cloneNext) { return static_cast<Ast ##name *>(AstNode::cloneTree(cloneNext)); } \
+    Ast ##name * clonep() const { return static_cast<Ast ##name *>(AstNode::clonep()); }
+
 //######################################################################
 //=== Ast* : Specific types
 // Netlist interconnect
@@ -2480,6 +2488,7 @@ class AstCaseItem : public AstNode {
     // bodysp Children: Statements
 private:
     bool	m_ignoreOverlap;	// Default created by assertions; ignore overlaps
+    AstBranchPred	m_branchPred;	// Profiled likelihood of this item being taken
 public:
     AstCaseItem(FileLine* fileline, AstNode* condsp, AstNode* bodysp)
 	: AstNode(fileline) {
@@ -2495,6 +2504,8 @@ public:
     bool	isDefault() const { return condsp()==NULL; }
     bool	ignoreOverlap() const { return m_ignoreOverlap; }
     void	ignoreOverlap(bool flag) { m_ignoreOverlap = flag; }
+    AstBranchPred branchPred() const { return m_branchPred; }
+    void	branchPred(AstBranchPred flag) { m_branchPred = flag; }
 };
 
 class AstSFormatF : public AstNode {
@@ -5691,6 +5702,45 @@ public:
 //######################################################################
 // Right below top
 
+class AstMTaskBody : public AstNode {
+    // Statements for one macro-task, when running with --threads
+    // Parents:  EXECGRAPH
+    // Children: statements
+private:
+    ExecMTask*	m_execMTaskp;	// Graph vertex scheduling this body
+public:
+    explicit AstMTaskBody(FileLine* fl)
+	: AstNode(fl), m_execMTaskp(NULL) {}
+    ASTNODE_NODE_FUNCS(MTaskBody)
+    virtual const char* broken() const { BROKEN_RTN(!m_execMTaskp); return NULL; }
+    virtual void dump(ostream& str=cout);
+    AstNode*	stmtsp() 	const { return op1p(); }	// op1 = Statements
+    void addStmtsp(AstNode* nodep) { addOp1p(nodep); }
+    ExecMTask*	execMTaskp() const { return m_execMTaskp; }
+    void	execMTaskp(ExecMTask* execMTaskp) { m_execMTaskp = execMTaskp; }
+};
+
+class AstExecGraph : public AstNode {
+    // Parallel execution of macro-tasks, when running with --threads.
+    // Each vertex of the dependency graph is an ExecMTask, which points
+    // to one of our MTASKBODY children.  The bodies are also children
+    // so visitors may walk them without knowing about the graph.
+    // Parents:  SCOPE, then CFUNC (_eval) after V3Clock
+    // Children: MTASKBODYs
+private:
+    V3Graph*	m_depGraphp;	// ExecMTask vertices, owned by this node
+public:
+    explicit AstExecGraph(FileLine* fl);
+    ASTNODE_NODE_FUNCS_NO_DTOR(ExecGraph)
+    virtual ~AstExecGraph();
+    virtual const char* broken() const { BROKEN_RTN(!m_depGraphp); return NULL; }
+    virtual bool maybePointedTo() const { return true; }
+    AstMTaskBody* mTaskBodiesp() const { return op1p()->castMTaskBody(); }	// op1 = Bodies
+    void addMTaskBodyp(AstMTaskBody* bodyp) { addOp1p(bodyp); }
+    const V3Graph* depGraphp() const { return m_depGraphp; }
+    V3Graph*	mutableDepGraphp() { return m_depGraphp; }
+};
+
 class AstTypeTable : public AstNode {
     // Container for hash of standard data types
     // Children:  NODEDTYPEs
@@ -5731,16 +5781,19 @@ private:
     AstTypeTable* m_typeTablep;	// Reference to top type table, for faster lookup
     AstPackage*	  m_dollarUnitPkgp;
     AstCFunc*     m_evalp;      // The '_eval' function
+    AstExecGraph* m_execGraphp; // Parallel eval graph, when --threads
 public:
     AstNetlist()
 	: AstNode(new FileLine("AstRoot",0))
 	, m_typeTablep(NULL)
 	, m_dollarUnitPkgp(NULL)
-	, m_evalp(NULL) { }
+	, m_evalp(NULL)
+	, m_execGraphp(NULL) { }
     ASTNODE_NODE_FUNCS(Netlist)
     virtual const char* broken() const {
         BROKEN_RTN(m_dollarUnitPkgp && !m_dollarUnitPkgp->brokeExists());
         BROKEN_RTN(m_evalp && !m_evalp->brokeExists());
+        BROKEN_RTN(m_execGraphp && !m_execGraphp->brokeExists());
         return NULL;
     }
     AstNodeModule*	modulesp() 	const { return op1p()->castNodeModule();}	// op1 = List of modules
@@ -5764,6 +5817,8 @@ public:
 	return m_dollarUnitPkgp; }
     AstCFunc* evalp() const { return m_evalp; }
     void evalp(AstCFunc* evalp) { m_evalp = evalp; }
+    AstExecGraph* execGraphp() const { return m_execGraphp; }
+    void execGraphp(AstExecGraph* graphp) { m_execGraphp = graphp; }
 };
 
 //######################################################################
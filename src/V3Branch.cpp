@@ -92,7 +92,9 @@ private:
 	    int elseUnlikely = m_unlikely;
 	    // Compute
 	    int likeness = ifLikely - ifUnlikely - (elseLikely - elseUnlikely);
-	    if (likeness>0) {
+	    if (nodep->branchPred() != AstBranchPred::BP_UNKNOWN) {
+		// Keep hints from assertions or --prof-branches-data
+	    } else if (likeness>0) {
 		nodep->branchPred(AstBranchPred::BP_LIKELY);
 	    } else if (likeness<0) {
 		nodep->branchPred(AstBranchPred::BP_UNLIKELY);
@@ -0,0 +1,296 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//*************************************************************************
+// DESCRIPTION: Verilator: Branch profiling and profile-guided branch layout
+//
+// Code available from: http://www.veripool.org/verilator
+//
+//*************************************************************************
+//
+// Copyright 2003-2018 by Wilson Snyder.  This program is free software; you can
+// redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+//
+// Verilator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+//*************************************************************************
+// V3BranchProf's Transformations:
+//
+//	Runs before V3Case, while the design's IF and CASE statements are
+//	as written.  Each is a branch point, keyed by its scope and source
+//	location so a later Verilator run of the same design finds it.
+//
+//	With --prof-branches-data:
+//	    IF: mark VL_LIKELY or VL_UNLIKELY when the measured then/else
+//		counts are biased enough.
+//	    CASE: mark each item likely or unlikely the same way, for
+//		V3Case to put on the item's IF.  If the items are
+//		exclusive constants, sort them most taken first, so the
+//		IF chain V3Case builds tests the common items first.
+//	With --prof-branches:
+//	    Add a counter to the start of every arm (a missing ELSE
+//	    becomes an arm holding just the counter).
+//
+//*************************************************************************
+
+#include "config_build.h"
+#include "verilatedos.h"
+#include <cstdio>
+#include <cstdarg>
+#include <unistd.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <memory>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "V3Global.h"
+#include "V3BranchProf.h"
+#include "V3File.h"
+#include "V3Stats.h"
+#include "V3Ast.h"
+
+//######################################################################
+// Measured counts from a --prof-branches run
+
+class BranchProfData {
+public:
+    // TYPES
+    typedef std::vector<vluint64_t> Counts;
+private:
+    typedef std::map<string, Counts> KeyCounts;
+    // STATE
+    KeyCounts	m_counts;	// Counts of each arm of each branch point
+public:
+    // METHODS
+    void load(const string& filename) {
+	const vl_unique_ptr<std::ifstream> ifp (V3File::new_ifstream(filename));
+	if (ifp->fail()) { v3fatal("Can't read --prof-branches-data file: "<<filename); return; }
+	string line;
+	while (std::getline(*ifp, line)) {
+	    // VLPROF branch <key> <count of arm 0> <count of arm 1> ...
+	    std::istringstream is (line);
+	    string word, key;
+	    is >> word;
+	    if (word != "VLPROF") continue;
+	    is >> word >> key;
+	    if (is.fail() || word != "branch") {
+		v3fatal("Malformed line in --prof-branches-data file: "<<filename<<": "<<line);
+		return;
+	    }
+	    Counts counts;
+	    vluint64_t count;
+	    while (is >> count) counts.push_back(count);
+	    // Models run several times, or several models, add up
+	    Counts& sums = m_counts[key];
+	    if (sums.size() < counts.size()) sums.resize(counts.size(), 0);
+	    for (size_t arm = 0; arm < counts.size(); ++arm) sums[arm] += counts[arm];
+	}
+    }
+    const Counts* find(const string& key) const {
+	KeyCounts::const_iterator it = m_counts.find(key);
+	if (it == m_counts.end()) return NULL;
+	return &(it->second);
+    }
+};
+
+//######################################################################
+
+class BranchProfVisitor : public AstNVisitor {
+private:
+    // TYPES
+    enum MiscConsts {
+	BRANCH_MIN_SAMPLES = 16,	// Times a point must be reached to trust its counts
+	BRANCH_BIAS_PCT = 90		// Percent of the time an arm is taken to be likely
+    };
+    struct CaseItemCmp {
+	// Most taken first; original position breaks ties, so the sort is stable
+	const std::vector<vluint64_t>& m_counts;
+	explicit CaseItemCmp(const std::vector<vluint64_t>& counts) : m_counts(counts) {}
+	inline bool operator() (int lhs, int rhs) const {
+	    if (m_counts[lhs] != m_counts[rhs]) return m_counts[lhs] > m_counts[rhs];
+	    return lhs < rhs;
+	}
+    };
+
+    // STATE
+    AstScope*		m_scopep;	// Current scope
+    BranchProfData	m_profile;	// Counts from --prof-branches-data
+    bool		m_profiled;	// Have m_profile
+    std::map<string, int> m_keyCounts;	// Points found of each key, to make them unique
+    V3Double0		m_statHints;	// Statistic tracking
+    V3Double0		m_statReorders;	// Statistic tracking
+    V3Double0		m_statPoints;	// Statistic tracking
+
+    // METHODS
+    static int debug() {
+	static int level = -1;
+	if (VL_UNLIKELY(level < 0)) level = v3Global.opt.debugSrcLevel(__FILE__);
+	return level;
+    }
+    static string hashKey(const string& text) {
+	// FNV-1a, so keys are short and need no quoting in C++ or the data file
+	vluint64_t hash = VL_ULL(14695981039346656037);
+	for (string::const_iterator it = text.begin(); it != text.end(); ++it) {
+	    hash = (hash ^ static_cast<unsigned char>(*it)) * VL_ULL(1099511628211);
+	}
+	std::ostringstream os;
+	os<<std::hex<<hash;
+	return os.str();
+    }
+    string newKey(AstNode* nodep) {
+	// Identifies the point across Verilator runs of the same design;
+	// an ordinal disambiguates points on the same line
+	string key = (m_scopep->name()+" "+nodep->fileline()->filename()
+		      +":"+cvtToStr(nodep->fileline()->lineno())+" "+nodep->typeName());
+	int ordinal = m_keyCounts[key]++;
+	return hashKey(key+" "+cvtToStr(ordinal));
+    }
+    static AstBranchPred armPred(vluint64_t count, vluint64_t total) {
+	if (total < BRANCH_MIN_SAMPLES) return AstBranchPred::BP_UNKNOWN;
+	if (count*100 >= total*BRANCH_BIAS_PCT) return AstBranchPred::BP_LIKELY;
+	if (count*100 <= total*(100-BRANCH_BIAS_PCT)) return AstBranchPred::BP_UNLIKELY;
+	return AstBranchPred::BP_UNKNOWN;
+    }
+    const BranchProfData::Counts* findCounts(const string& key, size_t arms) {
+	if (!m_profiled) return NULL;
+	const BranchProfData::Counts* countsp = m_profile.find(key);
+	// A point that changed arms is a different point
+	if (!countsp || countsp->size() != arms) return NULL;
+	return countsp;
+    }
+    static AstNode* newCount(FileLine* fl, int counter) {
+	return new AstCStmt(fl, "vlSymsp->__Vm_branchProf.taken("+cvtToStr(counter)+");\n");
+    }
+    static bool itemsExclusive(AstCase* nodep) {
+	// Each item matches only its own distinct constants, so order doesn't matter
+	std::set<string> values;
+	for (AstCaseItem* itemp = nodep->itemsp(); itemp; itemp=itemp->nextp()->castCaseItem()) {
+	    for (AstNode* condp = itemp->condsp(); condp; condp=condp->nextp()) {
+		AstConst* constp = condp->castConst();
+		if (!constp || constp->num().isFourState()) return false;
+		if (!values.insert(constp->num().ascii(false)).second) return false;
+	    }
+	}
+	return true;
+    }
+    void sortItems(AstCase* nodep, const BranchProfData::Counts& counts) {
+	std::vector<AstCaseItem*> items;
+	std::vector<int> order;
+	for (AstCaseItem* itemp = nodep->itemsp(); itemp; itemp=itemp->nextp()->castCaseItem()) {
+	    if (!itemp->isDefault()) order.push_back(items.size());
+	    items.push_back(itemp);
+	}
+	std::stable_sort(order.begin(), order.end(), CaseItemCmp(counts));
+	// Defaults match only when nothing else does; keep them last
+	for (size_t i = 0; i < items.size(); ++i) {
+	    if (items[i]->isDefault()) order.push_back(i);
+	}
+	bool changed = false;
+	for (size_t i = 0; i < order.size(); ++i) {
+	    if (order[i] != static_cast<int>(i)) changed = true;
+	}
+	if (!changed) return;
+	UINFO(4,"  Reorder case items: "<<nodep<<endl);
+	for (size_t i = 0; i < items.size(); ++i) items[i]->unlinkFrBack();
+	for (size_t i = 0; i < order.size(); ++i) nodep->addItemsp(items[order[i]]);
+	++m_statReorders;
+    }
+
+    // VISITORS
+    virtual void visit(AstScope* nodep) {
+	m_scopep = nodep;
+	nodep->iterateChildren(*this);
+	m_scopep = NULL;
+    }
+    virtual void visit(AstIf* nodep) {
+	if (!m_scopep) { nodep->iterateChildren(*this); return; }
+	string key = newKey(nodep);
+	nodep->iterateChildren(*this);
+	if (const BranchProfData::Counts* countsp = findCounts(key, 2)) {
+	    AstBranchPred pred = armPred((*countsp)[0], (*countsp)[0] + (*countsp)[1]);
+	    if (pred != AstBranchPred::BP_UNKNOWN) {
+		UINFO(4,"  Profiled "<<pred.ascii()<<": "<<nodep<<endl);
+		nodep->branchPred(pred);
+		++m_statHints;
+	    }
+	}
+	if (v3Global.opt.profBranches()) {
+	    int counter = v3Global.addBranchProf(key, 2);
+	    AstNode* thenp = newCount(nodep->fileline(), counter);
+	    if (nodep->ifsp()) nodep->ifsp()->addHereThisAsNext(thenp);
+	    else nodep->addIfsp(thenp);
+	    AstNode* elsep = newCount(nodep->fileline(), counter+1);
+	    if (nodep->elsesp()) nodep->elsesp()->addHereThisAsNext(elsep);
+	    else nodep->addElsesp(elsep);
+	    ++m_statPoints;
+	}
+    }
+    virtual void visit(AstCase* nodep) {
+	if (!m_scopep) { nodep->iterateChildren(*this); return; }
+	string key = newKey(nodep);
+	nodep->iterateChildren(*this);
+	size_t arms = 0;
+	for (AstCaseItem* itemp = nodep->itemsp(); itemp; itemp=itemp->nextp()->castCaseItem()) {
+	    ++arms;
+	}
+	if (v3Global.opt.profBranches()) {
+	    // Before any reordering, so counters follow the items as written
+	    int counter = v3Global.addBranchProf(key, arms);
+	    for (AstCaseItem* itemp = nodep->itemsp(); itemp; itemp=itemp->nextp()->castCaseItem()) {
+		AstNode* countp = newCount(itemp->fileline(), counter++);
+		if (itemp->bodysp()) itemp->bodysp()->addHereThisAsNext(countp);
+		else itemp->addBodysp(countp);
+	    }
+	    ++m_statPoints;
+	}
+	if (const BranchProfData::Counts* countsp = findCounts(key, arms)) {
+	    vluint64_t total = 0;
+	    for (size_t arm = 0; arm < arms; ++arm) total += (*countsp)[arm];
+	    size_t arm = 0;
+	    for (AstCaseItem* itemp = nodep->itemsp(); itemp; itemp=itemp->nextp()->castCaseItem()) {
+		AstBranchPred pred = armPred((*countsp)[arm++], total);
+		if (pred != AstBranchPred::BP_UNKNOWN) {
+		    itemp->branchPred(pred);
+		    ++m_statHints;
+		}
+	    }
+	    if (total >= BRANCH_MIN_SAMPLES && itemsExclusive(nodep)) {
+		sortItems(nodep, *countsp);
+	    }
+	}
+    }
+    virtual void visit(AstNode* nodep) {
+	nodep->iterateChildren(*this);
+    }
+
+public:
+    // CONSTUCTORS
+    explicit BranchProfVisitor(AstNetlist* nodep) {
+	m_scopep = NULL;
+	m_profiled = (v3Global.opt.profBranchesData() != "");
+	if (m_profiled) m_profile.load(v3Global.opt.profBranchesData());
+	nodep->accept(*this);
+    }
+    virtual ~BranchProfVisitor() {
+	V3Stats::addStat("Optimizations, Branch hints from profile", m_statHints);
+	V3Stats::addStat("Optimizations, Cases reordered by profile", m_statReorders);
+	V3Stats::addStat("Branch profile, Points instrumented", m_statPoints);
+    }
+};
+
+//######################################################################
+// BranchProf class functions
+
+void V3BranchProf::branchProfAll(AstNetlist* nodep) {
+    UINFO(2,__FUNCTION__<<": "<<endl);
+    {
+	BranchProfVisitor visitor (nodep);
+    }  // Destruct before checking
+    V3Global::dumpCheckGlobalTree("branchprof", 0, v3Global.opt.dumpTreeLevel(__FILE__) >= 3);
+}
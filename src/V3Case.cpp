@@ -381,8 +381,8 @@ private:
 	// Now build the IF statement tree
 	// The tree can be quite huge.  Pull ever group of 8 out, and make a OR tree.
 	// This reduces the depth for the bottom elements, at the cost of some of the top elements.
-	// If we ever have profiling data, we should pull out the most common item from here and
-	// instead make it the first IF branch.
+	// With --prof-branches-data, V3BranchProf has already sorted exclusive items
+	// most common first, and marked how likely each item is.
 	int depth = 0;
 	AstNode* grouprootp = NULL;
 	AstIf* groupnextp = NULL;
@@ -414,6 +414,7 @@ private:
 		    itemexprp = new AstConst(itemp->fileline(), AstConst::LogicTrue());
 		}
 		AstIf* newp = new AstIf(itemp->fileline(), itemexprp, istmtsp, NULL);
+		newp->branchPred(itemp->branchPred());
 		if (itemnextp) itemnextp->addElsesp(newp);
 		else groupnextp->addIfsp(newp);  // First in a new group
 		itemnextp = newp;
@@ -450,12 +451,20 @@ private:
 	return false;
     }
 
+    bool hasLikelyItem(AstCase* nodep) {
+	// Profiled common item, which an IF chain can test first
+	for (AstCaseItem* itemp = nodep->itemsp(); itemp; itemp=itemp->nextp()->castCaseItem()) {
+	    if (itemp->branchPred() == AstBranchPred::BP_LIKELY) return true;
+	}
+	return false;
+    }
+
     // VISITORS
     virtual void visit(AstCase* nodep) {
 	V3Case::caseLint(nodep);
 	nodep->iterateChildren(*this);
 	if (debug()>=9) nodep->dumpTree(cout," case_old: ");
-	if (isCaseTreeFast(nodep) && v3Global.opt.oCase()) {
+	if (isCaseTreeFast(nodep) && v3Global.opt.oCase() && !hasLikelyItem(nodep)) {
 	    // It's a simple priority encoder or complete statement
 	    // we can make a tree of statements to avoid extra comparisons
 	    ++m_statCaseFast;
@@ -28,6 +28,11 @@
 //	    module *below*, and it isn't a input to this module,
 //	    we need to indicate a new clock has been created.
 //
+// With -Ow (default on), a variable whose every write is an assignment:
+//	After each assignment, set a dirty bit for the variable
+//	_change_request_dirty compares only variables with dirty bits set,
+//	skipping whole words of clean bits, so cost follows what changed.
+//
 //*************************************************************************
 
 #include "config_build.h"
@@ -36,12 +41,67 @@
 #include <cstdarg>
 #include <unistd.h>
 #include <algorithm>
+#include <map>
+#include <memory>
 #include <set>
+#include <vector>
 
 #include "V3Global.h"
 #include "V3Ast.h"
 #include "V3Changed.h"
 #include "V3EmitCBase.h"
+#include "V3Stats.h"
+
+//######################################################################
+// Find how each variable is written, for dirty flags
+
+class ChangedWritesVisitor : public AstNVisitor {
+public:
+    typedef std::vector<AstNodeAssign*> AssignVec;
+private:
+    // STATE
+    std::map<AstVarScope*, AssignVec> m_assigns;	// Assignments writing each variable
+    std::set<AstVarScope*> m_otherWrites;	// Variables written other than by assignment
+    AstNodeAssign*	m_assignp;	// Assignment whose lhs we're under
+
+    // VISITORS
+    virtual void visit(AstNodeAssign* nodep) {
+	nodep->rhsp()->iterateAndNext(*this);
+	m_assignp = nodep;
+	nodep->lhsp()->iterateAndNext(*this);
+	m_assignp = NULL;
+    }
+    virtual void visit(AstVarRef* nodep) {
+	if (!nodep->lvalue()) return;
+	AstVarScope* vscp = nodep->varScopep();
+	if (!vscp || !vscp->isCircular()) return;
+	if (m_assignp) {
+	    AssignVec& assigns = m_assigns[vscp];
+	    if (assigns.empty() || assigns.back() != m_assignp) assigns.push_back(m_assignp);
+	} else {
+	    m_otherWrites.insert(vscp);
+	}
+    }
+    virtual void visit(AstNode* nodep) {
+	nodep->iterateChildren(*this);
+    }
+public:
+    // CONSTUCTORS
+    explicit ChangedWritesVisitor(AstNetlist* nodep) {
+	m_assignp = NULL;
+	nodep->accept(*this);
+    }
+    virtual ~ChangedWritesVisitor() {}
+    // METHODS
+    // Can the variable's changes be tracked by its writers
+    bool dirtyable(AstVarScope* vscp) const {
+	AstVar* varp = vscp->varp();
+	// Written from C++ outside of eval
+	if (varp->isPrimaryIO() || varp->isSigPublic()) return false;
+	return m_otherWrites.find(vscp) == m_otherWrites.end();
+    }
+    const AssignVec& assigns(AstVarScope* vscp) { return m_assigns[vscp]; }
+};
 
 //######################################################################
 
@@ -54,6 +114,15 @@ public:
     AstCFunc*		m_tlChgFuncp;	// Top level change function we're building
     int			m_numStmts;     // Number of statements added to m_chgFuncp
     int 		m_funcNum;	// Number of change functions emitted
+    // Dirty flags
+    ChangedWritesVisitor* m_writesp;	// Writes of each variable, or NULL if no dirty flags
+    AstCFunc*		m_dirtyFuncp;	// Dirty flag change function we're building
+    AstVarScope*	m_dirtyReqVscp;	// Return value of m_dirtyFuncp
+    AstVarScope*	m_dirtyVscp;	// Dirty flags word being filled
+    AstIf*		m_dirtyIfp;	// Check of m_dirtyVscp in m_dirtyFuncp
+    int			m_dirtyBits;	// Bits used in m_dirtyVscp
+    int			m_dirtyWords;	// Number of dirty flag words
+    int			m_dirtyVars;	// Number of variables with dirty flags
 
     ChangedState() {
 	m_topModp = NULL;
@@ -62,8 +131,93 @@ public:
 	m_tlChgFuncp = NULL;
 	m_numStmts = 0;
 	m_funcNum = 0;
+	m_writesp = NULL;
+	m_dirtyFuncp = NULL;
+	m_dirtyReqVscp = NULL;
+	m_dirtyVscp = NULL;
+	m_dirtyIfp = NULL;
+	m_dirtyBits = 0;
+	m_dirtyWords = 0;
+	m_dirtyVars = 0;
+    }
+    ~ChangedState() {
+	V3Stats::addStat("Optimizations, Changed dirty flags", m_dirtyVars);
+    }
+
+    AstVarScope* newTopVarScope(FileLine* fl, const string& name, int width) {
+	AstVar* varp = new AstVar (fl, AstVarType::MODULETEMP, name, VFlagBitPacked(), width);
+	m_topModp->addStmtp(varp);
+	AstVarScope* vscp = new AstVarScope(fl, m_scopetopp, varp);
+	m_scopetopp->addVarp(vscp);
+	return vscp;
+    }
+    // Dirty flag words are written by every writer of their variables, so
+    // with threads, where writers may run concurrently, each has its own
+    int dirtyWordBits() const { return (v3Global.opt.threads() > 1) ? 1 : 32; }
+
+    // Allocate the next dirty bit, return the If checking it in m_dirtyFuncp
+    AstIf* newDirtyBit(AstVarScope* vscp) {
+	FileLine* fl = m_scopetopp->fileline();
+	if (!m_dirtyFuncp) {
+	    m_dirtyFuncp = new AstCFunc(fl, "_change_request_dirty", m_scopetopp, "QData");
+	    m_dirtyFuncp->argTypes(EmitCBaseVisitor::symClassVar());
+	    m_dirtyFuncp->symProlog(true);
+	    m_dirtyFuncp->declPrivate(true);
+	    m_scopetopp->addActivep(m_dirtyFuncp);
+	    m_dirtyReqVscp = newTopVarScope(fl, "__Vchgdirty_req", 1);
+	    m_dirtyFuncp->addStmtsp(new AstAssign(fl, new AstVarRef(fl, m_dirtyReqVscp, true),
+						  new AstConst(fl, AstConst::LogicFalse())));
+	    // Or'ed into the top level change function, as maybeCreateChgFuncp does
+	    AstCCall* callp = new AstCCall(fl, m_dirtyFuncp);
+	    callp->argTypes("vlSymsp");
+	    AstCReturn* returnp = m_tlChgFuncp->stmtsp() ? m_tlChgFuncp->stmtsp()->castCReturn() : NULL;
+	    if (returnp) {
+		returnp->replaceWith(new AstCReturn(fl, new AstLogOr(fl, callp,
+								     returnp->lhsp()->unlinkFrBack())));
+		returnp->deleteTree(); VL_DANGLING(returnp);
+	    } else {
+		m_tlChgFuncp->addStmtsp(new AstChangeDet(fl, callp, NULL, false));
+	    }
+	}
+	if (!m_dirtyVscp || m_dirtyBits >= dirtyWordBits()) {
+	    // Check a word's bits only if any is set, then clear them all
+	    m_dirtyVscp = newTopVarScope(fl, "__Vchgdirty"+cvtToStr(m_dirtyWords++), dirtyWordBits());
+	    m_dirtyBits = 0;
+	    m_dirtyIfp = new AstIf(fl, new AstVarRef(fl, m_dirtyVscp, false), NULL, NULL);
+	    m_dirtyFuncp->addStmtsp(m_dirtyIfp);
+	    m_dirtyIfp->addIfsp(new AstAssign(fl, new AstVarRef(fl, m_dirtyVscp, true),
+					      new AstConst(fl, V3Number(fl, dirtyWordBits(), 0))));
+	}
+	int bit = m_dirtyBits++;
+	++m_dirtyVars;
+	// Each writer sets the bit
+	const ChangedWritesVisitor::AssignVec& assigns = m_writesp->assigns(vscp);
+	for (ChangedWritesVisitor::AssignVec::const_iterator it = assigns.begin();
+	     it != assigns.end(); ++it) {
+	    AstNodeAssign* assp = *it;
+	    FileLine* afl = assp->fileline();
+	    AstNode* setp;
+	    if (dirtyWordBits() == 1) {
+		setp = new AstConst(afl, AstConst::LogicTrue());
+	    } else {
+		setp = new AstOr(afl, new AstVarRef(afl, m_dirtyVscp, false),
+				 new AstConst(afl, V3Number(afl, dirtyWordBits(), 1UL << bit)));
+	    }
+	    assp->addNextHere(new AstAssign(afl, new AstVarRef(afl, m_dirtyVscp, true), setp));
+	}
+	// Checks go before the word's clear
+	AstIf* ifp = new AstIf(fl, (dirtyWordBits() == 1
+				    ? static_cast<AstNode*>(new AstConst(fl, AstConst::LogicTrue()))
+				    : new AstSel(fl, new AstVarRef(fl, m_dirtyVscp, false), bit, 1)),
+			       NULL, NULL);
+	m_dirtyIfp->ifsp()->addHereThisAsNext(ifp);
+	return ifp;
+    }
+    void finishDirty() {
+	if (!m_dirtyFuncp) return;
+	FileLine* fl = m_dirtyFuncp->fileline();
+	m_dirtyFuncp->addStmtsp(new AstCReturn(fl, new AstVarRef(fl, m_dirtyReqVscp, false)));
     }
-    ~ChangedState() {}
 
     void maybeCreateChgFuncp() {
 	// Don't create an extra function call if splitting is disabled
@@ -114,6 +268,11 @@ private:
     AstNode*		m_newLvEqnp;	// New var's equation to read value
     AstNode*		m_newRvEqnp;	// New var's equation to set value
     uint32_t		m_detects;	// # detects created
+    AstIf*		m_dirtyIfp;	// Dirty bit check to add to, or NULL if not dirty flagged
+    AstNode*		m_dirtyCondp;	// Change of any element, when dirty flagged
+    int			m_profId;	// --prof-settle counter number, or -1 if none yet
+    AstCFunc*		m_profFuncp;	// --prof-settle function of elements in m_profCondp
+    AstNode*		m_profCondp;	// --prof-settle change of those elements
 
     // CONSTANTS
     enum MiscConsts {
@@ -121,6 +280,31 @@ private:
 	// Ok to increase this, but may result in much slower model
     };
 
+    AstNode* newNeq() {
+	// Element differs from its last value
+	if (m_varEqnp->isDouble()) {
+	    return new AstNeqD(m_vscp->fileline(), m_varEqnp->cloneTree(true),
+			       m_newRvEqnp->cloneTree(true));
+	} else {
+	    return new AstNeq(m_vscp->fileline(), m_varEqnp->cloneTree(true),
+			      m_newRvEqnp->cloneTree(true));
+	}
+    }
+    AstNode* newProfCount() {
+	// For --prof-settle, count a change of the variable
+	if (m_profId < 0) {
+	    m_profId = v3Global.addSettleProfName(AstNode::prettyName(m_vscp->scopep()->name()
+								      +"."+m_vscp->varp()->name()));
+	}
+	return new AstCStmt(m_vscp->fileline(),
+			    "vlSymsp->__Vm_settleProf.changed("+cvtToStr(m_profId)+");\n");
+    }
+    void flushProfCount() {
+	// Count once per variable, though its elements' detects may be split across functions
+	if (!m_profCondp) return;
+	m_profFuncp->addStmtsp(new AstIf(m_vscp->fileline(), m_profCondp, newProfCount(), NULL));
+	m_profCondp = NULL;
+    }
     void newChangeDet() {
 	if (++m_detects > DETECTARRAY_MAX_INDEXES) {
 	    m_vscp->v3warn(E_DETECTARRAY, "Unsupported: Can't detect more than "<<cvtToStr(DETECTARRAY_MAX_INDEXES)
@@ -129,12 +313,28 @@ private:
 			   <<"... Could recompile with DETECTARRAY_MAX_INDEXES increased"<<endl);
 	    return;
 	}
+	if (m_dirtyIfp) {
+	    // Compare and copy only when written.  The copy must be here,
+	    // not in the finals, as a written value may otherwise change back unseen.
+	    AstNode* neqp = newNeq();
+	    m_dirtyCondp = m_dirtyCondp ? new AstLogOr(m_vscp->fileline(), m_dirtyCondp, neqp) : neqp;
+	    m_dirtyIfp->addIfsp(new AstAssign (m_vscp->fileline(),
+					       m_newLvEqnp->cloneTree(true),
+					       m_varEqnp->cloneTree(true)));
+	    return;
+	}
 	m_statep->maybeCreateChgFuncp();
 
 	AstChangeDet* changep = new AstChangeDet (m_vscp->fileline(),
 						  m_varEqnp->cloneTree(true),
 						  m_newRvEqnp->cloneTree(true), false);
 	m_statep->m_chgFuncp->addStmtsp(changep);
+	if (v3Global.opt.profSettle()) {
+	    // Compared in the body, before the copies in the finals
+	    if (m_profFuncp != m_statep->m_chgFuncp) flushProfCount();
+	    m_profFuncp = m_statep->m_chgFuncp;
+	    m_profCondp = m_profCondp ? new AstLogOr(m_vscp->fileline(), m_profCondp, newNeq()) : newNeq();
+	}
 	AstAssign* initp = new AstAssign (m_vscp->fileline(),
 					  m_newLvEqnp->cloneTree(true),
 					  m_varEqnp->cloneTree(true));
@@ -193,6 +393,11 @@ public:
 	m_statep = statep;
 	m_vscp = vscp;
 	m_detects = 0;
+	m_dirtyIfp = NULL;
+	m_dirtyCondp = NULL;
+	m_profId = -1;
+	m_profFuncp = NULL;
+	m_profCondp = NULL;
 	{
 	    AstVar* varp = m_vscp->varp();
 	    string newvarname = "__Vchglast__"+m_vscp->scopep()->nameDotless()+"__"+varp->shortName();
@@ -209,7 +414,21 @@ public:
 	    m_newLvEqnp = new AstVarRef(m_vscp->fileline(), m_newvscp, true);
 	    m_newRvEqnp = new AstVarRef(m_vscp->fileline(), m_newvscp, false);
 	}
+	if (m_statep->m_writesp && m_statep->m_writesp->dirtyable(vscp)) {
+	    m_dirtyIfp = m_statep->newDirtyBit(vscp);
+	}
 	vscp->dtypep()->skipRefp()->accept(*this);
+	flushProfCount();
+	if (m_dirtyCondp) {
+	    // The comparison goes before the copies added above
+	    FileLine* fl = m_vscp->fileline();
+	    AstNode* changep = new AstAssign(fl, new AstVarRef(fl, m_statep->m_dirtyReqVscp, true),
+					     new AstConst(fl, AstConst::LogicTrue()));
+	    changep->addNext(new AstCStmt(fl, "VL_DEBUG_IF( VL_DBG_MSGF(\"        CHANGE: "
+					  +fl->ascii()+": "+m_vscp->varp()->prettyName()+"\\n\"); );\n"));
+	    if (v3Global.opt.profSettle()) changep->addNext(newProfCount());
+	    m_dirtyIfp->ifsp()->addHereThisAsNext(new AstIf(fl, m_dirtyCondp, changep, NULL));
+	}
 	m_varEqnp->deleteTree();
 	m_newLvEqnp->deleteTree();
 	m_newRvEqnp->deleteTree();
@@ -272,6 +491,7 @@ private:
 	m_statep->m_chgFuncp->addStmtsp(new AstChangeDet(nodep->fileline(), NULL, NULL, false));
 
 	nodep->iterateChildren(*this);
+	m_statep->finishDirty();
     }
     virtual void visit(AstVarScope* nodep) {
 	if (nodep->isCircular()) {
@@ -306,6 +526,11 @@ void V3Changed::changedAll(AstNetlist* nodep) {
     UINFO(2,__FUNCTION__<<": "<<endl);
     {
         ChangedState state;
+	vl_unique_ptr<ChangedWritesVisitor> writesp;
+	if (v3Global.opt.oChangeDirty()) {
+	    writesp.reset(new ChangedWritesVisitor(nodep));
+	    state.m_writesp = writesp.get();
+	}
         ChangedVisitor visitor (nodep, &state);
     }  // Destruct before checking
     V3Global::dumpCheckGlobalTree("changed", 0, v3Global.opt.dumpTreeLevel(__FILE__) >= 3);
@@ -110,10 +110,13 @@ public:
 
 class GaterVarVertex : public GaterVertex {
     AstVarScope*	m_nodep;
+    uint32_t		m_cost;		// Cost of statements assigning this variable
 public:
     AstVarScope* nodep() const { return m_nodep; }
+    uint32_t cost() const { return m_cost; }
+    void addCost(uint32_t cost) { m_cost += cost; }
     GaterVarVertex(V3Graph* graphp, AstVarScope* nodep)
-	: GaterVertex(graphp), m_nodep(nodep) { }
+	: GaterVertex(graphp), m_nodep(nodep), m_cost(0) { }
     virtual ~GaterVarVertex() {}
     virtual int typeNum() const { return __LINE__; }  // C++ typeof() equivelent
     virtual string name() const { return nodep()->name(); }
@@ -187,6 +190,28 @@ int GaterVertex::sortCmp(const V3GraphVertex* rhsp) const {
     return 0;
 }
 
+//######################################################################
+// Cost estimation of statements and gating terms
+
+class GaterCostVisitor : public GaterBaseVisitor {
+private:
+    // STATE
+    uint32_t	m_cost;		// Running cost
+    // VISITORS
+    virtual void visit(AstNode* nodep) {
+	m_cost += 1 + nodep->instrCount();
+	nodep->iterateChildren(*this);
+    }
+public:
+    // CONSTUCTORS
+    explicit GaterCostVisitor(AstNode* nodep) {
+	m_cost = 0;
+	nodep->accept(*this);
+    }
+    virtual ~GaterCostVisitor() {}
+    uint32_t cost() const { return m_cost; }
+};
+
 //######################################################################
 // Check for non-simple gating equations
 
@@ -346,13 +371,15 @@ class GaterVisitor : public GaterBaseVisitor {
 
     enum MiscConsts {
 	IF_DEPTH_MAX = 4,	// IFs deep we bother to analyze
-	DOMAINS_MAX = 32	// Clock domains before avoiding O(N^2) blowup
+	DOMAINS_MAX = 32,	// Clock domains before avoiding O(N^2) blowup
+	GATER_OVERHEAD = 8	// Cost of testing and calling one more clock domain
     };
 
     // MEMBERS
     string	m_nonopt;		// Reason block is not optimizable
     V3Double0	m_statGaters;		// Statistic tracking
     V3Double0	m_statBits;		// Statistic tracking
+    V3Double0	m_statCostly;		// Statistic tracking
     bool	m_directlyUnderAlw;	// Immediately under Always or If
     int		m_ifDepth;		// Depth of IF statements
     int		m_numIfs;		// Number of IF statements
@@ -363,6 +390,7 @@ class GaterVisitor : public GaterBaseVisitor {
     uint32_t		m_aboveTrue;	// Vertex above this point is true branch
     AstVarScope*	m_stmtVscp;	// Current statement had variable assigned
     bool		m_stmtInPli;	// Current statement has PLI
+    uint32_t		m_stmtCost;	// Cost of current assignment statement
 
     // METHODS
     void nonOptimizable(AstNode* nodep, const char* reasonp) {
@@ -630,19 +658,43 @@ class GaterVisitor : public GaterBaseVisitor {
 	return nodep;
     }
 
+    bool gaterPays(uint32_t movedCost, AstNode* exprp) {
+	// The gater adds a domain test with its gating term on every
+	// clock edge, and saves the moved statements when the term is
+	// false.  Lacking activity data, assume that is half the edges.
+	uint32_t overhead = GaterCostVisitor(exprp).cost() + GATER_OVERHEAD;
+	UINFO(6, "  Gater cost: moved="<<movedCost<<" overhead="<<overhead<<endl);
+	return movedCost >= 2*overhead;
+    }
+
     void newAlwaysTrees(AstAlways* nodep) {
+	// Cost of the statements each color would move
+	map<uint32_t,uint32_t> colorCosts;
+	for (V3GraphVertex* vertexp = m_graph.verticesBeginp(); vertexp; vertexp=vertexp->verticesNextp()) {
+	    if (GaterVarVertex* vVxp = dynamic_cast<GaterVarVertex*>(vertexp)) {
+		colorCosts[vVxp->color()] += vVxp->cost();
+	    }
+	}
 	// Across all variables we're moving
 	uint32_t lastColor = 0;
 	AstNode* lastExprp = NULL;
+	bool lastSkip = false;
 	for (V3GraphVertex* vertexp = m_graph.verticesBeginp(); vertexp; vertexp=vertexp->verticesNextp()) {
 	    if (GaterVarVertex* vVxp = dynamic_cast<GaterVarVertex*>(vertexp)) {
-		if (!lastExprp || lastColor != vVxp->color()) {
+		if ((!lastExprp && !lastSkip) || lastColor != vVxp->color()) {
 		    lastColor = vVxp->color();
 		    // Create the block we've just finished
 		    if (lastExprp) newAlwaysTree(nodep, lastExprp); // Duplicate below
 		    // New expression for this color
 		    lastExprp = newExprFromGraph(vVxp);
+		    lastSkip = !gaterPays(colorCosts[lastColor], lastExprp);
+		    if (lastSkip) {
+			UINFO(5, "  Gater not worth its cost: "<<vVxp<<endl);
+			++m_statCostly;
+			lastExprp->deleteTree(); lastExprp = NULL;
+		    }
 		}
+		if (lastSkip) continue;  // Variable stays in the original always
 		// Mark variable to move
 		if (vVxp->nodep()->user2p()) vVxp->nodep()->v3fatalSrc("One variable got marked under two gaters");
 		vVxp->nodep()->user2p(lastExprp);
@@ -773,6 +825,7 @@ class GaterVisitor : public GaterBaseVisitor {
 		vertexp = new GaterVarVertex(&m_graph, vscp);
 		vscp->user1p(vertexp);
 	    }
+	    vertexp->addCost(m_stmtCost);
 	    new GaterEdge(&m_graph, m_aboveVertexp, vertexp, m_aboveTrue);
 	    if (m_stmtInPli) {
 		new GaterEdge(&m_graph, m_pliVertexp, vertexp, VU_PLI);
@@ -822,7 +875,10 @@ class GaterVisitor : public GaterBaseVisitor {
 
     virtual void visit(AstAssignDly* nodep) {
 	// iterateChildrenAlw will detect this is a statement for us
+	uint32_t laststmtcost = m_stmtCost;
+	m_stmtCost = GaterCostVisitor(nodep).cost();
 	iterateChildrenAlw(nodep, false);
+	m_stmtCost = laststmtcost;
     }
 
     virtual void visit(AstNodeAssign* nodep) {
@@ -841,6 +897,10 @@ class GaterVisitor : public GaterBaseVisitor {
 	if (!nodep->isClocked()) {
 	    nonOptimizable(nodep, "Non-clocked sensitivity");
 	}
+	// The SenGate holds one item, so gating would drop the others' edges
+	if (nodep->nextp()) {
+	    nonOptimizable(nodep, "Multiple sensitivity items");
+	}
 	iterateChildrenAlw(nodep, false);
     }
 
@@ -900,10 +960,12 @@ public:
 	m_aboveTrue = false;
 	m_stmtVscp = NULL;
 	m_stmtInPli = false;
+	m_stmtCost = 0;
     }
     virtual ~GaterVisitor() {
 	V3Stats::addStat("Optimizations, Gaters inserted", m_statGaters);
 	V3Stats::addStat("Optimizations, Gaters impacted bits", m_statBits);
+	V3Stats::addStat("Optimizations, Gaters not worth cost", m_statCostly);
     }
 };
 
@@ -913,9 +975,7 @@ public:
 void V3ClkGater::clkGaterAll(AstNetlist* nodep) {
     UINFO(2,__FUNCTION__<<": "<<endl);
     {
-        // While the gater does well at some modules, it seems to slow down many others
-        UINFO(5,"ClkGater is disabled due to performance issues\n");
+	GaterVisitor visitor (nodep);
     }  // Destruct before checking
-    //GaterVisitor visitor (nodep);
     V3Global::dumpCheckGlobalTree("clkgater", 0, v3Global.opt.dumpTreeLevel(__FILE__) >= 3);
 }
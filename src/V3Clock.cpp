@@ -28,6 +28,8 @@
 //			Set the __Vlast_{clock} at the end of the block
 //		Replace UNTILSTABLEs with loops until specified signals become const.
 //   Create global calling function for any per-scope functions.  (For FINALs).
+//   With --eval-clk, copy _eval per primary input clock, dropping the
+//	IFs and __Vclklast updates of the other primary input clocks.
 //
 //*************************************************************************
 
@@ -37,6 +39,9 @@
 #include <cstdarg>
 #include <unistd.h>
 #include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
 
 #include "V3Global.h"
 #include "V3Clock.h"
@@ -68,6 +73,17 @@ private:
     AstCFunc*		m_settleFuncp;	// Top settlement function we are creating
     AstSenTree*		m_lastSenp;	// Last sensitivity match, so we can detect duplicates.
     AstIf*		m_lastIfp;	// Last sensitivity if active to add more under
+    AstMTaskBody*	m_mtaskBodyp;	// Current mtask body, if under one
+    AstExecGraph*	m_execGraphp;	// Exec graph already moved to _eval
+    // For --eval-clk
+    struct SenIf {
+	AstIf*			m_ifp;		// Sensitivity IF under _eval
+	set<AstVarScope*>	m_inClks;	// Primary input clocks it checks edges of
+	bool			m_inOnly;	// Checks only edges of primary input clocks
+    };
+    vector<SenIf>	m_senIfs;	// Sensitivity IFs directly under _eval
+    vector<AstVarScope*> m_inClks;	// Primary input clocks with edges, in order found
+    map<AstVarScope*, AstNode*> m_lastAssigns;	// __Vclklast update of each clock
 
     // METHODS
     static int debug() {
@@ -92,6 +108,7 @@ private:
 			     new AstVarRef(vscp->fileline(), newvscp, true),
 			     new AstVarRef(vscp->fileline(), vscp, false));
 	m_evalFuncp->addFinalsp(finalp);
+	m_lastAssigns[vscp] = finalp;
 	//
 	UINFO(4,"New Last: "<<newvscp<<endl);
 	return newvscp;
@@ -177,8 +194,53 @@ private:
 	if (!senEqnp) sensesp->v3fatalSrc("No sense equation, shouldn't be in sequent activation.");
 	AstIf* newifp = new AstIf (sensesp->fileline(),
 				   senEqnp, NULL, NULL);
+	if (!m_mtaskBodyp) {
+	    SenIf senIf;
+	    senIf.m_ifp = newifp;
+	    senIf.m_inOnly = true;
+	    for (AstNodeSenItem* senp = sensesp->sensesp(); senp; senp=senp->nextp()->castNodeSenItem()) {
+		AstSenItem* itemp = senp->castSenItem();
+		if (!itemp || !itemp->varrefp()
+		    || (itemp->edgeType() != AstEdgeType::ET_POSEDGE
+			&& itemp->edgeType() != AstEdgeType::ET_NEGEDGE
+			&& itemp->edgeType() != AstEdgeType::ET_BOTHEDGE)
+		    || !itemp->varrefp()->varScopep()->varp()->isPrimaryIn()) {
+		    senIf.m_inOnly = false;
+		    continue;
+		}
+		AstVarScope* clkvscp = itemp->varrefp()->varScopep();
+		senIf.m_inClks.insert(clkvscp);
+		if (std::find(m_inClks.begin(), m_inClks.end(), clkvscp) == m_inClks.end()) {
+		    m_inClks.push_back(clkvscp);
+		}
+	    }
+	    m_senIfs.push_back(senIf);
+	}
 	return (newifp);
     }
+    void makeEvalClkFuncs() {
+	// The eval of an edge of one clock, all other primary input clocks
+	// being unchanged, can skip checking their edges.  Logic depending
+	// on anything else, including clocks generated from this one, keeps
+	// its checks; the eval loop handles their changes as usual.
+	for (vector<AstVarScope*>::iterator it = m_inClks.begin(); it != m_inClks.end(); ++it) {
+	    AstVarScope* clkvscp = *it;
+	    AstCFunc* funcp = m_evalFuncp->cloneTree(false);
+	    funcp->name(EmitCBaseVisitor::evalClkFuncPrefix()+clkvscp->varp()->name());
+	    for (vector<SenIf>::iterator sit = m_senIfs.begin(); sit != m_senIfs.end(); ++sit) {
+		if (sit->m_inOnly && !sit->m_inClks.count(clkvscp)) {
+		    sit->m_ifp->clonep()->unlinkFrBack()->deleteTree();
+		}
+	    }
+	    for (vector<AstVarScope*>::iterator oit = m_inClks.begin(); oit != m_inClks.end(); ++oit) {
+		if (*oit == clkvscp) continue;
+		map<AstVarScope*, AstNode*>::iterator lit = m_lastAssigns.find(*oit);
+		if (lit != m_lastAssigns.end()) lit->second->clonep()->unlinkFrBack()->deleteTree();
+	    }
+	    m_evalFuncp->scopep()->addActivep(funcp);
+	    UINFO(4,"  New "<<funcp<<endl);
+	}
+    }
     void clearLastSen() {
 	m_lastSenp = NULL;
 	m_lastIfp = NULL;
@@ -224,6 +286,8 @@ private:
 	    funcp->addInitsp(new AstCStmt(nodep->fileline(),
 					  EmitCBaseVisitor::symClassVar()+" = this->__VlSymsp;\n"));
 	    funcp->addInitsp(new AstCStmt(nodep->fileline(), EmitCBaseVisitor::symTopAssign()+"\n"));
+	    funcp->addInitsp(new AstCStmt(nodep->fileline(),
+					  "Verilated::threadContextp(vlSymsp->__Vm_contextp);\n"));
 	    m_scopep->addActivep(funcp);
 	    m_finalFuncp = funcp;
 	}
@@ -240,6 +304,7 @@ private:
 	}
 	// Process the activates
 	nodep->iterateChildren(*this);
+	if (v3Global.opt.evalClk() && !v3Global.opt.mtasks()) makeEvalClkFuncs();
 	// Done, clear so we can detect errors
 	UINFO(4," TOPSCOPEDONE "<<nodep<<endl);
 	clearLastSen();
@@ -326,7 +391,8 @@ private:
 	pushDeletep(nodep);
     }
     void addToEvalLoop(AstNode* stmtsp) {
-       m_evalFuncp->addStmtsp(stmtsp);  // add to top level function
+	if (m_mtaskBodyp) m_mtaskBodyp->addStmtsp(stmtsp);  // add to the mtask
+	else m_evalFuncp->addStmtsp(stmtsp);  // add to top level function
     }
     void addToSettleLoop(AstNode* stmtsp) {
        m_settleFuncp->addStmtsp(stmtsp);  // add to top level function
@@ -377,6 +443,20 @@ private:
 	}
     }
 
+    virtual void visit(AstExecGraph* nodep) {
+	if (nodep == m_execGraphp) return;  // Already processed, now under _eval
+	m_execGraphp = nodep;
+	for (m_mtaskBodyp = nodep->mTaskBodiesp(); m_mtaskBodyp;
+	     m_mtaskBodyp = m_mtaskBodyp->nextp()->castMTaskBody()) {
+	    // Each mtask makes its own ifs; sensitivities aren't shared across bodies
+	    clearLastSen();
+	    m_mtaskBodyp->iterateChildren(*this);
+	}
+	clearLastSen();
+	// The graph runs where its logic would have; all eval logic is in it
+	addToEvalLoop(nodep->unlinkFrBack());
+    }
+
     //--------------------
     // Default: Just iterate
     virtual void visit(AstNode* nodep) {
@@ -394,6 +474,8 @@ public:
         m_topScopep = NULL;
         m_lastSenp = NULL;
 	m_lastIfp = NULL;
+	m_mtaskBodyp = NULL;
+	m_execGraphp = NULL;
 	m_scopep = NULL;
 	//
 	nodep->accept(*this);
@@ -49,6 +49,21 @@
 //	...
 //	ASSIGNW (BITSEL(ARRAYSEL(VARREF(x), __Vdlyvdim_x), __Vdlyvlsb_x), __Vdlyvval_x)
 //
+// With -Oq, a one-dimensional memory written whole-element from two or
+// more sites (none inside loops) instead gets a write log, bounded by the
+// number of sites as each site runs at most once before the post block:
+// ASSIGNDLY (ARRAYSEL (VARREF(x), index), rhs)
+// ->	VAR __Vdlylogidx__x[sites]
+// 	VAR __Vdlylogval__x[sites]
+// 	VAR __Vdlylogn__x
+//	ASSIGN (ARRAYSEL(__Vdlylogidx__x, __Vdlylogn__x), index)
+//	ASSIGN (ARRAYSEL(__Vdlylogval__x, __Vdlylogn__x), rhs)
+//	ASSIGN (__Vdlylogn__x, __Vdlylogn__x + 1)
+//	...
+//	ALWAYSPOST: for (i=0; i<__Vdlylogn__x; ++i)
+//			x[__Vdlylogidx__x[i]] = __Vdlylogval__x[i];
+//		    __Vdlylogn__x = 0
+//
 //*************************************************************************
 
 #include "config_build.h"
@@ -65,6 +80,61 @@
 #include "V3Ast.h"
 #include "V3Stats.h"
 
+//######################################################################
+// Count write sites of memories that may use a write log
+
+class DelayedLogSitesVisitor : public AstNVisitor {
+public:
+    typedef std::map<AstVarScope*,int> LogSitesMap;
+private:
+    // STATE
+    LogSitesMap&	m_logSites;	// Sites per memory, -1 if any site cannot use a log
+    bool		m_inLoop;	// True in for loops
+    bool		m_inCFunc;	// True in public C Function
+
+    // VISITORS
+    virtual void visit(AstAssignDly* nodep) {
+	AstNode* lhsp = nodep->lhsp();
+	if (AstSel* bitselp = lhsp->castSel()) lhsp = bitselp->fromp();
+	if (!lhsp->castArraySel()) return;
+	AstNode* fromp = lhsp;
+	while (fromp->castArraySel()) fromp = fromp->castArraySel()->fromp();
+	AstVarRef* varrefp = fromp->castVarRef();
+	if (!varrefp) return;  // Createdlyarray will complain
+	// Only whole elements of one-dimensional memories
+	bool logable = (lhsp == nodep->lhsp()
+			&& lhsp->castArraySel()->fromp() == varrefp
+			&& !m_inLoop && !m_inCFunc);
+	int& sites = m_logSites[varrefp->varScopep()];
+	if (!logable || sites < 0) sites = -1;
+	else ++sites;
+    }
+    virtual void visit(AstCFunc* nodep) {
+	m_inCFunc = true;
+	nodep->iterateChildren(*this);
+	m_inCFunc = false;
+    }
+    virtual void visit(AstWhile* nodep) {
+	bool oldloop = m_inLoop;
+	m_inLoop = true;
+	nodep->iterateChildren(*this);
+	m_inLoop = oldloop;
+    }
+    virtual void visit(AstNodeMath* nodep) {}  // Speedup
+    virtual void visit(AstNode* nodep) {
+	nodep->iterateChildren(*this);
+    }
+public:
+    // CONSTUCTORS
+    DelayedLogSitesVisitor(AstNetlist* nodep, LogSitesMap& logSites)
+	: m_logSites(logSites) {
+	m_inLoop = false;
+	m_inCFunc = false;
+	nodep->accept(*this);
+    }
+    virtual ~DelayedLogSitesVisitor() {}
+};
+
 //######################################################################
 // Delayed state, as a visitor of each AstNode
 
@@ -74,7 +144,7 @@ private:
     // Cleared each module:
     //  AstVarScope::user1p()	-> AstVarScope*.  Points to temp var created.
     //  AstVarScope::user2p()	-> AstActive*.  Points to activity block of signal (valid when AstVarScope::user1p is valid)
-    //  AstVarScope::user4p()	-> AstAlwaysPost*.  Post block for this variable
+    //  AstVarScope::user4p()	-> AstAlwaysPost*.  Post block for this variable (or its write log)
     //  AstVarScope::user5()	-> VarUsage. Tracks delayed vs non-delayed usage
     //  AstVar::user2()		-> bool.  Set true if already made warning
     //  AstVarRef::user2()	-> bool.  Set true if already processed
@@ -103,6 +173,15 @@ private:
     V3Double0		m_statSharedSet;// Statistic tracking
     typedef std::map<AstVarScope*,int> ScopeVecMap;
     ScopeVecMap m_scopeVecMap; // Next var number for each scope
+    struct DlyLog {
+	AstVarScope*	m_idxVscp;	// Logged indices
+	AstVarScope*	m_valVscp;	// Logged values
+	AstVarScope*	m_countVscp;	// Number of entries logged
+    };
+    typedef std::map<AstVarScope*,DlyLog> DlyLogMap;
+    DelayedLogSitesVisitor::LogSitesMap m_logSites;	// Write sites per memory
+    DlyLogMap		m_dlyLogMap;	// Write log for each memory using one
+    V3Double0		m_statDlyLogs;	// Statistic tracking
 
     // METHODS
     static int debug() {
@@ -342,6 +421,98 @@ private:
 	return newlhsp;
     }
 
+    bool useDlyLog(AstNode* lhsp) {
+	// Lhs is an ARRAYSEL of a memory whose every write site may be logged
+	if (!v3Global.opt.oDlyLog()) return false;
+	AstArraySel* arrayselp = lhsp->castArraySel();
+	if (!arrayselp || !arrayselp->fromp()->castVarRef()) return false;
+	DelayedLogSitesVisitor::LogSitesMap::iterator it
+	    = m_logSites.find(arrayselp->fromp()->castVarRef()->varScopep());
+	return it != m_logSites.end() && it->second >= 2;
+    }
+    const DlyLog& createDlyLogVars(AstAssignDly* nodep, AstArraySel* arrayselp) {
+	// Create the write log and its ALWAYSPOST commit on the first site of a memory
+	AstVarRef* varrefp = arrayselp->fromp()->castVarRef();
+	AstVarScope* oldvscp = varrefp->varScopep();
+	DlyLogMap::iterator it = m_dlyLogMap.find(oldvscp);
+	if (it != m_dlyLogMap.end()) return it->second;
+	FileLine* fl = nodep->fileline();
+	int sites = m_logSites[oldvscp];
+	string suffix = "__"+varrefp->varp()->shortName();
+	AstNode* indexp = arrayselp->bitp();
+	AstNodeArrayDType* idxDtypep
+	    = new AstUnpackArrayDType (fl, nodep->findBitDType(indexp->width(), indexp->width(),
+								 AstNumeric::UNSIGNED),
+				       new AstRange (fl, sites-1, 0));
+	v3Global.rootp()->typeTablep()->addTypesp(idxDtypep);
+	AstNodeArrayDType* valDtypep
+	    = new AstUnpackArrayDType (fl, arrayselp->dtypep(), new AstRange (fl, sites-1, 0));
+	v3Global.rootp()->typeTablep()->addTypesp(valDtypep);
+	// Count is 2-state, so zero initialized; the ALWAYSPOST resets it after each commit
+	AstNodeDType* countDtypep = nodep->findBasicDType(AstBasicDTypeKwd::INT);
+	DlyLog log;
+	log.m_idxVscp = createVarSc(oldvscp, "__Vdlylogidx"+suffix, 0, idxDtypep);
+	log.m_valVscp = createVarSc(oldvscp, "__Vdlylogval"+suffix, 0, valDtypep);
+	log.m_countVscp = createVarSc(oldvscp, "__Vdlylogn"+suffix, 0, countDtypep);
+	AstVarScope* ivscp = createVarSc(oldvscp, "__Vdlylogi"+suffix, 0, countDtypep);
+	//
+	AstNode* bodysp
+	    = new AstAssign (fl, new AstVarRef(fl, ivscp, true),
+			     new AstConst(fl, AstConst::Signed32(), 0));
+	AstNode* commitp
+	    = new AstAssign (fl,
+			     new AstArraySel(fl, new AstVarRef(fl, oldvscp, true),
+					     new AstArraySel(fl, new AstVarRef(fl, log.m_idxVscp, false),
+							     new AstVarRef(fl, ivscp, false))),
+			     new AstArraySel(fl, new AstVarRef(fl, log.m_valVscp, false),
+					     new AstVarRef(fl, ivscp, false)));
+	AstNode* incp
+	    = new AstAssign (fl, new AstVarRef(fl, ivscp, true),
+			     new AstAdd(fl, new AstVarRef(fl, ivscp, false),
+					new AstConst(fl, AstConst::Signed32(), 1)));
+	bodysp->addNext(new AstWhile (fl,
+				      new AstLt(fl, new AstVarRef(fl, ivscp, false),
+						new AstVarRef(fl, log.m_countVscp, false)),
+				      commitp, incp));
+	bodysp->addNext(new AstAssign (fl, new AstVarRef(fl, log.m_countVscp, true),
+				       new AstConst(fl, AstConst::Signed32(), 0)));
+	AstAlwaysPost* finalp = new AstAlwaysPost(fl, NULL/*sens*/, bodysp);
+	AstActive* newactp = createActivePost(varrefp);
+	newactp->addStmtsp(finalp);
+	oldvscp->user4p(finalp);
+	finalp->user2p(newactp);
+	++m_statDlyLogs;
+	return m_dlyLogMap.insert(make_pair(oldvscp, log)).first->second;
+    }
+    void createDlyLog(AstAssignDly* nodep, AstArraySel* arrayselp) {
+	// Replace the delayed assignment with appending to the memory's write log
+	// See top of this file for transformation
+	UINFO(4,"AssignDlyLog: "<<nodep<<endl);
+	AstVarRef* varrefp = arrayselp->fromp()->castVarRef();
+	if (!varrefp->varScopep()) varrefp->v3fatalSrc("Var didn't get varscoped in V3Scope.cpp");
+	if (AstAlwaysPost* finalp = varrefp->varScopep()->user4p()->castAlwaysPost()) {
+	    checkActivePost(varrefp, finalp->user2p()->castActive());
+	}
+	const DlyLog& log = createDlyLogVars(nodep, arrayselp);
+	FileLine* fl = nodep->fileline();
+	AstNode* idxsetp
+	    = new AstAssign (fl, new AstArraySel(fl, new AstVarRef(fl, log.m_idxVscp, true),
+						 new AstVarRef(fl, log.m_countVscp, false)),
+			     arrayselp->bitp()->unlinkFrBack());
+	AstNode* valsetp
+	    = new AstAssign (fl, new AstArraySel(fl, new AstVarRef(fl, log.m_valVscp, true),
+						 new AstVarRef(fl, log.m_countVscp, false)),
+			     nodep->rhsp()->unlinkFrBack());
+	AstNode* countincp
+	    = new AstAssign (fl, new AstVarRef(fl, log.m_countVscp, true),
+			     new AstAdd(fl, new AstVarRef(fl, log.m_countVscp, false),
+					new AstConst(fl, AstConst::Signed32(), 1)));
+	// Each addNextHere goes directly after the assignment, so add in reverse
+	nodep->addNextHere(countincp);
+	nodep->addNextHere(valsetp);
+	nodep->addNextHere(idxsetp);
+    }
+
     // VISITORS
     virtual void visit(AstNetlist* nodep) {
 	//VV*****  We reset all userp() on the netlist
@@ -373,6 +544,15 @@ private:
 	if (nodep->lhsp()->castArraySel()
 	    || (nodep->lhsp()->castSel()
 		&& nodep->lhsp()->castSel()->fromp()->castArraySel())) {
+	    if (useDlyLog(nodep->lhsp())) {
+		AstNode* lhsp = nodep->lhsp()->unlinkFrBack();
+		createDlyLog(nodep, lhsp->castArraySel());
+		nodep->unlinkFrBack()->deleteTree(); VL_DANGLING(nodep);
+		lhsp->deleteTree(); VL_DANGLING(lhsp);
+		m_inDly = false;
+		m_nextDlyp = NULL;
+		return;
+	    }
 	    AstNode* lhsp = nodep->lhsp()->unlinkFrBack();
 	    AstNode* newlhsp = createDlyArray(nodep, lhsp);
 	    if (m_inLoop) nodep->v3warn(BLKLOOPINIT,"Unsupported: Delayed assignment to array inside for loops (non-delayed is ok - see docs)");
@@ -465,10 +645,14 @@ public:
 	m_inLoop = false;
 	m_inInitial = false;
 
+	if (v3Global.opt.oDlyLog()) {
+	    DelayedLogSitesVisitor sitesVisitor (nodep, m_logSites);
+	}
 	nodep->accept(*this);
     }
     virtual ~DelayedVisitor() {
 	V3Stats::addStat("Optimizations, Delayed shared-sets", m_statSharedSet);
+	V3Stats::addStat("Optimizations, Delayed write logs", m_statDlyLogs);
     }
 };
 
@@ -25,6 +25,8 @@
 #include <unistd.h>
 #include <cmath>
 #include <map>
+#include <memory>
+#include <set>
 #include <vector>
 #include <algorithm>
 #include VL_INCLUDE_UNORDERED_SET
@@ -34,11 +36,61 @@
 #include "V3EmitC.h"
 #include "V3EmitCBase.h"
 #include "V3Number.h"
+#include "V3PartitionGraph.h"
 
 #define VL_VALUE_STRING_MAX_WIDTH 8192	// We use a static char array in VL_VALUE_STRING
 
 #define EMITC_NUM_CONSTW	8	// Number of VL_CONST_W_*X's in verilated.h (IE VL_CONST_W_8X is last)
 
+//######################################################################
+// Find the thread writing each variable, for --threads-var-layout
+
+class EmitCVarThreadsVisitor : public AstNVisitor {
+public:
+    enum { THREAD_SHARED = -1 };  // Written by several threads, or none
+private:
+    // TYPES
+    typedef std::map<const AstVar*, int> VarThreadMap;
+    // STATE
+    VarThreadMap		m_threads;	// Thread writing each variable
+    std::set<const AstCFunc*>	m_visited;	// Functions walked for this thread
+    int				m_thread;	// Thread being walked
+    // VISITORS
+    virtual void visit(AstVarRef* nodep) {
+	if (!nodep->lvalue()) return;
+	VarThreadMap::iterator it = m_threads.find(nodep->varp());
+	if (it == m_threads.end()) m_threads.insert(make_pair(nodep->varp(), m_thread));
+	else if (it->second != m_thread) it->second = THREAD_SHARED;
+    }
+    virtual void visit(AstCCall* nodep) {
+	nodep->iterateChildren(*this);
+	if (m_visited.insert(nodep->funcp()).second) nodep->funcp()->accept(*this);
+    }
+    virtual void visit(AstNode* nodep) {
+	nodep->iterateChildren(*this);
+    }
+public:
+    // CONSTRUCTORS
+    explicit EmitCVarThreadsVisitor(AstExecGraph* execGraphp) {
+	m_thread = 0;
+	ExecSchedule schedule (execGraphp->depGraphp());
+	for (uint32_t thread = 0; thread < schedule.threads(); ++thread) {
+	    m_thread = thread;
+	    m_visited.clear();
+	    for (std::vector<const ExecMTask*>::const_iterator it = schedule.thread(thread).begin();
+		 it != schedule.thread(thread).end(); ++it) {
+		(*it)->bodyp()->accept(*this);
+	    }
+	}
+    }
+    virtual ~EmitCVarThreadsVisitor() {}
+    // METHODS
+    int thread(const AstVar* varp) const {
+	VarThreadMap::const_iterator it = m_threads.find(varp);
+	return (it == m_threads.end()) ? THREAD_SHARED : it->second;
+    }
+};
+
 //######################################################################
 // Emit statements and math operators
 
@@ -49,6 +101,8 @@ private:
     vector<AstVar*>		m_ctorVarsVec;		// All variables in constructor order
     int		m_splitSize;	// # of cfunc nodes placed into output file
     int		m_splitFilenum;	// File number being created, 0 = primary
+    const EmitCVarThreadsVisitor* m_varThreadsp;  // Writing threads, for --threads-var-layout
+    int		m_varPads;	// Number of padding members emitted in this class
 
 public:
     // METHODS
@@ -78,6 +132,7 @@ public:
     typedef enum {EVL_CLASS_IO, EVL_CLASS_SIG, EVL_CLASS_TEMP, EVL_CLASS_PAR, EVL_CLASS_ALL,
                   EVL_FUNC_ALL} EisWhich;
     void emitVarList(AstNode* firstp, EisWhich which, const string& prefixIfImp);
+    void emitVarSorted(AstVar* varp, int sortKey, int& lastGroup, const string& prefixIfImp);
     void emitVarCtors(bool* firstp);
     void emitCtorSep(bool* firstp);
     bool emitSimpleOk(AstNodeMath* nodep);
@@ -211,13 +266,38 @@ public:
 	    subnodep->accept(*this);
 	    comma = true;
 	}
-	if (nodep->backp()->castNodeMath() || nodep->backp()->castCReturn()) {
+	if (nodep->backp()->castNodeMath() || nodep->backp()->castCReturn()
+	    || nodep->backp()->castChangeDet()) {
 	    // We should have a separate CCall for math and statement usage, but...
 	    puts(")");
 	} else {
 	    puts(");\n");
 	}
     }
+    virtual void visit(AstExecGraph* nodep) {
+	// Hand each worker its thread function, run thread 0 here, then
+	// wait for all threads to finish.  The cycle parity lets the mtask
+	// counters count up and down on alternate evals, so never need resetting.
+	ExecSchedule schedule (nodep->depGraphp());
+	putsDecoration("// Run the multithreaded eval\n");
+	puts("vlSymsp->__Vm_even_cycle = !vlSymsp->__Vm_even_cycle;\n");
+	for (uint32_t thread = 1; thread < schedule.threads(); ++thread) {
+	    if (schedule.thread(thread).empty()) continue;
+	    puts("vlSymsp->__Vm_threadPoolp->workerp("+cvtToStr(thread-1)+")->addTask(&"
+		 +ExecMTask::cThreadFuncName(thread)+", vlSymsp->__Vm_even_cycle, vlSymsp);\n");
+	}
+	if (v3Global.opt.profThreads()) {
+	    puts("{\n");
+	    puts("VlProfileRec* __Vprfp = vlSymsp->__Vm_threadPoolp->profileAppend(0);\n");
+	    puts("if (VL_UNLIKELY(__Vprfp)) { vluint64_t __Vtick; VL_RDTSC(__Vtick); __Vprfp->startEval(__Vtick); }\n");
+	}
+	puts(ExecMTask::cThreadFuncName(0)+"(vlSymsp->__Vm_even_cycle, vlSymsp);\n");
+	puts("vlSymsp->__Vm_mt_final.waitUntilUpstreamDone(vlSymsp->__Vm_even_cycle);\n");
+	if (v3Global.opt.profThreads()) {
+	    puts("if (VL_UNLIKELY(__Vprfp)) { vluint64_t __Vtick; VL_RDTSC(__Vtick); __Vprfp->endRecord(__Vtick); }\n");
+	    puts("}\n");
+	}
+    }
     virtual void visit(AstNodeCase* nodep) {
 	// In V3Case...
 	nodep->v3fatalSrc("Case statements should have been reduced out");
@@ -516,13 +596,6 @@ public:
 	    puts(")");
 	}
     }
-    virtual void visit(AstMulS* nodep) {
-	if (nodep->widthWords() > VL_MULS_MAX_WORDS) {
-            nodep->v3error("Unsupported: Signed multiply of "<<nodep->width()
-                           <<" bits exceeds hardcoded limit VL_MULS_MAX_WORDS in verilatedos.h");
-	}
-	visit(nodep->castNodeBiop());
-    }
     virtual void visit(AstPow* nodep) {
 	if (nodep->widthWords() > VL_MULS_MAX_WORDS) {
             nodep->v3error("Unsupported: Power of "<<nodep->width()
@@ -779,7 +852,10 @@ public:
 	m_wideTempRefp = NULL;
 	m_splitSize = 0;
 	m_splitFilenum = 0;
+	m_varThreadsp = NULL;
+	m_varPads = 0;
     }
+    void varThreadsp(const EmitCVarThreadsVisitor* varThreadsp) { m_varThreadsp = varThreadsp; }
     virtual ~EmitCStmts() {}
 };
 
@@ -949,7 +1025,7 @@ class EmitCImp : EmitCStmts {
 	    for (vector<AstChangeDet*>::iterator it = m_blkChangeDetVec.begin();
 		 it != m_blkChangeDetVec.end(); ++it) {
 		AstChangeDet* nodep = *it;
-		if (nodep->lhsp()) {
+		if (nodep->lhsp() && nodep->rhsp()) {  // Not calls, which print their own
 		    puts("VL_DEBUG_IF( if(__req && (");
 		    bool gotOneIgnore = false;
 		    doubleOrDetect(nodep, gotOneIgnore);
@@ -994,7 +1070,14 @@ class EmitCImp : EmitCStmts {
     void emitImp(AstNodeModule* modp);
     void emitStaticDecl(AstNodeModule* modp);
     void emitSettleLoop(const std::string& eval_call, bool initial);
+    void emitWrapEvalPrologue(AstNodeModule* modp, const string& name, const string& rtn);
+    void emitWrapEvalLoop(const string& eval_call);
+    void emitWrapEvalEntry(AstNodeModule* modp, const string& name, const string& eval_call);
+    void emitWrapEvalCycles(AstNodeModule* modp);
+    AstVar* evalCyclesClockp(AstNodeModule* modp);
     void emitWrapEval(AstNodeModule* modp);
+    vector<AstCFunc*> evalClkFuncps(AstNodeModule* modp);
+    void emitThreadFuncs(AstNodeModule* modp);
     void emitInt(AstNodeModule* modp);
     void maybeSplit(AstNodeModule* modp);
 
@@ -1006,6 +1089,7 @@ public:
     }
     virtual ~EmitCImp() {}
     void main(AstNodeModule* modp, bool slow, bool fast);
+    using EmitCStmts::varThreadsp;
     void mainDoFunc(AstCFunc* nodep) {
 	nodep->accept(*this);
     }
@@ -1149,6 +1233,10 @@ void EmitCStmts::emitOpName(AstNode* nodep, const string& format,
     string nextComma;
     bool needComma = false;
 #define COMMA { if (nextComma!="") { puts(nextComma); nextComma=""; } }
+    // Wide VL_*_W(words, ...) operators have a width template in verilated.h;
+    // call VL_*_W<words>(...) so each width compiles with a constant word count
+    bool wordsTemplate = (lhsp && lhsp->isWide()
+			  && format.find("_%lq(%lW, ") != string::npos);
 
     putbs("");
     for (string::const_iterator pos = format.begin(); pos != format.end(); ++pos) {
@@ -1197,7 +1285,9 @@ void EmitCStmts::emitOpName(AstNode* nodep, const string& format,
 		    needComma = true;
 		    break;
 		case 'W':
-		    if (lhsp->isWide()) {
+		    if (wordsTemplate) {
+			// Emitted as the template argument instead
+		    } else if (lhsp->isWide()) {
 			COMMA;
 			puts(cvtToStr(lhsp->widthWords()));
 			needComma = true;
@@ -1217,7 +1307,11 @@ void EmitCStmts::emitOpName(AstNode* nodep, const string& format,
 	} else if (pos[0] == ')') {
 	    nextComma=""; puts(")");
 	} else if (pos[0] == '(') {
-	    COMMA; needComma = false; puts("(");
+	    COMMA; needComma = false;
+	    if (wordsTemplate) {
+		puts("<"+cvtToStr(lhsp->widthWords())+">");
+	    }
+	    puts("(");
 	} else {
 	    // Normal text
 	    if (isalnum(pos[0])) needComma = true;
@@ -1538,6 +1632,9 @@ void EmitCImp::emitCtorImp(AstNodeModule* modp) {
     bool first = true;
     if (optSystemC() && modp->isTop()) {
 	puts("VL_SC_CTOR_IMP("+modClassName(modp)+")");
+    } else if (modp->isTop()) {
+        puts("VL_CTOR_CONTEXT_IMP("+modClassName(modp)+")");
+        first = false;  // VL_CTOR_CONTEXT_IMP includes the first ':'
     } else {
         puts("VL_CTOR_IMP("+modClassName(modp)+")");
         first = false;  // VL_CTOR_IMP includes the first ':'
@@ -1710,7 +1807,14 @@ void EmitCImp::emitTextSection(AstType type) {
 void EmitCImp::emitCellCtors(AstNodeModule* modp) {
     if (modp->isTop()) {
 	// Must be before other constructors, as __vlCoverInsert calls it
-	puts(EmitCBaseVisitor::symClassVar()+" = __VlSymsp = new "+symClassName()+"(this, name());\n");
+	if (optSystemC()) {
+	    puts(EmitCBaseVisitor::symClassVar()+" = __VlSymsp = new "+symClassName()+"(this, name(), NULL);\n");
+	} else {
+	    puts("// Without an allocator argument, use the one new placed the model with, if any\n");
+	    puts("if (!__VCallocatorp) __VCallocatorp = VerilatedAllocated::placedAllocatorp(this);\n");
+	    puts(EmitCBaseVisitor::symClassVar()+" = __VlSymsp = new (__VCallocatorp) "+symClassName()
+		 +"(this, name(), __VCcontextp);\n");
+	}
 	puts(EmitCBaseVisitor::symTopAssign()+"\n");
     }
     for (AstNode* nodep=modp->stmtsp(); nodep; nodep = nodep->nextp()) {
@@ -1773,13 +1877,126 @@ void EmitCImp::emitSettleLoop(const std::string& eval_call, bool initial) {
     puts(        "__Vchange = _change_request(vlSymsp);\n");
     puts(    "}\n");
     puts("} while (VL_UNLIKELY(__Vchange));\n");
+    if (v3Global.opt.profSettle()) {
+	if (initial) puts("vlSymsp->__Vm_settleProf.initialDone(__VclockLoop);\n");
+	else puts("vlSymsp->__Vm_settleProf.evalDone(__VclockLoop);\n");
+    }
+}
+
+vector<AstCFunc*> EmitCImp::evalClkFuncps(AstNodeModule* modp) {
+    // The _eval copies V3Clock made for --eval-clk
+    vector<AstCFunc*> funcps;
+    if (!modp->isTop()) return funcps;
+    string prefix = EmitCBaseVisitor::evalClkFuncPrefix();
+    for (AstNode* nodep = modp->stmtsp(); nodep; nodep = nodep->nextp()) {
+	if (AstCFunc* funcp = nodep->castCFunc()) {
+	    if (funcp->name().substr(0, prefix.length()) == prefix) funcps.push_back(funcp);
+	}
+    }
+    return funcps;
 }
 
 void EmitCImp::emitWrapEval(AstNodeModule* modp) {
-    puts("\nvoid "+modClassName(modp)+"::eval() {\n");
-    puts("VL_DEBUG_IF(VL_DBG_MSGF(\"+++++TOP Evaluate "+modClassName(modp)+"::eval\\n\"); );\n");
+    if (v3Global.opt.profSettle()) {
+	puts("\nVerilatedSettleProf& "+modClassName(modp)+"::settleProf() {\n");
+	puts("return __VlSymsp->__Vm_settleProf;\n");
+	puts("}\n");
+    }
+    if (v3Global.opt.profBranches()) {
+	puts("\nVerilatedBranchProf& "+modClassName(modp)+"::branchProf() {\n");
+	puts("return __VlSymsp->__Vm_branchProf;\n");
+	puts("}\n");
+    }
+    emitWrapEvalEntry(modp, "eval", "_eval(vlSymsp);");
+    // Per-clock entries run their own _eval copy first; anything the
+    // edge changed, such as generated clocks, settles in the full _eval
+    vector<AstCFunc*> clkFuncps = evalClkFuncps(modp);
+    for (vector<AstCFunc*>::iterator it = clkFuncps.begin(); it != clkFuncps.end(); ++it) {
+	string clkName = (*it)->name().substr(EmitCBaseVisitor::evalClkFuncPrefix().length());
+	emitWrapEvalEntry(modp, "eval_clk_"+clkName,
+			  "if (VL_LIKELY(!__VclockLoop)) "+(*it)->name()+"(vlSymsp);\n"
+			  "else _eval(vlSymsp);");
+    }
+    if (evalCyclesClockp(modp)) {
+	emitWrapEvalCycles(modp);
+    } else if (modp->isTop() && v3Global.opt.evalCycles() != "" && !optSystemC()) {
+	modp->v3error("--eval-cycles clock is not a one bit top level input: "<<v3Global.opt.evalCycles());
+    }
+
+    //
+    puts("\nvoid "+modClassName(modp)+"::_eval_initial_loop("+EmitCBaseVisitor::symClassVar()+") {\n");
+    puts("vlSymsp->__Vm_didInit = true;\n");
+    puts("_eval_initial(vlSymsp);\n");
+    if (v3Global.opt.trace()) {
+	puts("vlSymsp->__Vm_activity = true;\n");
+    }
+    emitSettleLoop((string("_eval_settle(vlSymsp);\n")
+                    +"_eval(vlSymsp);"), true);
+    puts("}\n");
+    splitSizeInc(10);
+}
+
+AstVar* EmitCImp::evalCyclesClockp(AstNodeModule* modp) {
+    // The input clock eval_cycles() toggles, if --eval-cycles
+    if (!modp->isTop() || v3Global.opt.evalCycles() == "" || optSystemC()) return NULL;
+    for (AstNode* nodep = modp->stmtsp(); nodep; nodep = nodep->nextp()) {
+	if (AstVar* varp = nodep->castVar()) {
+	    if (varp->name() == v3Global.opt.evalCycles() && varp->isPrimaryIn() && varp->width1()) {
+		return varp;
+	    }
+	}
+    }
+    return NULL;
+}
+
+void EmitCImp::emitWrapEvalEntry(AstNodeModule* modp, const string& name, const string& eval_call) {
+    puts("\nvoid "+modClassName(modp)+"::"+name+"() {\n");
+    emitWrapEvalPrologue(modp, name, "return;");
+    emitWrapEvalLoop(eval_call);
+    puts("}\n");
+    splitSizeInc(10);
+}
+
+void EmitCImp::emitWrapEvalCycles(AstNodeModule* modp) {
+    // Each half cycle is a full eval, but the model is entered once
+    AstVar* clkp = evalCyclesClockp(modp);
+    vector<AstCFunc*> clkFuncps = evalClkFuncps(modp);
+    string eval_call = "_eval(vlSymsp);";
+    for (vector<AstCFunc*>::iterator it = clkFuncps.begin(); it != clkFuncps.end(); ++it) {
+	if ((*it)->name() == EmitCBaseVisitor::evalClkFuncPrefix()+clkp->name()) {
+	    eval_call = "if (VL_LIKELY(!__VclockLoop)) "+(*it)->name()+"(vlSymsp);\n"
+		"else _eval(vlSymsp);";
+	}
+    }
+    puts("\nvluint64_t "+modClassName(modp)+"::eval_cycles(vluint64_t cycles,"
+	 " VerilatedEvalPredicate predicatep, void* userp, vluint64_t halfPeriod) {\n");
+    emitWrapEvalPrologue(modp, "eval_cycles", "return 0;");
+    puts("vluint64_t cycle = 0;\n");
+    puts("while (cycle < cycles) {\n");
+    puts("if (halfPeriod) vlSymsp->__Vm_contextp->timeInc(halfPeriod);\n");
+    puts("vlTOPp->"+clkp->name()+" = 1;\n");
+    puts("{\n");
+    emitWrapEvalLoop(eval_call);
+    puts("}\n");
+    puts("if (halfPeriod) vlSymsp->__Vm_contextp->timeInc(halfPeriod);\n");
+    puts("vlTOPp->"+clkp->name()+" = 0;\n");
+    puts("{\n");
+    emitWrapEvalLoop(eval_call);
+    puts("}\n");
+    puts("++cycle;\n");
+    puts("if (VL_UNLIKELY(vlSymsp->__Vm_contextp->gotFinish())) break;\n");
+    puts("if (predicatep && VL_UNLIKELY(predicatep(userp))) break;\n");
+    puts("}\n");
+    puts("return cycle;\n");
+    puts("}\n");
+    splitSizeInc(20);
+}
+
+void EmitCImp::emitWrapEvalPrologue(AstNodeModule* modp, const string& name, const string& rtn) {
+    puts("VL_DEBUG_IF(VL_DBG_MSGF(\"+++++TOP Evaluate "+modClassName(modp)+"::"+name+"\\n\"); );\n");
     puts(EmitCBaseVisitor::symClassVar()+" = this->__VlSymsp;  // Setup global symbol table\n");
     puts(EmitCBaseVisitor::symTopAssign()+"\n");
+    puts("Verilated::threadContextp(vlSymsp->__Vm_contextp);\n");
     puts("#ifdef VL_DEBUG\n");
     putsDecoration("// Debug assertions\n");
     puts("_eval_debug_assertions();\n");
@@ -1787,9 +2004,11 @@ void EmitCImp::emitWrapEval(AstNodeModule* modp) {
     putsDecoration("// Initialize\n");
     puts("if (VL_UNLIKELY(!vlSymsp->__Vm_didInit)) _eval_initial_loop(vlSymsp);\n");
     if (v3Global.opt.inhibitSim()) {
-	puts("if (VL_UNLIKELY(__Vm_inhibitSim)) return;\n");
+	puts("if (VL_UNLIKELY(__Vm_inhibitSim)) "+rtn+"\n");
     }
+}
 
+void EmitCImp::emitWrapEvalLoop(const string& eval_call) {
     if (v3Global.opt.threads() == 1) {
 	uint32_t mtaskId = 0;
 	putsDecoration("// MTask "+cvtToStr(mtaskId)+" start\n");
@@ -1799,27 +2018,60 @@ void EmitCImp::emitWrapEval(AstNodeModule* modp) {
     emitSettleLoop(
         (string("VL_DEBUG_IF(VL_DBG_MSGF(\"+ Clock loop\\n\"););\n")
          + (v3Global.opt.trace() ? "vlSymsp->__Vm_activity = true;\n" : "")
-         + "_eval(vlSymsp);"), false);
+         + eval_call), false);
     if (v3Global.opt.threads() == 1) {
 	puts("Verilated::endOfThreadMTask(vlSymsp->__Vm_evalMsgQp);\n");
     }
     if (v3Global.opt.threads()) {
 	puts("Verilated::endOfEval(vlSymsp->__Vm_evalMsgQp);\n");
     }
-    puts("}\n");
-    splitSizeInc(10);
+}
 
-    //
-    puts("\nvoid "+modClassName(modp)+"::_eval_initial_loop("+EmitCBaseVisitor::symClassVar()+") {\n");
-    puts("vlSymsp->__Vm_didInit = true;\n");
-    puts("_eval_initial(vlSymsp);\n");
-    if (v3Global.opt.trace()) {
-	puts("vlSymsp->__Vm_activity = true;\n");
+void EmitCImp::emitThreadFuncs(AstNodeModule* modp) {
+    // One function per thread, running that thread's mtasks in schedule order
+    AstExecGraph* execGraphp = v3Global.rootp()->execGraphp();
+    ExecSchedule schedule (execGraphp->depGraphp());
+    for (uint32_t thread = 0; thread < schedule.threads(); ++thread) {
+	if (thread && schedule.thread(thread).empty()) continue;
+	puts("\nvoid "+modClassName(modp)+"::"+ExecMTask::cThreadFuncName(thread)
+	     +"(bool even_cycle, void* symtab) {\n");
+	puts(symClassName()+"* __restrict vlSymsp = static_cast<"+symClassName()+"*>(symtab);\n");
+	puts(EmitCBaseVisitor::symTopAssign()+"\n");
+	if (thread) puts("Verilated::threadContextp(vlSymsp->__Vm_contextp);\n");
+	for (std::vector<const ExecMTask*>::const_iterator it = schedule.thread(thread).begin();
+	     it != schedule.thread(thread).end(); ++it) {
+	    const ExecMTask* mtaskp = *it;
+	    putsDecoration("// MTask "+cvtToStr(mtaskp->id())+" cost="+cvtToStr(mtaskp->cost())
+			   +" start="+cvtToStr(mtaskp->startTime())+"\n");
+	    if (mtaskp->crossThreadDeps()) {
+		puts("vlSymsp->"+mtaskp->cVertexName()+".waitUntilUpstreamDone(even_cycle);\n");
+	    }
+	    puts("Verilated::mtaskId("+cvtToStr(mtaskp->id())+");\n");
+	    if (v3Global.opt.profThreads()) {
+		// Timed from after the wait, so gaps in the trace are waiting
+		puts("{\n");
+		puts("VlProfileRec* __Vprfp = vlSymsp->__Vm_threadPoolp->profileAppend("+cvtToStr(thread)+");\n");
+		puts("if (VL_UNLIKELY(__Vprfp)) { vluint64_t __Vtick; VL_RDTSC(__Vtick); __Vprfp->startRecord(__Vtick, "
+		     +cvtToStr(mtaskp->id())+"); }\n");
+	    }
+	    mtaskp->bodyp()->stmtsp()->iterateAndNext(*this);
+	    if (v3Global.opt.profThreads()) {
+		puts("if (VL_UNLIKELY(__Vprfp)) { vluint64_t __Vtick; VL_RDTSC(__Vtick); __Vprfp->endRecord(__Vtick); }\n");
+		puts("}\n");
+	    }
+	    for (V3GraphEdge* edgep = mtaskp->outBeginp(); edgep; edgep = edgep->outNextp()) {
+		const ExecMTask* nextp = static_cast<const ExecMTask*>(edgep->top());
+		if (nextp->thread() != thread) {
+		    puts("vlSymsp->"+nextp->cVertexName()+".signalUpstreamDone(even_cycle);\n");
+		}
+	    }
+	    splitSizeInc(10);
+	}
+	puts("Verilated::endOfThreadMTask(vlSymsp->__Vm_evalMsgQp);\n");
+	puts("Verilated::mtaskId(0);\n");
+	puts("vlSymsp->__Vm_mt_final.signalUpstreamDone(even_cycle);\n");
+	puts("}\n");
     }
-    emitSettleLoop((string("_eval_settle(vlSymsp);\n")
-                    +"_eval(vlSymsp);"), true);
-    puts("}\n");
-    splitSizeInc(10);
 }
 
 //----------------------------------------------------------------------
@@ -1832,10 +2084,15 @@ void EmitCStmts::emitVarList(AstNode* firstp, EisWhich which, const string& pref
     // Largest->smallest reduces the number of pad variables.
     // But for now, Smallest->largest makes it more likely a small offset will allow access to the signal.
     // TODO: Move this sort to an earlier visitor stage.
+    // With --threads-var-layout, members are first grouped by the thread
+    // writing them, see emitVarSorted.
     typedef std::multimap<int, AstVar*> VarSortMap;
     VarSortMap varAnonMap;
     VarSortMap varNonanonMap;
     int anonMembers = 0;
+    bool byThread = (m_varThreadsp && prefixIfImp == ""
+		     && (which == EVL_CLASS_SIG || which == EVL_CLASS_TEMP));
+    int lastGroup = 0;
 
     for (int isstatic=1; isstatic>=0; isstatic--) {
         if (prefixIfImp!="" && !isstatic) continue;
@@ -1863,6 +2120,9 @@ void EmitCStmts::emitVarList(AstNode* firstp, EisWhich which, const string& pref
                     else if (sigbytes==4) sortbytes=4;
                     else if (sigbytes==2) sortbytes=2;
                     else if (sigbytes==1) sortbytes=1;
+                    if (byThread && !varp->isStatic()) {
+                        sortbytes += 16 * (m_varThreadsp->thread(varp) + 1);
+                    }
 
                     bool anonOk = (v3Global.opt.compLimitMembers() != 0  // Enabled
                                    && !varp->isStatic()
@@ -1906,8 +2166,7 @@ void EmitCStmts::emitVarList(AstNode* firstp, EisWhich which, const string& pref
                 for (int l1=0; l1<anonL1s && it != varAnonMap.end(); ++l1) {
                     if (anonL1s != 1) puts("struct {\n");
                     for (int l0=0; l0<lim && it != varAnonMap.end(); ++l0) {
-                        AstVar* varp = it->second;
-                        emitVarDecl(varp, prefixIfImp);
+                        emitVarSorted(it->second, it->first, lastGroup, prefixIfImp);
                         ++it;
                     }
                     if (anonL1s != 1) puts("};\n");
@@ -1918,15 +2177,26 @@ void EmitCStmts::emitVarList(AstNode* firstp, EisWhich which, const string& pref
         }
         // Leftovers, just in case off by one error somewhere above
         for (; it != varAnonMap.end(); ++it) {
-            AstVar* varp = it->second;
-            emitVarDecl(varp, prefixIfImp);
+            emitVarSorted(it->second, it->first, lastGroup, prefixIfImp);
         }
     }
     // Output nonanons
     for (VarSortMap::iterator it = varNonanonMap.begin(); it != varNonanonMap.end(); ++it) {
-        AstVar* varp = it->second;
-        emitVarDecl(varp, prefixIfImp);
+        emitVarSorted(it->second, it->first, lastGroup, prefixIfImp);
     }
+    if (lastGroup) emitVarSorted(NULL, 0, lastGroup, prefixIfImp);
+}
+
+void EmitCStmts::emitVarSorted(AstVar* varp, int sortKey, int& lastGroup, const string& prefixIfImp) {
+    // Group 0 is variables written by no or several threads, group N+1 by
+    // thread N only.  A cache line of padding between groups means no
+    // line is written by two threads, wherever the class is allocated.
+    int group = sortKey / 16;
+    if (group != lastGroup) {
+        puts("char __Vpad"+cvtToStr(++m_varPads)+"[VL_CACHE_LINE_BYTES];  ///< Padding between threads' variables\n");
+        lastGroup = group;
+    }
+    if (varp) emitVarDecl(varp, prefixIfImp);
 }
 
 struct CmpName {
@@ -2105,8 +2375,22 @@ void EmitCImp::emitInt(AstNodeModule* modp) {
 	    puts("/// Construct the model; called by application code\n");
 	    puts("/// The special name "" may be used to make a wrapper with a\n");
 	    puts("/// single model invisible with respect to DPI scope names.\n");
+	    puts("/// The model runs in the given context, else Verilated::defaultContextp().\n");
+	    puts("/// State below the top module is allocated with the given allocator, else\n");
+	    puts("/// with the one the model was placed with by new, if any; it must outlive the model.\n");
+	    puts(modClassName(modp)+"(const char* name=\"TOP\", VerilatedContext* contextp=NULL,\n");
+	    puts("VerilatedAllocator* allocatorp=NULL);\n");
+	    puts("/// Allocate the model, and so all its state, with an allocator,\n");
+	    puts("/// e.g. new (allocatorp) "+modClassName(modp)+"(\"TOP\")\n");
+	    puts("static void* operator new(size_t size) { return VerilatedAllocated::operator new(size, NULL); }\n");
+	    puts("static void* operator new(size_t size, VerilatedAllocator* allocatorp) {\n");
+	    puts("return VerilatedAllocated::operator new(size, allocatorp); }\n");
+	    puts("static void operator delete(void* objp) { VerilatedAllocated::operator delete(objp); }\n");
+	    puts("static void operator delete(void* objp, VerilatedAllocator*) {\n");
+	    puts("VerilatedAllocated::operator delete(objp); }\n");
+	} else {
+	    puts(modClassName(modp)+"(const char* name=\"TOP\");\n");
 	}
-	puts(modClassName(modp)+"(const char* name=\"TOP\");\n");
 	if (modp->isTop()) puts("/// Destroy the model; called (often implicitly) by application code\n");
 	puts("~"+modClassName(modp)+"();\n");
     }
@@ -2127,6 +2411,28 @@ void EmitCImp::emitInt(AstNodeModule* modp) {
 	else puts("/// Evaluate the model.  Application must call when inputs change.\n");
 	puts("void eval();\n");
 	ofp()->putsPrivate(false);  // public:
+	vector<AstCFunc*> clkFuncps = evalClkFuncps(modp);
+	for (vector<AstCFunc*>::iterator it = clkFuncps.begin(); it != clkFuncps.end(); ++it) {
+	    string clkName = (*it)->name().substr(EmitCBaseVisitor::evalClkFuncPrefix().length());
+	    puts("/// Evaluate the model after an edge of "+clkName+", and no other input clock changed.\n");
+	    puts("void eval_clk_"+clkName+"();\n");
+	}
+	if (v3Global.opt.profSettle()) {
+	    puts("/// Settle loop statistics, for --prof-settle\n");
+	    puts("VerilatedSettleProf& settleProf();\n");
+	}
+	if (v3Global.opt.profBranches()) {
+	    puts("/// Branch counts, for --prof-branches\n");
+	    puts("VerilatedBranchProf& branchProf();\n");
+	}
+	if (AstVar* clkp = evalCyclesClockp(modp)) {
+	    puts("/// Evaluate cycles of "+clkp->name()+", each setting it to 1 then 0.  Stops early after\n");
+	    puts("/// $finish, or when predicatep(userp) returns true.  Returns the cycles run.\n");
+	    puts("/// Time advances by halfPeriod before each edge; if 0, it does not advance.\n");
+	    puts("vluint64_t eval_cycles(vluint64_t cycles,"
+		 " VerilatedEvalPredicate predicatep=NULL, void* userp=NULL,\n");
+	    puts("vluint64_t halfPeriod=0);\n");
+	}
 	if (!optSystemC()) puts("/// Simulation complete, run final blocks.  Application must call on completion.\n");
 	puts("void final();\n");
 	if (v3Global.opt.inhibitSim()) {
@@ -2138,6 +2444,14 @@ void EmitCImp::emitInt(AstNodeModule* modp) {
     if (modp->isTop()) {
 	ofp()->putsPrivate(true);  // private:
 	puts("static void _eval_initial_loop("+EmitCBaseVisitor::symClassVar()+");\n");
+	if (AstExecGraph* execGraphp = v3Global.rootp()->execGraphp()) {
+	    ExecSchedule schedule (execGraphp->depGraphp());
+	    for (uint32_t thread = 0; thread < schedule.threads(); ++thread) {
+		if (thread && schedule.thread(thread).empty()) continue;
+		puts("static void "+ExecMTask::cThreadFuncName(thread)
+		     +"(bool even_cycle, void* symtab);\n");
+	    }
+	}
     }
 
     ofp()->putsPrivate(false);  // public:
@@ -2217,6 +2531,7 @@ void EmitCImp::emitImp(AstNodeModule* modp) {
 	    puts("\n//--------------------\n");
 	    puts("\n");
 	    emitWrapEval(modp);
+	    if (v3Global.rootp()->execGraphp()) emitThreadFuncs(modp);
 	}
     }
 
@@ -2564,13 +2879,17 @@ public:
 
 void V3EmitC::emitc() {
     UINFO(2,__FUNCTION__<<": "<<endl);
+    vl_unique_ptr<EmitCVarThreadsVisitor> varThreadsp;
+    if (v3Global.opt.threadsVarLayout() && v3Global.rootp()->execGraphp()) {
+        varThreadsp.reset(new EmitCVarThreadsVisitor(v3Global.rootp()->execGraphp()));
+    }
     // Process each module in turn
     for (AstNodeModule* nodep = v3Global.rootp()->modulesp(); nodep; nodep=nodep->nextp()->castNodeModule()) {
         if (v3Global.opt.outputSplit()) {
-            { EmitCImp fast; fast.main(nodep, false, true); }
-            { EmitCImp slow; slow.main(nodep, true, false); }
+            { EmitCImp fast; fast.varThreadsp(varThreadsp.get()); fast.main(nodep, false, true); }
+            { EmitCImp slow; slow.varThreadsp(varThreadsp.get()); slow.main(nodep, true, false); }
         } else {
-            { EmitCImp both; both.main(nodep, true, true); }
+            { EmitCImp both; both.varThreadsp(varThreadsp.get()); both.main(nodep, true, true); }
         }
     }
 }
@@ -59,6 +59,7 @@ public:
     static string topClassName() {		// Return name of top wrapper module
 	return v3Global.opt.prefix();
     }
+    static string evalClkFuncPrefix() { return "_eval_clk__"; }	// Eval of one clock's edges, --eval-clk
     AstCFile* newCFile(const string& filename, bool slow, bool source) {
 	AstCFile* cfilep = new AstCFile(v3Global.rootp()->fileline(), filename);
 	cfilep->slow(slow);
@@ -33,6 +33,7 @@
 #include "V3EmitC.h"
 #include "V3EmitCBase.h"
 #include "V3LanguageWords.h"
+#include "V3PartitionGraph.h"
 
 //######################################################################
 // Symbol table emitting
@@ -276,6 +277,9 @@ void EmitCSyms::emitSymHdr() {
     } else {
 	puts("#include \"verilated.h\"\n");
     }
+    if (v3Global.rootp()->execGraphp()) {
+	puts("#include \"verilated_threads.h\"\n");
+    }
 
     // for
     puts("\n// INCLUDE MODULE CLASSES\n");
@@ -308,6 +312,37 @@ void EmitCSyms::emitSymHdr() {
 	puts("bool __Vm_activity;  ///< Used by trace routines to determine change occurred\n");
     }
     puts("bool __Vm_didInit;\n");
+    if (v3Global.opt.profSettle()) {
+	puts("VerilatedSettleProf __Vm_settleProf;  ///< Settle loop statistics, for --prof-settle\n");
+    }
+    if (v3Global.opt.profBranches()) {
+	puts("VerilatedBranchProf __Vm_branchProf;  ///< Branch counts, for --prof-branches\n");
+    }
+    if (AstExecGraph* execGraphp = v3Global.rootp()->execGraphp()) {
+	puts("\n// MULTI-THREADING\n");
+	puts("bool __Vm_even_cycle;  ///< Parity of the eval, for the mtask counters\n");
+	puts("VlThreadPool* __Vm_threadPoolp;\n");
+	if (v3Global.opt.threadsVarLayout()) {
+	    // Keep the counters off the line holding the members above
+	    puts("char __Vm_mt_pad[VL_CACHE_LINE_BYTES];\n");
+	}
+	puts("VlMTaskVertex __Vm_mt_final;  ///< Counts threads done with the eval\n");
+	if (v3Global.opt.threadsVarLayout()) {
+	    // Signaled by every thread
+	    puts("char __Vm_mt_final_pad[VL_CACHE_LINE_BYTES];\n");
+	}
+	for (const V3GraphVertex* vxp = execGraphp->depGraphp()->verticesBeginp();
+	     vxp; vxp = vxp->verticesNextp()) {
+	    const ExecMTask* mtaskp = static_cast<const ExecMTask*>(vxp);
+	    if (mtaskp->crossThreadDeps()) {
+		puts("VlMTaskVertex "+mtaskp->cVertexName()+";\n");
+		if (v3Global.opt.threadsVarLayout()) {
+		    // Each counter is signaled by other threads
+		    puts("char "+mtaskp->cVertexName()+"_pad[VL_CACHE_LINE_BYTES];\n");
+		}
+	    }
+	}
+    }
 
     puts("\n// SUBCELL STATE\n");
     for (vector<ScopeModPair>::iterator it = m_scopes.begin(); it != m_scopes.end(); ++it) {
@@ -339,8 +374,12 @@ void EmitCSyms::emitSymHdr() {
     }
 
     puts("\n// CREATORS\n");
-    puts(symClassName()+"("+topClassName()+"* topp, const char* namep);\n");
-    puts((string)"~"+symClassName()+"() {}\n");
+    puts(symClassName()+"("+topClassName()+"* topp, const char* namep, VerilatedContext* contextp);\n");
+    if (v3Global.rootp()->execGraphp()) {
+	puts((string)"~"+symClassName()+"() { delete __Vm_threadPoolp; }\n");
+    } else {
+	puts((string)"~"+symClassName()+"() {}\n");
+    }
 
     puts("\n// METHODS\n");
     puts("inline const char* name() { return __Vm_namep; }\n");
@@ -375,15 +414,69 @@ void EmitCSyms::emitSymImp() {
     }
 
     //puts("\n// GLOBALS\n");
+    const vector<string>& settleProfNames = v3Global.settleProfNames();
+    if (v3Global.opt.profSettle() && !settleProfNames.empty()) {
+	puts("\n// Change-detected variables, for --prof-settle\n");
+	puts("static const char* const __Vm_settleProfNames[] = {\n");
+	for (vector<string>::const_iterator it = settleProfNames.begin(); it != settleProfNames.end(); ++it) {
+	    putsQuoted(*it);
+	    puts(",\n");
+	}
+	puts("};\n");
+    }
+    const vector<string>& branchProfKeys = v3Global.branchProfKeys();
+    if (v3Global.opt.profBranches() && !branchProfKeys.empty()) {
+	puts("\n// Branch points and their number of arms, for --prof-branches\n");
+	puts("static const char* const __Vm_branchProfKeys[] = {\n");
+	for (vector<string>::const_iterator it = branchProfKeys.begin(); it != branchProfKeys.end(); ++it) {
+	    putsQuoted(*it);
+	    puts(",\n");
+	}
+	puts("};\n");
+	puts("static const int __Vm_branchProfArms[] = {\n");
+	const vector<int>& branchProfArms = v3Global.branchProfArms();
+	for (vector<int>::const_iterator it = branchProfArms.begin(); it != branchProfArms.end(); ++it) {
+	    puts(cvtToStr(*it)+",\n");
+	}
+	puts("};\n");
+    }
 
     puts("\n// FUNCTIONS\n");
-    puts(symClassName()+"::"+symClassName()+"("+topClassName()+"* topp, const char* namep)\n");
+    puts(symClassName()+"::"+symClassName()+"("+topClassName()+"* topp, const char* namep,"
+	 " VerilatedContext* contextp)\n");
     puts("\t// Setup locals\n");
-    puts("\t: __Vm_namep(namep)\n");	// No leak, as we get destroyed when the top is destroyed
+    puts("\t: VerilatedSyms(contextp)\n");
+    puts("\t, __Vm_namep(namep)\n");	// No leak, as we get destroyed when the top is destroyed
     if (v3Global.opt.trace()) {
 	puts("\t, __Vm_activity(false)\n");
     }
     puts("\t, __Vm_didInit(false)\n");
+    if (v3Global.opt.profSettle()) {
+	puts("\t, __Vm_settleProf(namep, "+cvtToStr(settleProfNames.size())
+	     +(settleProfNames.empty() ? ", NULL)\n" : ", __Vm_settleProfNames)\n"));
+    }
+    if (v3Global.opt.profBranches()) {
+	puts("\t, __Vm_branchProf(namep, "+cvtToStr(branchProfKeys.size())
+	     +(branchProfKeys.empty() ? ", NULL, NULL)\n" : ", __Vm_branchProfKeys, __Vm_branchProfArms)\n"));
+    }
+    if (AstExecGraph* execGraphp = v3Global.rootp()->execGraphp()) {
+	ExecSchedule schedule (execGraphp->depGraphp());
+	uint32_t activeThreads = 0;
+	for (uint32_t thread = 0; thread < schedule.threads(); ++thread) {
+	    if (!thread || !schedule.thread(thread).empty()) ++activeThreads;
+	}
+	puts("\t, __Vm_even_cycle(false)\n");
+	puts("\t, __Vm_threadPoolp(new VlThreadPool("+cvtToStr(schedule.threads())
+	     +(v3Global.opt.profThreads() ? ", true" : ", false")+"))\n");
+	puts("\t, __Vm_mt_final("+cvtToStr(activeThreads)+")\n");
+	for (const V3GraphVertex* vxp = execGraphp->depGraphp()->verticesBeginp();
+	     vxp; vxp = vxp->verticesNextp()) {
+	    const ExecMTask* mtaskp = static_cast<const ExecMTask*>(vxp);
+	    if (mtaskp->crossThreadDeps()) {
+		puts("\t, "+mtaskp->cVertexName()+"("+cvtToStr(mtaskp->crossThreadDeps())+")\n");
+	    }
+	}
+    }
     puts("\t// Setup submodule names\n");
     char comma=',';
     for (vector<ScopeModPair>::iterator it = m_scopes.begin(); it != m_scopes.end(); ++it) {
@@ -403,6 +496,20 @@ void EmitCSyms::emitSymImp() {
 
     puts("// Pointer to top level\n");
     puts("TOPp = topp;\n");
+    if (v3Global.opt.profThreads() && v3Global.rootp()->execGraphp()) {
+	puts("// Describe the schedule for --prof-threads\n");
+	const V3Graph* depGraphp = v3Global.rootp()->execGraphp()->depGraphp();
+	for (const V3GraphVertex* vxp = depGraphp->verticesBeginp(); vxp; vxp = vxp->verticesNextp()) {
+	    const ExecMTask* mtaskp = static_cast<const ExecMTask*>(vxp);
+	    puts("__Vm_threadPoolp->profileMTask("+cvtToStr(mtaskp->id())+", "+cvtToStr(mtaskp->thread())
+		 +", "+cvtToStr(mtaskp->startTime())+", "+cvtToStr(mtaskp->cost())
+		 +", \""+mtaskp->profKeys()+"\");\n");
+	    for (V3GraphEdge* edgep = vxp->inBeginp(); edgep; edgep = edgep->inNextp()) {
+		const ExecMTask* fromp = static_cast<const ExecMTask*>(edgep->fromp());
+		puts("__Vm_threadPoolp->profileDep("+cvtToStr(fromp->id())+", "+cvtToStr(mtaskp->id())+");\n");
+	    }
+	}
+    }
     puts("// Setup each module's pointers to their submodules\n");
     for (vector<ScopeModPair>::iterator it = m_scopes.begin(); it != m_scopes.end(); ++it) {
 	AstScope* scopep = it->first;  AstNodeModule* modp = it->second;
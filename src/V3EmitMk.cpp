@@ -92,6 +92,9 @@ public:
 		    if (v3Global.opt.coverage()) {
 			putMakeClassEntry(of, "verilated_cov.cpp");
 		    }
+		    if (v3Global.opt.mtasks()) {
+			putMakeClassEntry(of, "verilated_threads.cpp");
+		    }
 		    if (v3Global.opt.trace()) {
 			putMakeClassEntry(of, "verilated_vcd_c.cpp");
 			if (v3Global.opt.systemC()) {
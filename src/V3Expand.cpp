@@ -59,6 +59,11 @@ private:
 	return level;
     }
 
+    static bool leaveToSimd (AstNode* nodep) {
+	// Operations this wide are left whole for the runtime's SIMD kernels
+	// (VL_SIMD_MIN_WORDS in verilatedos.h) rather than unrolled per word
+	return v3Global.opt.wideSimd() && nodep->widthWords() >= VL_SIMD_MIN_WORDS;
+    }
     int longOrQuadWidth (AstNode* nodep) {
 	// Return 32 or 64...
 	return (nodep->width()+(VL_WORDSIZE-1)) & ~(VL_WORDSIZE-1);
@@ -262,6 +267,7 @@ private:
     }
     //-------- Biops
     bool expandWide (AstNodeAssign* nodep, AstAnd* rhsp) {
+	if (leaveToSimd(nodep)) return false;
 	UINFO(8,"    Wordize ASSIGN(AND) "<<nodep<<endl);
 	for (int w=0; w<nodep->widthWords(); w++) {
 	    addWordAssign(nodep, w, new AstAnd (nodep->fileline(),
@@ -271,6 +277,7 @@ private:
 	return true;
     }
     bool expandWide (AstNodeAssign* nodep, AstOr* rhsp) {
+	if (leaveToSimd(nodep)) return false;
 	UINFO(8,"    Wordize ASSIGN(OR) "<<nodep<<endl);
 	for (int w=0; w<nodep->widthWords(); w++) {
 	    addWordAssign(nodep, w, new AstOr (nodep->fileline(),
@@ -280,6 +287,7 @@ private:
 	return true;
     }
     bool expandWide (AstNodeAssign* nodep, AstXor* rhsp) {
+	if (leaveToSimd(nodep)) return false;
 	UINFO(8,"    Wordize ASSIGN(XOR) "<<nodep<<endl);
 	for (int w=0; w<nodep->widthWords(); w++) {
 	    addWordAssign(nodep, w, new AstXor (nodep->fileline(),
@@ -769,7 +777,7 @@ private:
     void visitEqNeq(AstNodeBiop* nodep) {
 	if (nodep->user1SetOnce()) return;  // Process once
 	nodep->iterateChildren(*this);
-	if (nodep->lhsp()->isWide()) {
+	if (nodep->lhsp()->isWide() && !leaveToSimd(nodep->lhsp())) {
 	    UINFO(8,"    Wordize EQ/NEQ "<<nodep<<endl);
 	    // -> (0=={or{for each_word{WORDSEL(lhs,#)^WORDSEL(rhs,#)}}}
 	    AstNode* newp = NULL;
@@ -850,7 +858,7 @@ private:
     virtual void visit(AstRedXor* nodep) {
 	if (nodep->user1SetOnce()) return;  // Process once
 	nodep->iterateChildren(*this);
-	if (nodep->lhsp()->isWide()) {
+	if (nodep->lhsp()->isWide() && !leaveToSimd(nodep->lhsp())) {
 	    UINFO(8,"    Wordize REDXOR "<<nodep<<endl);
 	    // -> (0!={redxor{for each_word{XOR(WORDSEL(lhs,#))}}}
 	    AstNode* newp = NULL;
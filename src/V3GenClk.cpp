@@ -212,6 +212,10 @@ private:
 	nodep->iterateChildren(*this);
 	m_assignp = NULL;
     }
+    virtual void visit(AstSenGate* nodep) {
+	// The gating term is sampled like data, it is not a clock
+	nodep->sensesp()->iterateAndNext(*this);
+    }
     virtual void visit(AstActive* nodep) {
 	UINFO(8,"ACTIVE "<<nodep<<endl);
 	m_activep = nodep;
@@ -28,6 +28,7 @@
 
 #include "verilatedos.h"
 #include <string>
+#include <vector>
 
 #include "V3Error.h"
 #include "V3FileLine.h"
@@ -73,6 +74,10 @@ class V3Global {
     bool	m_needHInlines;		// Need __Inlines file
     bool	m_needHeavy;		// Need verilated_heavy.h include
     bool	m_dpi;			// Need __Dpi include files
+    std::vector<string> m_settleProfNames;	// Change-detected variables, for --prof-settle
+    std::vector<string> m_branchProfKeys;	// Branch points, for --prof-branches
+    std::vector<int> m_branchProfArms;		// Arms of each branch point, for --prof-branches
+    int		m_branchProfCounters;	// Counters of all branch points, for --prof-branches
 
 public:
     // Options
@@ -88,6 +93,7 @@ public:
 	m_needHInlines = false;
 	m_needHeavy = false;
 	m_dpi = false;
+	m_branchProfCounters = 0;
 	m_rootp = NULL;  // created by makeInitNetlist() so static constructors run first
     }
     AstNetlist* makeNetlist();
@@ -118,6 +124,21 @@ public:
     void needHeavy(bool flag) { m_needHeavy=flag; }
     bool dpi() const { return m_dpi; }
     void dpi(bool flag) { m_dpi = flag; }
+    // Add a change-detected variable, returning its --prof-settle counter number
+    int addSettleProfName(const string& name) {
+	m_settleProfNames.push_back(name);
+	return static_cast<int>(m_settleProfNames.size()) - 1;
+    }
+    const std::vector<string>& settleProfNames() const { return m_settleProfNames; }
+    // Add a branch point, returning the --prof-branches counter number of its first arm
+    int addBranchProf(const string& key, int arms) {
+	m_branchProfKeys.push_back(key);
+	m_branchProfArms.push_back(arms);
+	m_branchProfCounters += arms;
+	return m_branchProfCounters - arms;
+    }
+    const std::vector<string>& branchProfKeys() const { return m_branchProfKeys; }
+    const std::vector<int>& branchProfArms() const { return m_branchProfArms; }
 };
 
 extern V3Global v3Global;
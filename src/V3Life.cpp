@@ -370,6 +370,21 @@ private:
 	delete elseLifep;
     }
 
+    virtual void visit(AstExecGraph* nodep) {
+	// Mtasks may run in parallel, so each starts without knowledge of
+	// the others, as if it were the branch of an if
+	LifeBlock* prevLifep = m_lifep;
+	for (AstMTaskBody* bodyp = nodep->mTaskBodiesp(); bodyp;
+	     bodyp = bodyp->nextp()->castMTaskBody()) {
+	    LifeBlock* bodyLifep = new LifeBlock (prevLifep, m_statep);
+	    m_lifep = bodyLifep;
+	    bodyp->stmtsp()->iterateAndNext(*this);
+	    m_lifep = prevLifep;
+	    bodyLifep->lifeToAbove();
+	    delete bodyLifep;
+	}
+    }
+
     virtual void visit(AstWhile* nodep) {
 	// While's are a problem, as we don't allow loops in the graph.  We
 	// may go around the cond/body multiple times.  Thus a
@@ -665,19 +665,24 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
 	    else if ( !strcmp (sw, "-debug-fatalsrc") )		{ v3fatalSrc("--debug-fatal-src"); }  // Undocumented, see also --debug-abort
 	    else if ( onoff   (sw, "-decoration", flag/*ref*/) ) { m_decoration = flag; }
 	    else if ( onoff   (sw, "-dump-tree", flag/*ref*/) )	{ m_dumpTree = flag ? 3 : 0; }  // Also see --dump-treei
+	    else if ( onoff   (sw, "-eval-clk", flag/*ref*/) )	{ m_evalClk = flag; }
 	    else if ( onoff   (sw, "-exe", flag/*ref*/) )	{ m_exe = flag; }
 	    else if ( onoff   (sw, "-ignc", flag/*ref*/) )	{ m_ignc = flag; }
 	    else if ( onoff   (sw, "-inhibit-sim", flag/*ref*/)){ m_inhibitSim = flag; }
 	    else if ( onoff   (sw, "-lint-only", flag/*ref*/) )	{ m_lintOnly = flag; }
 	    else if ( !strcmp (sw, "-no-pins64") )		{ m_pinsBv = 33; }
+	    else if ( onoff   (sw, "-order-activity", flag/*ref*/) )	{ m_orderActivity = flag; }
 	    else if ( onoff   (sw, "-order-clock-delay", flag/*ref*/) )	{ m_orderClockDly = flag; }
 	    else if ( !strcmp (sw, "-pins64") )			{ m_pinsBv = 65; }
 	    else if ( onoff   (sw, "-pins-sc-uint", flag/*ref*/) ){ m_pinsScUint = flag; if (!m_pinsScBigUint) m_pinsBv = 65; }
 	    else if ( onoff   (sw, "-pins-sc-biguint", flag/*ref*/) ){ m_pinsScBigUint = flag; m_pinsBv = 513; }
 	    else if ( onoff   (sw, "-pins-uint8", flag/*ref*/) ){ m_pinsUint8 = flag; }
 	    else if ( !strcmp (sw, "-private") )		{ m_public = false; }
+            else if ( onoff   (sw, "-prof-branches", flag/*ref*/) )     { m_profBranches = flag; }
             else if ( onoff   (sw, "-prof-cfuncs", flag/*ref*/) )       { m_profCFuncs = flag; }
             else if ( onoff   (sw, "-profile-cfuncs", flag/*ref*/) )    { m_profCFuncs = flag; }  // Undocumented, for backward compat
+            else if ( onoff   (sw, "-prof-settle", flag/*ref*/) )       { m_profSettle = flag; }
+            else if ( onoff   (sw, "-prof-threads", flag/*ref*/) )      { m_profThreads = flag; }
 	    else if ( onoff   (sw, "-public", flag/*ref*/) )		{ m_public = flag; }
             else if ( !strncmp(sw, "-pvalue+", strlen("-pvalue+")))	{ addParameter(string(sw+strlen("-pvalue+")), false); }
             else if ( onoff   (sw, "-relative-cfuncs", flag/*ref*/) )   { m_relativeCFuncs = flag; }
@@ -689,6 +694,7 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
 	    else if ( onoff   (sw, "-stats", flag/*ref*/) )		{ m_stats = flag; }
 	    else if ( onoff   (sw, "-stats-vars", flag/*ref*/) )	{ m_statsVars = flag; m_stats |= flag; }
 	    else if ( !strcmp (sw, "-sv") )				{ m_defaultLanguage = V3LangCode::L1800_2005; }
+	    else if ( onoff   (sw, "-threads-var-layout", flag/*ref*/) ) { m_threadsVarLayout = flag; }
 	    else if ( onoff   (sw, "-trace", flag/*ref*/) )		{ m_trace = flag; }
 	    else if ( onoff   (sw, "-trace-dups", flag/*ref*/) )	{ m_traceDups = flag; }
 	    else if ( onoff   (sw, "-trace-params", flag/*ref*/) )	{ m_traceParams = flag; }
@@ -696,6 +702,7 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
 	    else if ( onoff   (sw, "-trace-underscore", flag/*ref*/) )	{ m_traceUnderscore = flag; }
 	    else if ( onoff   (sw, "-underline-zero", flag/*ref*/) )	{ m_underlineZero = flag; }  // Undocumented, old Verilator-2
 	    else if ( onoff   (sw, "-vpi", flag/*ref*/) )		{ m_vpi = flag; }
+	    else if ( onoff   (sw, "-wide-simd", flag/*ref*/) )		{ m_wideSimd = flag; }
 	    else if ( onoff   (sw, "-x-initial-edge", flag/*ref*/) )	{ m_xInitialEdge = flag; }
 	    else if ( onoff   (sw, "-xml-only", flag/*ref*/) )		{ m_xmlOnly = flag; }  // Undocumented, still experimental
 	    // Optimization
@@ -716,13 +723,17 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
 		    case 'f': m_oFlopGater = flag; break;
 		    case 'g': m_oGate = flag; break;
 		    case 'i': m_oInline = flag; break;
+		    case 'j': m_oGenClkSame = flag; break;
 		    case 'k': m_oSubstConst = flag; break;
 		    case 'l': m_oLife = flag; break;
 		    case 'p': m_public = !flag; break;  //With -Op so flag=0, we want public on so few optimizations done
+		    case 'q': m_oDlyLog = flag; break;
 		    case 'r': m_oReorder = flag; break;
 		    case 's': m_oSplit = flag; break;
 		    case 't': m_oLifePost = flag; break;
 		    case 'u': m_oSubst = flag; break;
+		    case 'v': m_oSplitVar = flag; break;
+		    case 'w': m_oChangeDirty = flag; break;
 		    case 'x': m_oExpand = flag; break;
 		    case 'y': m_oAcycSimp = flag; break;
 		    case 'z': m_oLocalize = flag; break;
@@ -783,6 +794,9 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
 		shift;
 		V3Error::errorLimit(atoi(argv[i]));
 	    }
+	    else if ( !strcmp (sw, "-eval-cycles") && (i+1)<argc ) {
+		shift; m_evalCycles = argv[i];
+	    }
 	    else if ( !strcmp (sw, "-FI") && (i+1)<argc ) {
 		shift;
 		addForceInc(parseFileArg(optdir, string (argv[i])));
@@ -1007,8 +1021,14 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
 		shift; m_prefix = argv[i];
 		if (m_modPrefix=="") m_modPrefix = m_prefix;
 	    }
-	    else if ( !strcmp (sw, "-no-threads") ) { m_threads = 0; }  // Undocumented until functional
-	    else if ( !strcmp (sw, "-threads") && (i+1)<argc ) {  // Undocumented until functional
+	    else if ( !strcmp (sw, "-prof-branches-data") && (i+1)<argc ) {
+		shift; m_profBranchesData = argv[i];
+	    }
+	    else if ( !strcmp (sw, "-prof-threads-data") && (i+1)<argc ) {
+		shift; m_profThreadsData = argv[i];
+	    }
+	    else if ( !strcmp (sw, "-no-threads") ) { m_threads = 0; }
+	    else if ( !strcmp (sw, "-threads") && (i+1)<argc ) {
 		shift; m_threads = atoi(argv[i]);
 		if (m_threads < 0) fl->v3fatal("--threads must be >= 0: "<<argv[i]);
 	    }
@@ -1223,19 +1243,24 @@ V3Options::V3Options() {
     m_debugCheck = false;
     m_debugLeak = true;
     m_decoration = true;
+    m_evalClk = false;
     m_exe = false;
     m_ignc = false;
     m_inhibitSim = false;
     m_lintOnly = false;
     m_makeDepend = true;
     m_makePhony = false;
+    m_orderActivity = false;
     m_orderClockDly = true;
     m_outFormatOk = false;
     m_pinsBv = 65;
     m_pinsScUint = false;
     m_pinsScBigUint = false;
     m_pinsUint8 = false;
+    m_profBranches = false;
     m_profCFuncs = false;
+    m_profSettle = false;
+    m_profThreads = false;
     m_preprocOnly = false;
     m_preprocNoLine = false;
     m_public = false;
@@ -1248,6 +1273,7 @@ V3Options::V3Options() {
     m_statsVars = false;
     m_systemC = false;
     m_threads = 0;
+    m_threadsVarLayout = false;
     m_trace = false;
     m_traceDups = false;
     m_traceParams = true;
@@ -1255,6 +1281,11 @@ V3Options::V3Options() {
     m_traceUnderscore = false;
     m_underlineZero = false;
     m_vpi = false;
+#if defined(__x86_64__)
+    m_wideSimd = true;  // Presume the model is compiled for this host
+#else
+    m_wideSimd = false;
+#endif
     m_xInitialEdge = false;
     m_xmlOnly = false;
 
@@ -1361,17 +1392,21 @@ void V3Options::optimize(int level) {
     m_oExpand = flag;
     m_oFlopGater = flag;
     m_oGate = flag;
+    m_oGenClkSame = flag;
     m_oInline = flag;
     m_oLife = flag;
     m_oLifePost = flag;
     m_oLocalize = flag;
     m_oReorder = flag;
     m_oSplit = flag;
+    m_oSplitVar = flag;
     m_oSubst = flag;
     m_oSubstConst = flag;
     m_oTable = flag;
     m_oDedupe = flag;
+    m_oDlyLog = flag;
     m_oAssemble = flag;
+    m_oChangeDirty = flag;
     // And set specific optimization levels
     if (level >= 3) {
 	m_inlineMult = -1;	// Maximum inlining
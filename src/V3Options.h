@@ -77,16 +77,21 @@ class V3Options {
     bool	m_debugCheck;	// main switch: --debug-check
     bool        m_debugLeak;   // main switch: --debug-leak
     bool	m_decoration;	// main switch: --decoration
+    bool	m_evalClk;	// main switch: --eval-clk
     bool	m_exe;		// main switch: --exe
     bool	m_ignc;		// main switch: --ignc
     bool	m_inhibitSim;	// main switch: --inhibit-sim
     bool	m_lintOnly;	// main switch: --lint-only
+    bool	m_orderActivity;// main switch: --order-activity
     bool	m_orderClockDly;// main switch: --order-clock-delay
     bool	m_outFormatOk;	// main switch: --cc, --sc or --sp was specified
     bool	m_pinsScUint;   // main switch: --pins-sc-uint
     bool	m_pinsScBigUint;// main switch: --pins-sc-biguint
     bool	m_pinsUint8;	// main switch: --pins-uint8
+    bool        m_profBranches; // main switch: --prof-branches
     bool        m_profCFuncs;   // main switch: --prof-cfuncs
+    bool        m_profSettle;   // main switch: --prof-settle
+    bool        m_profThreads;  // main switch: --prof-threads
     bool	m_public;	// main switch: --public
     bool	m_relativeCFuncs; // main switch: --relative-cfuncs
     bool	m_relativeIncludes; // main switch: --relative-includes
@@ -96,6 +101,7 @@ class V3Options {
     bool	m_skipIdentical;// main switch: --skip-identical
     bool	m_stats;	// main switch: --stats
     bool	m_statsVars;	// main switch: --stats-vars
+    bool	m_threadsVarLayout; // main switch: --threads-var-layout
     bool	m_trace;	// main switch: --trace
     bool	m_traceDups;	// main switch: --trace-dups
     bool	m_traceParams;	// main switch: --trace-params
@@ -103,6 +109,7 @@ class V3Options {
     bool	m_traceUnderscore;// main switch: --trace-underscore
     bool	m_underlineZero;// main switch: --underline-zero; undocumented old Verilator 2
     bool	m_vpi;		// main switch: --vpi
+    bool	m_wideSimd;	// main switch: --wide-simd
     bool	m_xInitialEdge;	// main switch: --x-initial-edge
     bool	m_xmlOnly;	// main switch: --xml-netlist
 
@@ -128,6 +135,7 @@ class V3Options {
     int         m_compLimitParens;  // compiler selection; number of nested parens
 
     string	m_bin;		// main switch: --bin {binary}
+    string	m_evalCycles;	// main switch: --eval-cycles {clock}
     string	m_exeName;	// main switch: -o {name}
     string	m_flags;	// main switch: -f {name}
     string	m_l2Name;	// main switch: --l2name; "" for top-module's name
@@ -135,6 +143,8 @@ class V3Options {
     string	m_modPrefix;	// main switch: --mod-prefix
     string	m_pipeFilter;	// main switch: --pipe-filter
     string	m_prefix;	// main switch: --prefix
+    string	m_profBranchesData;	// main switch: --prof-branches-data
+    string	m_profThreadsData;	// main switch: --prof-threads-data
     string	m_topModule;	// main switch: --top-module
     string	m_unusedRegexp;	// main switch: --unused-regexp
     string	m_xAssign;	// main switch: --x-assign
@@ -151,16 +161,20 @@ class V3Options {
     bool	m_oCombine;	// main switch: -Ob: common icode packing
     bool	m_oConst;	// main switch: -Oc: constant folding
     bool	m_oDedupe;	// main switch: -Od: logic deduplication
+    bool	m_oDlyLog;	// main switch: -Oq: delayed array write logs
     bool	m_oAssemble;	// main switch: -Om: assign assemble
+    bool	m_oChangeDirty;	// main switch: -Ow: dirty flags for change detection
     bool	m_oExpand;	// main switch: -Ox: expansion of C macros
     bool	m_oFlopGater;	// main switch: -Of: flop gater detection
     bool	m_oGate;	// main switch: -Og: gate wire elimination
+    bool	m_oGenClkSame;	// main switch: -Oj: generated clock domains in the same eval pass
     bool	m_oLife;	// main switch: -Ol: variable lifetime
     bool	m_oLifePost;	// main switch: -Ot: delayed assignment elimination
     bool	m_oLocalize;	// main switch: -Oz: convert temps to local variables
     bool	m_oInline;	// main switch: -Oi: module inlining
     bool	m_oReorder;	// main switch: -Or: reorder assignments in blocks
     bool	m_oSplit;	// main switch: -Os: always assignment splitting
+    bool	m_oSplitVar;	// main switch: -Ov: packed variable splitting
     bool	m_oSubst;	// main switch: -Ou: substitute expression temp values
     bool	m_oSubstConst;	// main switch: -Ok: final constant substitution
     bool	m_oTable;	// main switch: -Oa: lookup table creation
@@ -219,6 +233,7 @@ class V3Options {
     bool skipIdentical() const { return m_skipIdentical; }
     bool stats() const { return m_stats; }
     bool statsVars() const { return m_statsVars; }
+    bool threadsVarLayout() const { return m_threadsVarLayout; }
     bool assertOn() const { return m_assert; }  // assertOn as __FILE__ may be defined
     bool autoflush() const { return m_autoflush; }
     bool bboxSys() const { return m_bboxSys; }
@@ -232,19 +247,24 @@ class V3Options {
     bool debugCheck() const { return m_debugCheck; }
     bool debugLeak() const { return m_debugLeak; }
     bool decoration() const { return m_decoration; }
+    bool evalClk() const { return m_evalClk; }
     bool exe() const { return m_exe; }
     bool trace() const { return m_trace; }
     bool traceDups() const { return m_traceDups; }
     bool traceParams() const { return m_traceParams; }
     bool traceStructs() const { return m_traceStructs; }
     bool traceUnderscore() const { return m_traceUnderscore; }
+    bool orderActivity() const { return m_orderActivity; }
     bool orderClockDly() const { return m_orderClockDly; }
     bool outFormatOk() const { return m_outFormatOk; }
     bool keepTempFiles() const { return (V3Error::debugDefault()!=0); }
     bool pinsScUint() const { return m_pinsScUint; }
     bool pinsScBigUint() const { return m_pinsScBigUint; }
     bool pinsUint8() const { return m_pinsUint8; }
+    bool profBranches() const { return m_profBranches; }
     bool profCFuncs() const { return m_profCFuncs; }
+    bool profSettle() const { return m_profSettle; }
+    bool profThreads() const { return m_profThreads; }
     bool allPublic() const { return m_public; }
     bool lintOnly() const { return m_lintOnly; }
     bool ignc() const { return m_ignc; }
@@ -252,6 +272,7 @@ class V3Options {
     bool relativeCFuncs() const { return m_relativeCFuncs; }
     bool reportUnoptflat() const { return m_reportUnoptflat; }
     bool vpi() const { return m_vpi; }
+    bool wideSimd() const { return m_wideSimd; }
     bool xInitialEdge() const { return m_xInitialEdge; }
     bool xmlOnly() const { return m_xmlOnly; }
 
@@ -277,12 +298,15 @@ class V3Options {
     int    compLimitMembers() const { return m_compLimitMembers; }
     int    compLimitParens() const { return m_compLimitParens; }
 
+    string evalCycles() const { return m_evalCycles; }
     string exeName() const { return m_exeName!="" ? m_exeName : prefix(); }
     string l2Name() const { return m_l2Name; }
     string makeDir() const { return m_makeDir; }
     string modPrefix() const { return m_modPrefix; }
     string pipeFilter() const { return m_pipeFilter; }
     string prefix() const { return m_prefix; }
+    string profBranchesData() const { return m_profBranchesData; }
+    string profThreadsData() const { return m_profThreadsData; }
     string topModule() const { return m_topModule; }
     string unusedRegexp() const { return m_unusedRegexp; }
     string xAssign() const { return m_xAssign; }
@@ -311,10 +335,13 @@ class V3Options {
     bool oCombine() const { return m_oCombine; }
     bool oConst() const { return m_oConst; }
     bool oDedupe() const { return m_oDedupe; }
+    bool oDlyLog() const { return m_oDlyLog; }
     bool oAssemble() const { return m_oAssemble; }
+    bool oChangeDirty() const { return m_oChangeDirty; }
     bool oExpand() const { return m_oExpand; }
     bool oFlopGater() const { return m_oFlopGater; }
     bool oGate() const { return m_oGate; }
+    bool oGenClkSame() const { return m_oGenClkSame; }
     bool oDup() const { return oLife(); }
     bool oLife() const { return m_oLife; }
     bool oLifePost() const { return m_oLifePost; }
@@ -322,6 +349,7 @@ class V3Options {
     bool oInline() const { return m_oInline; }
     bool oReorder() const { return m_oReorder; }
     bool oSplit() const { return m_oSplit; }
+    bool oSplitVar() const { return m_oSplitVar; }
     bool oSubst() const { return m_oSubst; }
     bool oSubstConst() const { return m_oSubstConst; }
     bool oTable() const { return m_oTable; }
@@ -85,6 +85,7 @@
 #include <vector>
 #include <deque>
 #include <map>
+#include <set>
 #include <iomanip>
 #include <sstream>
 #include <memory>
@@ -102,6 +103,8 @@
 #include "V3Order.h"
 #include "V3OrderGraph.h"
 #include "V3EmitV.h"
+#include "V3Partition.h"
+#include "V3PartitionGraph.h"
 
 class OrderMoveDomScope;
 
@@ -419,6 +422,140 @@ public:
 };
 
 
+//######################################################################
+// For --order-activity, the inputs of a combo region: variables it reads
+// before it has unconditionally assigned them itself
+
+class OrderRegionVisitor : public AstNVisitor {
+private:
+    // STATE
+    AstCFunc*		m_funcp;	// Region being examined
+    bool		m_gatable;	// No side effects or hidden reads
+    int			m_depth;	// Conditional statement depth, 0=unconditional
+    int			m_nodes;	// Size of the region
+    vector<AstVarScope*> m_inputs;	// Inputs, in order first read
+    set<AstVarScope*>	m_inputSet;	// Inputs already in m_inputs
+    set<AstVarScope*>	m_assigned;	// Unconditionally assigned so far
+    set<AstVarScope*>	m_writes;	// All variables written
+
+    // METHODS
+    static int debug() {
+	static int level = -1;
+	if (VL_UNLIKELY(level < 0)) level = v3Global.opt.debugSrcLevel(__FILE__);
+	return level;
+    }
+    virtual void visit(AstNodeAssign* nodep) {
+	++m_nodes;
+	nodep->rhsp()->iterateAndNext(*this);
+	nodep->lhsp()->iterateAndNext(*this);
+	if (m_depth == 0) {
+	    if (AstVarRef* varrefp = nodep->lhsp()->castVarRef()) m_assigned.insert(varrefp->varScopep());
+	}
+    }
+    virtual void visit(AstAlways* nodep) {
+	++m_nodes;
+	nodep->iterateChildren(*this);
+    }
+    virtual void visit(AstVarRef* nodep) {
+	++m_nodes;
+	AstVarScope* vscp = nodep->varScopep();
+	if (!vscp) { m_gatable = false; return; }
+	if (nodep->lvalue()) {
+	    m_writes.insert(vscp);
+	} else if (!m_assigned.count(vscp) && !m_inputSet.count(vscp)) {
+	    if (vscp->varp()->dtypeSkipRefp()->castUnpackArrayDType()
+		|| vscp->varp()->isString()) {
+		UINFO(5,"     Ungatable input "<<vscp<<endl);
+		m_gatable = false;
+	    }
+	    m_inputSet.insert(vscp);
+	    m_inputs.push_back(vscp);
+	}
+    }
+    virtual void visit(AstNode* nodep) {
+	++m_nodes;
+	if (!nodep->isPure()
+	    || nodep->castNodeFTaskRef() || nodep->castCCall()
+	    || nodep->castCMath() || nodep->castCStmt()
+	    || nodep->castUCFunc() || nodep->castUCStmt()
+	    || nodep->castRand() || nodep->castTime() || nodep->castTimeD()
+	    || nodep->castScopeName() || nodep->castVarXRef()) {
+	    UINFO(5,"     Ungatable "<<nodep<<endl);
+	    m_gatable = false;
+	}
+	++m_depth;
+	nodep->iterateChildren(*this);
+	--m_depth;
+    }
+public:
+    // CONSTUCTORS
+    explicit OrderRegionVisitor(AstCFunc* funcp) {
+	m_funcp = funcp;
+	m_gatable = true;
+	m_depth = 0;
+	m_nodes = 0;
+	funcp->stmtsp()->iterateAndNext(*this);
+    }
+    virtual ~OrderRegionVisitor() {}
+
+    // METHODS
+    bool gatable() const { return m_gatable; }
+    int nodes() const { return m_nodes; }
+    const vector<AstVarScope*>& inputs() const { return m_inputs; }
+    const set<AstVarScope*>& writes() const { return m_writes; }
+    // Words compared to check the inputs
+    int inputWords() const {
+	int words = 0;
+	for (vector<AstVarScope*>::const_iterator it = m_inputs.begin(); it != m_inputs.end(); ++it) {
+	    words += (*it)->varp()->isDouble() ? 2 : (*it)->varp()->widthWords();
+	}
+	return words;
+    }
+};
+
+
+//######################################################################
+// For --order-activity, the functions writing each variable; a region
+// skipped must not leave behind a value some other writer clobbered
+
+class OrderWritersVisitor : public AstNVisitor {
+public:
+    typedef map<AstVarScope*, set<AstCFunc*> > WritersMap;
+private:
+    // STATE
+    AstCFunc*		m_funcp;	// Current function, NULL outside any
+    WritersMap		m_writers;	// Functions writing each variable
+
+    // METHODS
+    virtual void visit(AstCFunc* nodep) {
+	m_funcp = nodep;
+	nodep->iterateChildren(*this);
+	m_funcp = NULL;
+    }
+    virtual void visit(AstVarRef* nodep) {
+	if (nodep->lvalue() && nodep->varScopep()) m_writers[nodep->varScopep()].insert(m_funcp);
+    }
+    virtual void visit(AstNode* nodep) {
+	nodep->iterateChildren(*this);
+    }
+public:
+    // CONSTUCTORS
+    explicit OrderWritersVisitor(AstNode* nodep) {
+	m_funcp = NULL;
+	nodep->accept(*this);
+    }
+    virtual ~OrderWritersVisitor() {}
+
+    // METHODS
+    // True if functions other than funcp write the variable
+    bool otherWriter(AstVarScope* vscp, AstCFunc* funcp) const {
+	WritersMap::const_iterator it = m_writers.find(vscp);
+	if (it == m_writers.end()) return false;
+	return it->second.size() > 1 || !it->second.count(funcp);
+    }
+};
+
+
 //######################################################################
 // Order class functions
 
@@ -456,6 +593,7 @@ private:
     AstScope*		m_scopep;	// Current scope being processed
     AstActive*		m_activep;	// Current activation block
     bool		m_inSenTree;	// Underneath AstSenItem; any varrefs are clocks
+    bool		m_inSenGate;	// Underneath AstSenGate's gating term
     bool		m_inClocked;	// Underneath clocked block
     bool		m_inClkAss;	// Underneath AstAssign
     bool		m_inPre;	// Underneath AstAssignPre
@@ -467,6 +605,14 @@ private:
     int				m_pomNewStmts;	// Statements in function being created
     V3Graph			m_pomGraph;	// Graph of logic elements to move
     V3List<OrderMoveVertex*>	m_pomWaiting;	// List of nodes needing inputs to become ready
+    struct MTaskFunc {
+	AstCFunc*		m_funcp;	// Function last created for the mtask
+	OrderMoveDomScope*	m_domScopep;	// Domain and scope of that function
+	int			m_stmts;	// Statements in that function
+	MTaskFunc() : m_funcp(NULL), m_domScopep(NULL), m_stmts(0) {}
+    };
+    map<const ExecMTask*, MTaskFunc> m_pomMTaskFuncs;	// Per-mtask function being created
+    vector<AstCCall*>		m_pomComboCalls;	// Calls of combo functions, for --order-activity
 protected:
     friend class OrderMoveDomScope;
     V3List<OrderMoveDomScope*>  m_pomReadyDomScope;	// List of ready domain/scope pairs, by loopId
@@ -475,6 +621,8 @@ protected:
 private:
     // STATS
     V3Double0		m_statCut[OrderVEdgeType::_ENUM_END];	// Count of each edge type cut
+    V3Double0		m_statActivityGated;	// Combo regions gated on input activity
+    V3Double0		m_statGenClkSame;	// Generated clocks consumed in the same eval pass
 
     // TYPES
     enum VarUsage { VU_NONE=0, VU_CON=1, VU_GEN=2 };
@@ -520,6 +668,9 @@ private:
 
     void process();
     void processCircular();
+    typedef std::map<AstVarScope*, std::set<AstSenTree*> > GenDomainMap;
+    void processGenDomains(GenDomainMap& genDomains);
+    bool processClockSamePass(OrderVarStdVertex* clkVxp, const GenDomainMap& genDomains);
     typedef deque<OrderEitherVertex*> VertexVec;
     void processInputs();
     void processInputsInIterate(OrderEitherVertex* vertexp, VertexVec& todoVec);
@@ -530,6 +681,7 @@ private:
     void processEdgeReport();
 
     void processMove();
+    void processActivity();
     void processMoveClear();
     void processMoveBuildGraph();
     void processMoveBuildGraphIterate (OrderMoveVertex* moveVxp, V3GraphVertex* vertexp, int weightmin);
@@ -538,6 +690,7 @@ private:
     void processMoveReadyOne(OrderMoveVertex* vertexp);
     void processMoveDoneOne(OrderMoveVertex* vertexp);
     void processMoveOne(OrderMoveVertex* vertexp, OrderMoveDomScope* domScopep, int level);
+    void processPartition();
     static bool domainsExclusive(const AstSenTree* fromp, const AstSenTree* top);
 
     string cfuncName(AstNodeModule* modp, AstSenTree* domainp, AstScope* scopep, AstNode* forWhatp) {
@@ -777,7 +930,15 @@ private:
 	if (m_scopep) {
 	    AstVarScope* varscp = nodep->varScopep();
 	    if (!varscp) nodep->v3fatalSrc("Var didn't get varscoped in V3Scope.cpp");
-	    if (m_inSenTree) {
+	    if (m_inSenGate) {
+		// Gating term is sampled with the clock edge, like a
+		// sequential consumer; it is not itself a clock.
+		if (nodep->lvalue()) nodep->v3fatalSrc("How can a sensitivity be setting a var?");
+		OrderVarVertex* preVxp = newVarUserVertex(varscp, WV_PRE);
+		new OrderEdge(&m_graph, m_activeSenVxp, preVxp, WEIGHT_NORMAL);
+		OrderVarVertex* postVxp = newVarUserVertex(varscp, WV_POST);
+		new OrderEdge(&m_graph, m_activeSenVxp, postVxp, WEIGHT_POST);
+	    } else if (m_inSenTree) {
 		// Add CLOCK dependency... This is a root of the tree we'll trace
 		if (nodep->lvalue()) nodep->v3fatalSrc("How can a sensitivity be setting a var?");
 		OrderVarVertex* varVxp = newVarUserVertex(varscp, WV_STD);
@@ -911,6 +1072,12 @@ private:
 	    m_inSenTree = false;
 	}
     }
+    virtual void visit(AstSenGate* nodep) {
+	nodep->sensesp()->iterateAndNext(*this);
+	m_inSenGate = true;
+	nodep->rhsp()->iterateAndNext(*this);
+	m_inSenGate = false;
+    }
     virtual void visit(AstAlways* nodep) {
 	iterateNewStmt(nodep);
     }
@@ -975,6 +1142,7 @@ public:
 	m_scopep = NULL;
 	m_activep = NULL;
 	m_inSenTree = false;
+	m_inSenGate = false;
 	m_inClocked = false;
 	m_inClkAss = false;
 	m_inPre = m_inPost = false;
@@ -997,6 +1165,8 @@ public:
 		V3Stats::addStat(string("Order, cut, ")+OrderVEdgeType(type).ascii(), count);
 	    }
 	}
+	V3Stats::addStat("Optimizations, Activity gated regions", m_statActivityGated);
+	V3Stats::addStat("Optimizations, Generated clocks in same pass", m_statGenClkSame);
 	// Destruction
 	for (deque<OrderUser*>::iterator it=m_orderUserps.begin(); it!=m_orderUserps.end(); ++it) {
 	    delete *it;
@@ -1090,9 +1260,87 @@ void OrderVisitor::processInputsOutIterate(OrderEitherVertex* vertexp, VertexVec
 //######################################################################
 // Circular detection
 
+void OrderVisitor::processGenDomains(GenDomainMap& genDomains) {
+    // For each variable, the domains of the logic generating it during
+    // clock evaluation; NULL for combo logic.  Initial and settle logic
+    // don't run in the same eval pass as clocked logic, so are excluded.
+    for (V3GraphVertex* itp = m_graph.verticesBeginp(); itp; itp=itp->verticesNextp()) {
+	OrderLogicVertex* lvertexp = dynamic_cast<OrderLogicVertex*>(itp);
+	if (!lvertexp || lvertexp->nodep()->castActive()) continue;
+	AstSenTree* domainp = lvertexp->domainp();
+	if (domainp && !domainp->hasClocked()) continue;
+	for (V3GraphEdge* edgep = lvertexp->outBeginp(); edgep; edgep=edgep->outNextp()) {
+	    if (OrderVarStdVertex* vvertexp = dynamic_cast<OrderVarStdVertex*>(edgep->top())) {
+		genDomains[vvertexp->varScp()].insert(domainp);
+	    }
+	}
+    }
+}
+
+bool OrderVisitor::processClockSamePass(OrderVarStdVertex* clkVxp, const GenDomainMap& genDomains) {
+    // A clock generated by a delayed assignment normally needs another
+    // eval pass to see its edge, so its domain reads the values after
+    // all of this pass's NBAs.  Instead the domain may run in this pass,
+    // ordered after the generating logic, if all it reads is generated
+    // by the domain itself, thus is not updated by this pass beforehand.
+    if (clkVxp->varScp()->varp()->isSigPublic()) return false;  // May be set externally
+    GenDomainMap::const_iterator clkit = genDomains.find(clkVxp->varScp());
+    if (clkit == genDomains.end()) return false;
+    for (V3GraphEdge* edgep = clkVxp->inBeginp(); edgep; edgep = edgep->inNextp()) {
+	if (edgep->weight()==0) return false;  // Generator was cut from the clock
+    }
+    std::set<AstSenTree*> clkDomains;  // Domains clocked by only this clock
+    for (V3GraphEdge* edgep = clkVxp->outBeginp(); edgep; edgep=edgep->outNextp()) {
+	OrderLogicVertex* senVxp = dynamic_cast<OrderLogicVertex*>(edgep->top());
+	if (!senVxp || !senVxp->nodep()->castActive()) continue;  // Not a sensitivity
+	if (edgep->weight()==0) return false;
+	for (V3GraphEdge* senEdgep = senVxp->inBeginp(); senEdgep; senEdgep = senEdgep->inNextp()) {
+	    if (senEdgep->fromp() != clkVxp) return false;
+	}
+	// Clock generated in the domain it clocks must see itself change
+	if (clkit->second.count(senVxp->domainp())) return false;
+	clkDomains.insert(senVxp->domainp());
+    }
+    if (clkDomains.empty()) return false;
+    for (V3GraphVertex* itp = m_graph.verticesBeginp(); itp; itp=itp->verticesNextp()) {
+	OrderLogicVertex* lvertexp = dynamic_cast<OrderLogicVertex*>(itp);
+	if (!lvertexp || lvertexp->nodep()->castActive()
+	    || !clkDomains.count(lvertexp->domainp())) continue;
+	// Sequential consumers point to the consumed var's pre/post vertices,
+	// pre and post logic consumers are pointed to like combo logic
+	std::vector<OrderVarVertex*> consumedps;
+	for (V3GraphEdge* edgep = lvertexp->outBeginp(); edgep; edgep=edgep->outNextp()) {
+	    if (dynamic_cast<OrderVarPreVertex*>(edgep->top())
+		|| dynamic_cast<OrderVarPostVertex*>(edgep->top())) {
+		consumedps.push_back(static_cast<OrderVarVertex*>(edgep->top()));
+	    }
+	}
+	for (V3GraphEdge* edgep = lvertexp->inBeginp(); edgep; edgep=edgep->inNextp()) {
+	    if (dynamic_cast<OrderVarStdVertex*>(edgep->fromp())
+		|| dynamic_cast<OrderVarPreVertex*>(edgep->fromp())) {
+		consumedps.push_back(static_cast<OrderVarVertex*>(edgep->fromp()));
+	    }
+	}
+	for (std::vector<OrderVarVertex*>::iterator it = consumedps.begin(); it != consumedps.end(); ++it) {
+	    GenDomainMap::const_iterator genit = genDomains.find((*it)->varScp());
+	    if (genit == genDomains.end()) continue;  // Input or constant
+	    for (std::set<AstSenTree*>::const_iterator dit = genit->second.begin();
+		 dit != genit->second.end(); ++dit) {
+		if (*dit != lvertexp->domainp()) {
+		    UINFO(5,"Generated clock "<<clkVxp<<" domain reads "<<(*it)->varScp()<<endl);
+		    return false;
+		}
+	    }
+	}
+    }
+    return true;
+}
+
 void OrderVisitor::processCircular() {
     // Take broken edges and add circular flags
     // The change detect code will use this to force changedets
+    GenDomainMap genDomains;
+    if (v3Global.opt.oGenClkSame()) processGenDomains(genDomains);
     for (V3GraphVertex* itp = m_graph.verticesBeginp(); itp; itp=itp->verticesNextp()) {
 	if (OrderVarStdVertex* vvertexp = dynamic_cast<OrderVarStdVertex*>(itp)) {
 	    if (vvertexp->isClock() && !vvertexp->isFromInput()) {
@@ -1108,6 +1356,12 @@ void OrderVisitor::processCircular() {
 		    UINFO(5,"Circular Clock, no-order-clock-delay "<<vvertexp<<endl);
 		    nodeMarkCircular(vvertexp, NULL);
 		}
+		else if (vvertexp->isDelayed()
+			 && v3Global.opt.oGenClkSame()
+			 && processClockSamePass(vvertexp, genDomains)) {
+		    UINFO(5,"Circular Clock, delayed, same pass "<<vvertexp<<endl);
+		    ++m_statGenClkSame;
+		}
 		else if (vvertexp->isDelayed()) {
 		    UINFO(5,"Circular Clock, delayed "<<vvertexp<<endl);
 		    nodeMarkCircular(vvertexp, NULL);
@@ -1340,10 +1594,16 @@ bool OrderVisitor::domainsExclusive(const AstSenTree* fromp,
     //   always @(negedge A)
     //
     // ... unless you know more about A and B, which sounds hard.
-    const AstSenItem* fromSenListp = fromp->sensesp()->castSenItem();
-    const AstSenItem* toSenListp = top->sensesp()->castSenItem();
-    // If clk gating is ever reenabled, we may need to update this to handle
-    // AstSenGate also.
+    //
+    // A gated domain fires on a subset of its ungated item's edges, so
+    // exclusivity of the items carries over to the gated domains.
+    AstNodeSenItem* fromSenp = fromp->sensesp();
+    AstNodeSenItem* toSenp = top->sensesp();
+    if (fromSenp->nextp() || toSenp->nextp()) return false;
+    if (fromSenp->castSenGate()) fromSenp = fromSenp->castSenGate()->sensesp();
+    if (toSenp->castSenGate()) toSenp = toSenp->castSenGate()->sensesp();
+    const AstSenItem* fromSenListp = fromSenp->castSenItem();
+    const AstSenItem* toSenListp = toSenp->castSenItem();
     if (!fromSenListp) fromp->v3fatalSrc("sensitivity list item is not an AstSenItem");
     if (!toSenListp) top->v3fatalSrc("sensitivity list item is not an AstSenItem");
 
@@ -1524,6 +1784,14 @@ void OrderVisitor::processMoveOne(OrderMoveVertex* vertexp, OrderMoveDomScope* d
 	// Just ignore sensitivities, we'll deal with them when we move statements that need them
     }
     else {  // Normal logic
+	// With --threads, each mtask collects its own functions, so logic
+	// of other mtasks moved in between must not break them up.
+	ExecMTask* mtaskp = vertexp->mtaskp();
+	if (mtaskp) {
+	    const MTaskFunc& mtaskFunc = m_pomMTaskFuncs[mtaskp];
+	    m_pomNewFuncp = (mtaskFunc.m_domScopep == domScopep) ? mtaskFunc.m_funcp : NULL;
+	    m_pomNewStmts = mtaskFunc.m_stmts;
+	}
 	// Make or borrow a CFunc to contain the new statements
         if (v3Global.opt.profCFuncs()
 	    || (v3Global.opt.outputSplitCFuncs()
@@ -1541,11 +1809,13 @@ void OrderVisitor::processMoveOne(OrderMoveVertex* vertexp, OrderMoveDomScope* d
 	    scopep->addActivep(m_pomNewFuncp);
 	    // Where will we be adding the call?
 	    AstActive* callunderp = new AstActive(nodep->fileline(), name, domainp);
-	    m_scopetopp->addActivep(callunderp);
+	    if (mtaskp) mtaskp->bodyp()->addStmtsp(callunderp);
+	    else m_scopetopp->addActivep(callunderp);
 	    // Add a top call to it
 	    AstCCall* callp = new AstCCall(nodep->fileline(), m_pomNewFuncp);
 	    callp->argTypes("vlSymsp");
 	    callunderp->addStmtsp(callp);
+	    if (domainp == m_comboDomainp) m_pomComboCalls.push_back(callp);
 	    UINFO(6,"      New "<<m_pomNewFuncp<<endl);
 	}
 
@@ -1562,6 +1832,13 @@ void OrderVisitor::processMoveOne(OrderMoveVertex* vertexp, OrderMoveDomScope* d
 		m_pomNewStmts += visitor.count();
 	    }
 	}
+	if (mtaskp) {
+	    MTaskFunc& mtaskFunc = m_pomMTaskFuncs[mtaskp];
+	    mtaskFunc.m_funcp = m_pomNewFuncp;
+	    mtaskFunc.m_domScopep = domScopep;
+	    mtaskFunc.m_stmts = m_pomNewStmts;
+	    m_pomNewFuncp = NULL;
+	}
     }
     processMoveDoneOne (vertexp);
 }
@@ -1583,6 +1860,117 @@ inline void OrderMoveDomScope::movedVertex(OrderVisitor* ovp, OrderMoveVertex* v
     }
 }
 
+//######################################################################
+// Partitioning
+
+void OrderVisitor::processPartition() {
+    // Initial and settle logic runs once, single threaded; everything
+    // else is partitioned into the mtasks of the eval loop.
+    vector<OrderMoveVertex*> vertices;
+    for (V3GraphVertex* itp = m_pomGraph.verticesBeginp(); itp; itp=itp->verticesNextp()) {
+	OrderMoveVertex* moveVxp = static_cast<OrderMoveVertex*>(itp);
+	AstSenTree* domainp = moveVxp->logicp()->domainp();
+	if (domainp == m_deleteDomainp || domainp->hasInitial() || domainp->hasSettle()) continue;
+	vertices.push_back(moveVxp);
+    }
+    if (vertices.empty()) return;
+    AstExecGraph* execGraphp = new AstExecGraph(m_scopetopp->fileline());
+    V3Partition::partition(&m_graph, vertices, execGraphp);
+    m_scopetopp->addActivep(execGraphp);
+    v3Global.rootp()->execGraphp(execGraphp);
+}
+
+//######################################################################
+// Activity gating
+
+void OrderVisitor::processActivity() {
+    // Wrap the call of each combo region worth it with a check that an
+    // input changed since its last run:
+    //	  IF(!valid || in != last_in || ...) { last_in = in; ...; valid = 1; CCALL }
+    // The copies are made before the call, so a region that changes its
+    // own inputs runs again, as a settle loop would expect.
+    // m_pomComboCalls is only filled by processMoveOne, which adds each
+    // call once, to either the serial _eval or a single mtask's body.  So
+    // each region's copies and valid flag are only accessed by the one
+    // thread running that call, and need no synchronization.
+    OrderWritersVisitor writers (v3Global.rootp());
+    AstNodeModule* topModp = m_scopetopp->modp();
+    AstCFunc* resetFuncp = NULL;
+    for (vector<AstCCall*>::iterator it = m_pomComboCalls.begin(); it != m_pomComboCalls.end(); ++it) {
+	AstCCall* callp = *it;
+	AstCFunc* funcp = callp->funcp();
+	OrderRegionVisitor region (funcp);
+	if (!region.gatable()) continue;
+	// Comparing the inputs must be much cheaper than the region
+	if (region.inputs().size() > 64
+	    || region.nodes() < 8 * (region.inputWords() + 1)) {
+	    UINFO(5,"    Activity gating not worth it, "<<region.nodes()<<" nodes, "
+		  <<region.inputWords()<<" input words: "<<funcp<<endl);
+	    continue;
+	}
+	bool clobbered = false;
+	for (set<AstVarScope*>::const_iterator wit = region.writes().begin();
+	     wit != region.writes().end(); ++wit) {
+	    if (writers.otherWriter(*wit, funcp)) { clobbered = true; break; }
+	}
+	if (clobbered) continue;
+	UINFO(4,"    Activity gating "<<funcp<<endl);
+	FileLine* fl = callp->fileline();
+	string prefix = "__Vactivity"+cvtToStr(static_cast<int>(m_statActivityGated));
+	++m_statActivityGated;
+	AstVar* validVarp = new AstVar(fl, AstVarType::MODULETEMP, prefix+"_valid",
+				       VFlagBitPacked(), 1);
+	topModp->addStmtp(validVarp);
+	AstVarScope* validVscp = new AstVarScope(fl, m_scopetopp, validVarp);
+	m_scopetopp->addVarp(validVscp);
+	AstNode* condp = new AstNot(fl, new AstVarRef(fl, validVscp, false));
+	AstNode* copiesp = NULL;
+	for (vector<AstVarScope*>::const_iterator iit = region.inputs().begin();
+	     iit != region.inputs().end(); ++iit) {
+	    AstVarScope* vscp = *iit;
+	    AstVar* varp = vscp->varp();
+	    AstVar* lastVarp = new AstVar(fl, AstVarType::MODULETEMP,
+					  prefix+"__"+vscp->scopep()->nameDotless()+"__"+varp->shortName(),
+					  varp);
+	    topModp->addStmtp(lastVarp);
+	    AstVarScope* lastVscp = new AstVarScope(fl, m_scopetopp, lastVarp);
+	    m_scopetopp->addVarp(lastVscp);
+	    AstNode* neqp;
+	    if (varp->isDouble()) {
+		neqp = new AstNeqD(fl, new AstVarRef(fl, vscp, false), new AstVarRef(fl, lastVscp, false));
+	    } else {
+		neqp = new AstNeq(fl, new AstVarRef(fl, vscp, false), new AstVarRef(fl, lastVscp, false));
+	    }
+	    condp = new AstLogOr(fl, condp, neqp);
+	    copiesp = AstNode::addNext(copiesp, new AstAssign(fl, new AstVarRef(fl, lastVscp, true),
+							      new AstVarRef(fl, vscp, false)));
+	}
+	copiesp = AstNode::addNext(copiesp, new AstAssign(fl, new AstVarRef(fl, validVscp, true),
+							  new AstConst(fl, AstConst::LogicTrue())));
+	AstNRelinker relinkHandle;
+	callp->unlinkFrBack(&relinkHandle);
+	AstIf* ifp = new AstIf(fl, condp, copiesp, NULL);
+	ifp->addIfsp(callp);
+	relinkHandle.relink(ifp);
+	// The copies start out garbage, so each region runs after settling
+	if (!resetFuncp) {
+	    string name = "_settle__"+m_scopetopp->nameDotless()+"__Vactivity";
+	    resetFuncp = new AstCFunc(fl, name, m_scopetopp);
+	    resetFuncp->argTypes(EmitCBaseVisitor::symClassVar());
+	    resetFuncp->symProlog(true);
+	    resetFuncp->slow(true);
+	    m_scopetopp->addActivep(resetFuncp);
+	    AstActive* callunderp = new AstActive(fl, name, m_settleDomainp);
+	    m_scopetopp->addActivep(callunderp);
+	    AstCCall* resetCallp = new AstCCall(fl, resetFuncp);
+	    resetCallp->argTypes("vlSymsp");
+	    callunderp->addStmtsp(resetCallp);
+	}
+	resetFuncp->addStmtsp(new AstAssign(fl, new AstVarRef(fl, validVscp, true),
+					    new AstConst(fl, AstConst::LogicFalse())));
+    }
+}
+
 //######################################################################
 // Top processing
 
@@ -1625,9 +2013,19 @@ void OrderVisitor::process() {
     m_pomGraph.removeRedundantEdges(&V3GraphEdge::followAlwaysTrue);
     m_pomGraph.dumpDotFilePrefixed("ordermv_simpl");
 
+    if (v3Global.opt.mtasks()) {
+	UINFO(2,"  Partition...\n");
+	processPartition();
+    }
+
     UINFO(2,"  Move...\n");
     processMove();
 
+    if (v3Global.opt.orderActivity()) {
+	UINFO(2,"  Activity...\n");
+	processActivity();
+    }
+
     // Any SC inputs feeding a combo domain must be marked, so we can make them sc_sensitive
     UINFO(2,"  Sensitive...\n");
     processSensitive();  // must be after processDomains
@@ -312,6 +312,7 @@ class OrderMoveVertex : public V3GraphVertex {
     OrderLogicVertex*	m_logicp;
     OrderMState		m_state;	// Movement state
     OrderMoveDomScope*	m_domScopep;	// Domain/scope list information
+    ExecMTask*		m_mtaskp;	// Macro-task running this logic, or NULL if serial
 
 protected:
     friend class OrderVisitor;
@@ -322,10 +323,11 @@ protected:
     // CONSTRUCTORS
     OrderMoveVertex(V3Graph* graphp, const OrderMoveVertex& old)
 	: V3GraphVertex(graphp, old), m_logicp(old.m_logicp), m_state(old.m_state)
-	, m_domScopep(old.m_domScopep) {}
+	, m_domScopep(old.m_domScopep), m_mtaskp(old.m_mtaskp) {}
 public:
     OrderMoveVertex(V3Graph* graphp, OrderLogicVertex* logicp)
-	: V3GraphVertex(graphp), m_logicp(logicp), m_state(POM_WAIT), m_domScopep(NULL) {}
+	: V3GraphVertex(graphp), m_logicp(logicp), m_state(POM_WAIT), m_domScopep(NULL)
+	, m_mtaskp(NULL) {}
     virtual ~OrderMoveVertex() {}
     virtual OrderMoveVertex* clone(V3Graph* graphp) const {
 	return new OrderMoveVertex(graphp, *this);
@@ -364,6 +366,8 @@ public:
     OrderMoveDomScope* domScopep() const { return m_domScopep; }
     OrderMoveVertex* pomWaitingNextp() const { return m_pomWaitingE.nextp(); }
     void domScopep(OrderMoveDomScope* ds) { m_domScopep=ds; }
+    ExecMTask* mtaskp() const { return m_mtaskp; }
+    void mtaskp(ExecMTask* mtaskp) { m_mtaskp = mtaskp; }
 };
 
 //######################################################################
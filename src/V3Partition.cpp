@@ -0,0 +1,744 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//*************************************************************************
+// DESCRIPTION: Verilator: Partition the eval logic into macro-tasks
+//
+// Code available from: http://www.veripool.org/verilator
+//
+//*************************************************************************
+//
+// Copyright 2003-2018 by Wilson Snyder.  This program is free software; you can
+// redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+//
+// Verilator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+//*************************************************************************
+// V3Partition's Transformations:
+//
+//  Called by V3Order with the fast (non-initial, non-settle) logic
+//  vertices of its move graph, when --threads > 1:
+//
+//	Make a LogicMTask for each logic vertex, costed by instruction count
+//	Copy the move graph's dependency edges between them
+//	For each variable written by several mtasks
+//	    Chain the writers in serial order, so they never race
+//	Merge chains: A->B where B is A's only successor and A is B's only
+//	    predecessor; this loses no parallelism
+//	While the cheapest mtask costs less than a thread handoff
+//	    Merge it into the cheapest legal predecessor, successor or
+//	    sibling (legal = the merge may not create a cycle)
+//	Compute each mtask's critical path to the end of eval
+//	List-schedule onto the threads, longest critical path first
+//	Build an ExecMTask and MTASKBODY per mtask under the AstExecGraph
+//
+//  With --prof-threads-data, logic costs come from a prior --prof-threads
+//  run where available: the runtime reports the measured cycles of each
+//  mtask with the profile keys of its logic, and we share those cycles
+//  among the logic in proportion to the estimated costs.
+//
+//  V3Order then moves each logic vertex's statements into its mtask's body.
+//
+//  V3Partition::finalize, after V3Clock:
+//	Move each MTASKBODY's statements into a new _mtask CFunc, leaving
+//	a call in the body for EmitC to place in the thread functions.
+//
+//*************************************************************************
+
+#include "config_build.h"
+#include "verilatedos.h"
+#include <cstdio>
+#include <cstdarg>
+#include <algorithm>
+#include <vector>
+#include <set>
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <memory>
+
+#include "V3Global.h"
+#include "V3Ast.h"
+#include "V3Graph.h"
+#include "V3Stats.h"
+#include "V3File.h"
+#include "V3EmitCBase.h"
+#include "V3OrderGraph.h"
+#include "V3Partition.h"
+#include "V3PartitionGraph.h"
+
+//######################################################################
+// Tunables
+
+enum {
+    PART_SYNC_COST = 100,	// Cost units of handing work between threads (cache line transfer, wait)
+    PART_TASKS_PER_THREAD = 16,	// Aim for about this many mtasks per thread, for load balance
+    PART_PATH_BUDGET = 4096	// Vertices to search when proving a merge keeps the graph acyclic
+};
+
+//######################################################################
+// Cost estimation of a logic block
+
+class PartCostVisitor : public AstNVisitor {
+private:
+    // STATE
+    uint32_t	m_cost;		// Running cost
+    // VISITORS
+    virtual void visit(AstNode* nodep) {
+	// Each node costs at least a cycle; wide math reports more via instrCount
+	m_cost += 1 + nodep->instrCount();
+	nodep->iterateChildren(*this);
+    }
+public:
+    // CONSTUCTORS
+    explicit PartCostVisitor(AstNode* nodep) {
+	m_cost = 0;
+	nodep->accept(*this);
+    }
+    virtual ~PartCostVisitor() {}
+    uint32_t cost() const { return m_cost; }
+};
+
+//######################################################################
+// Measured costs from a --prof-threads run
+
+class PartProfileData {
+    // TYPES
+    typedef std::map<string, double> KeyCycles;
+    // STATE
+    KeyCycles	m_cycles;	// Measured cycles of each logic's profile key
+public:
+    // METHODS
+    void load(const string& filename) {
+	const vl_unique_ptr<std::ifstream> ifp (V3File::new_ifstream(filename));
+	if (ifp->fail()) { v3fatal("Can't read --prof-threads-data file: "<<filename); return; }
+	string line;
+	while (std::getline(*ifp, line)) {
+	    // VLPROF mtask <id> ticks <mean ticks> cost <cost> blocks <key>:<cost> ...
+	    std::istringstream is (line);
+	    string word, id, ticksWord, costWord, blocksWord;
+	    double ticks = 0;
+	    uint32_t cost = 0;
+	    is >> word;
+	    if (word != "VLPROF") continue;
+	    is >> word >> id >> ticksWord >> ticks >> costWord >> cost >> blocksWord;
+	    if (is.fail() || word != "mtask" || blocksWord != "blocks") {
+		v3fatal("Malformed line in --prof-threads-data file: "<<filename<<": "<<line);
+		return;
+	    }
+	    std::vector<std::pair<string, uint32_t> > blocks;
+	    uint32_t totalCost = 0;
+	    while (is >> word) {
+		string::size_type colon = word.rfind(':');
+		if (colon == string::npos) continue;
+		uint32_t blockCost = atoi(word.substr(colon+1).c_str());
+		blocks.push_back(make_pair(word.substr(0, colon), blockCost));
+		totalCost += blockCost;
+	    }
+	    for (std::vector<std::pair<string, uint32_t> >::iterator it = blocks.begin();
+		 it != blocks.end(); ++it) {
+		double share = totalCost ? (double(it->second) / totalCost) : (1.0 / blocks.size());
+		m_cycles[it->first] = ticks * share;
+	    }
+	}
+    }
+    bool find(const string& key, double& cycles) const {
+	KeyCycles::const_iterator it = m_cycles.find(key);
+	if (it == m_cycles.end()) return false;
+	cycles = it->second;
+	return true;
+    }
+};
+
+//######################################################################
+// Graph of mtasks being formed
+
+class LogicMTask : public V3GraphVertex {
+public:
+    typedef std::vector<OrderMoveVertex*> MoveVec;
+private:
+    MoveVec	m_moveps;	// Logic run by this mtask
+    uint32_t	m_serial;	// Serial order of the first logic, for stable decisions
+    uint32_t	m_cost;		// Estimated cost
+    uint32_t	m_priority;	// Critical path from start of this mtask to end of eval
+    uint32_t	m_thread;	// Scheduled thread
+    uint32_t	m_finish;	// Scheduled finish time
+    uint32_t	m_mark;		// Generation mark for searches
+    ExecMTask*	m_execp;	// Final ExecMTask
+public:
+    LogicMTask(V3Graph* graphp, OrderMoveVertex* movep, uint32_t serial, uint32_t cost)
+	: V3GraphVertex(graphp), m_serial(serial), m_cost(cost), m_priority(0)
+	, m_thread(0), m_finish(0), m_mark(0), m_execp(NULL) {
+	m_moveps.push_back(movep);
+    }
+    virtual ~LogicMTask() {}
+    // ACCESSORS
+    virtual string name() const { return string("lmt")+cvtToStr(m_serial)+" c="+cvtToStr(m_cost); }
+    const MoveVec& moveps() const { return m_moveps; }
+    uint32_t	serial() const { return m_serial; }
+    uint32_t	cost() const { return m_cost; }
+    uint32_t	priority() const { return m_priority; }
+    void	priority(uint32_t pri) { m_priority = pri; }
+    uint32_t	thread() const { return m_thread; }
+    void	thread(uint32_t thread) { m_thread = thread; }
+    uint32_t	finish() const { return m_finish; }
+    void	finish(uint32_t time) { m_finish = time; }
+    uint32_t	mark() const { return m_mark; }
+    void	mark(uint32_t mark) { m_mark = mark; }
+    ExecMTask*	execp() const { return m_execp; }
+    void	execp(ExecMTask* execp) { m_execp = execp; }
+    // METHODS
+    void absorb(LogicMTask* fromp) {
+	m_moveps.insert(m_moveps.end(), fromp->m_moveps.begin(), fromp->m_moveps.end());
+	m_cost += fromp->m_cost;
+	m_serial = std::min(m_serial, fromp->m_serial);
+    }
+    LogicMTask* fromp(V3GraphEdge* edgep) const { return static_cast<LogicMTask*>(edgep->fromp()); }
+    LogicMTask* top(V3GraphEdge* edgep) const { return static_cast<LogicMTask*>(edgep->top()); }
+};
+
+struct LogicMTaskCmpCost {
+    // Cheapest first; serial breaks ties so results don't depend on pointers
+    inline bool operator() (const LogicMTask* lhsp, const LogicMTask* rhsp) const {
+	if (lhsp->cost() != rhsp->cost()) return lhsp->cost() < rhsp->cost();
+	return lhsp->serial() < rhsp->serial();
+    }
+};
+
+struct LogicMTaskCmpPriority {
+    // Longest critical path first
+    inline bool operator() (const LogicMTask* lhsp, const LogicMTask* rhsp) const {
+	if (lhsp->priority() != rhsp->priority()) return lhsp->priority() > rhsp->priority();
+	return lhsp->serial() < rhsp->serial();
+    }
+};
+
+//######################################################################
+// Partitioner
+
+class PartitionVisitor {
+private:
+    // TYPES
+    typedef std::set<LogicMTask*, LogicMTaskCmpCost> CostSet;
+    typedef std::vector<LogicMTask*> MTaskVec;
+
+    // STATE
+    OrderGraph*		m_orderGraphp;	// Ordering graph, to find variable writers
+    V3Graph		m_mtasks;	// Graph of LogicMTask's
+    uint32_t		m_threads;	// Number of threads to schedule onto
+    uint32_t		m_generation;	// Mark generation for searches
+    uint32_t		m_statChains;	// Chain merges
+    uint32_t		m_statMerges;	// Other merges
+    uint32_t		m_statHazards;	// Hazard edges added
+    uint32_t		m_statProfiled;	// Logic costed from profile data
+    std::map<const OrderMoveVertex*, string> m_profKeys;  // Profile key of each logic
+    std::map<const OrderMoveVertex*, uint32_t> m_estCosts;  // Estimated cost of each logic
+
+    // METHODS
+    static int debug() {
+	static int level = -1;
+	if (VL_UNLIKELY(level < 0)) level = v3Global.opt.debugSrcLevel(__FILE__);
+	return level;
+    }
+    static LogicMTask* mtaskOf(const V3GraphVertex* vxp) {
+	return static_cast<LogicMTask*>(vxp->userp());
+    }
+    static uint32_t logicCost(const OrderMoveVertex* movep) {
+	AstNode* nodep = movep->logicp()->nodep();
+	// Sensitivity vertices reference the whole sensitivity tree;
+	// they generate no code of their own.
+	if (nodep->castSenTree() || nodep->castActive()) return 1;
+	PartCostVisitor visitor(nodep);
+	return visitor.cost();
+    }
+    static string profKey(const OrderMoveVertex* movep) {
+	// Identifies the logic across Verilator runs of the same design
+	AstNode* nodep = movep->logicp()->nodep();
+	return (movep->logicp()->scopep()->name()+" "+nodep->fileline()->filename()
+		+":"+cvtToStr(nodep->fileline()->lineno())+" "+nodep->typeName());
+    }
+    static string hashKey(const string& text) {
+	// FNV-1a, so keys are short and need no quoting in C++ or the data file
+	vluint64_t hash = VL_ULL(14695981039346656037);
+	for (string::const_iterator it = text.begin(); it != text.end(); ++it) {
+	    hash = (hash ^ static_cast<unsigned char>(*it)) * VL_ULL(1099511628211);
+	}
+	std::ostringstream os;
+	os<<std::hex<<hash;
+	return os.str();
+    }
+    void computeCosts(const std::vector<OrderMoveVertex*>& vertices, std::vector<uint32_t>& costs) {
+	// Estimates, and unique profile keys (an ordinal disambiguates
+	// logic from the same line)
+	std::map<string, int> keyCounts;
+	for (std::vector<OrderMoveVertex*>::const_iterator it = vertices.begin();
+	     it != vertices.end(); ++it) {
+	    string key = profKey(*it);
+	    int ordinal = keyCounts[key]++;
+	    m_profKeys[*it] = hashKey(key+" "+cvtToStr(ordinal));
+	    m_estCosts[*it] = logicCost(*it);
+	    costs.push_back(m_estCosts[*it]);
+	}
+	if (v3Global.opt.profThreadsData() == "") return;
+	PartProfileData profile;
+	profile.load(v3Global.opt.profThreadsData());
+	// Scale measured cycles to estimate units, so profiled and
+	// unprofiled logic (e.g. newly added) remain comparable
+	double measured = 0;
+	double estimated = 0;
+	std::vector<double> cycles (vertices.size(), -1);
+	for (size_t i = 0; i < vertices.size(); ++i) {
+	    if (profile.find(m_profKeys[vertices[i]], cycles[i])) {
+		measured += cycles[i];
+		estimated += costs[i];
+	    }
+	}
+	if (measured <= 0) {
+	    UINFO(2,"  No logic matched in --prof-threads-data\n");
+	    return;
+	}
+	double scale = estimated / measured;
+	for (size_t i = 0; i < vertices.size(); ++i) {
+	    if (cycles[i] < 0) continue;
+	    costs[i] = std::max(1, static_cast<int>(cycles[i] * scale + 0.5));
+	    ++m_statProfiled;
+	}
+    }
+    uint32_t newGeneration() { return ++m_generation; }
+    uint32_t mtaskCount() const {
+	uint32_t count = 0;
+	for (V3GraphVertex* vxp = m_mtasks.verticesBeginp(); vxp; vxp = vxp->verticesNextp()) ++count;
+	return count;
+    }
+
+    // Build
+    void buildGraph(const std::vector<OrderMoveVertex*>& vertices) {
+	// Move graph: userp -> LogicMTask*, NULL if not being partitioned
+	for (std::vector<OrderMoveVertex*>::const_iterator it = vertices.begin();
+	     it != vertices.end(); ++it) {
+	    (*it)->userp(NULL);
+	    for (V3GraphEdge* edgep = (*it)->outBeginp(); edgep; edgep = edgep->outNextp()) {
+		edgep->top()->userp(NULL);
+	    }
+	}
+	std::vector<uint32_t> costs;
+	computeCosts(vertices, costs);
+	for (uint32_t i = 0; i < vertices.size(); ++i) {
+	    vertices[i]->userp(new LogicMTask(&m_mtasks, vertices[i], i+1, costs[i]));
+	}
+	for (std::vector<OrderMoveVertex*>::const_iterator it = vertices.begin();
+	     it != vertices.end(); ++it) {
+	    for (V3GraphEdge* edgep = (*it)->outBeginp(); edgep; edgep = edgep->outNextp()) {
+		if (LogicMTask* top = mtaskOf(edgep->top())) {
+		    new V3GraphEdge(&m_mtasks, mtaskOf(*it), top, 1);
+		}
+	    }
+	}
+    }
+
+    // Ranks: strictly increase along every edge, so a vertex can only
+    // reach vertices of higher rank.  Kept valid incrementally over merges.
+    void rankAll() {
+	MTaskVec order;
+	topoSort(order);
+	for (MTaskVec::iterator it = order.begin(); it != order.end(); ++it) {
+	    uint32_t rank = 1;
+	    for (V3GraphEdge* edgep = (*it)->inBeginp(); edgep; edgep = edgep->inNextp()) {
+		rank = std::max(rank, edgep->fromp()->rank()+1);
+	    }
+	    (*it)->rank(rank);
+	}
+    }
+    void rankPropagate(LogicMTask* startp) {
+	for (V3GraphEdge* edgep = startp->inBeginp(); edgep; edgep = edgep->inNextp()) {
+	    startp->rank(std::max(startp->rank(), edgep->fromp()->rank()+1));
+	}
+	MTaskVec todo;
+	todo.push_back(startp);
+	while (!todo.empty()) {
+	    LogicMTask* mtaskp = todo.back(); todo.pop_back();
+	    for (V3GraphEdge* edgep = mtaskp->outBeginp(); edgep; edgep = edgep->outNextp()) {
+		LogicMTask* top = mtaskp->top(edgep);
+		if (top->rank() <= mtaskp->rank()) {
+		    top->rank(mtaskp->rank()+1);
+		    todo.push_back(top);
+		}
+	    }
+	}
+    }
+    void topoSort(MTaskVec& order) {
+	// Kahn's algorithm, preferring the serial (V3Order) order among ready mtasks
+	std::set<LogicMTask*, LogicMTaskCmpSerial> ready;
+	for (V3GraphVertex* vxp = m_mtasks.verticesBeginp(); vxp; vxp = vxp->verticesNextp()) {
+	    uint32_t ins = 0;
+	    for (V3GraphEdge* edgep = vxp->inBeginp(); edgep; edgep = edgep->inNextp()) ++ins;
+	    vxp->user(ins);
+	    if (!ins) ready.insert(static_cast<LogicMTask*>(vxp));
+	}
+	while (!ready.empty()) {
+	    LogicMTask* mtaskp = *ready.begin();
+	    ready.erase(ready.begin());
+	    order.push_back(mtaskp);
+	    for (V3GraphEdge* edgep = mtaskp->outBeginp(); edgep; edgep = edgep->outNextp()) {
+		V3GraphVertex* top = edgep->top();
+		top->user(top->user()-1);
+		if (!top->user()) ready.insert(static_cast<LogicMTask*>(top));
+	    }
+	}
+	UASSERT(order.size() == mtaskCount(), "Cycle in mtask graph");
+    }
+    struct LogicMTaskCmpSerial {
+	inline bool operator() (const LogicMTask* lhsp, const LogicMTask* rhsp) const {
+	    return lhsp->serial() < rhsp->serial();
+	}
+    };
+
+    // Hazards
+    void fixDataHazards() {
+	// Two mtasks writing the same variable must not run concurrently,
+	// even when nothing reads between them: writes to parts of a word or
+	// array are read-modify-writes in C++.  Chain all writers of each
+	// variable in one global topological order, which keeps the graph
+	// acyclic no matter how many variables add edges.
+	MTaskVec order;
+	topoSort(order);
+	for (uint32_t i=0; i<order.size(); ++i) order[i]->user(i);
+	for (V3GraphVertex* vxp = m_orderGraphp->verticesBeginp(); vxp; vxp = vxp->verticesNextp()) {
+	    OrderVarStdVertex* varVxp = dynamic_cast<OrderVarStdVertex*>(vxp);
+	    if (!varVxp) continue;
+	    std::map<uint32_t, LogicMTask*> writers;  // Sorted by topological index
+	    for (V3GraphEdge* edgep = varVxp->inBeginp(); edgep; edgep = edgep->inNextp()) {
+		OrderLogicVertex* lvxp = dynamic_cast<OrderLogicVertex*>(edgep->fromp());
+		if (!lvxp || !lvxp->moveVxp()) continue;
+		if (LogicMTask* mtaskp = mtaskOf(lvxp->moveVxp())) {
+		    writers.insert(make_pair(mtaskp->user(), mtaskp));
+		}
+	    }
+	    LogicMTask* lastp = NULL;
+	    for (std::map<uint32_t, LogicMTask*>::iterator it = writers.begin(); it != writers.end(); ++it) {
+		if (lastp && !hasEdge(lastp, it->second)) {
+		    UINFO(6,"  Hazard "<<varVxp->varScp()->prettyName()<<": "<<lastp<<" -> "<<it->second<<endl);
+		    new V3GraphEdge(&m_mtasks, lastp, it->second, 1);
+		    ++m_statHazards;
+		}
+		lastp = it->second;
+	    }
+	}
+    }
+    static bool hasEdge(LogicMTask* fromp, LogicMTask* top) {
+	for (V3GraphEdge* edgep = fromp->outBeginp(); edgep; edgep = edgep->outNextp()) {
+	    if (edgep->top() == top) return true;
+	}
+	return false;
+    }
+
+    // Merging
+    bool pathExists(LogicMTask* fromp, LogicMTask* top, bool skipDirect) {
+	// True if a path leads from fromp to top (other than a direct edge if
+	// skipDirect).  Only vertices of rank below top's can lead to it.
+	// Conservatively true when the search runs out of budget.
+	uint32_t gen = newGeneration();
+	uint32_t budget = PART_PATH_BUDGET;
+	MTaskVec todo;
+	todo.push_back(fromp);
+	fromp->mark(gen);
+	while (!todo.empty()) {
+	    LogicMTask* vxp = todo.back(); todo.pop_back();
+	    for (V3GraphEdge* edgep = vxp->outBeginp(); edgep; edgep = edgep->outNextp()) {
+		LogicMTask* nextp = vxp->top(edgep);
+		if (nextp == top) {
+		    if (vxp == fromp && skipDirect) continue;
+		    return true;
+		}
+		if (nextp->mark() == gen || nextp->rank() >= top->rank()) continue;
+		if (!--budget) return true;
+		nextp->mark(gen);
+		todo.push_back(nextp);
+	    }
+	}
+	return false;
+    }
+    bool mergeLegal(LogicMTask* ap, LogicMTask* bp) {
+	// Merging is legal if it cannot create a cycle: no path between the
+	// two mtasks other than a direct edge.
+	if (ap->rank() > bp->rank()) std::swap(ap, bp);
+	return !pathExists(ap, bp, true);
+    }
+    void merge(LogicMTask* intop, LogicMTask* fromp) {
+	UINFO(7,"    Merge "<<fromp<<" into "<<intop<<endl);
+	// Mark existing neighbors of intop, to avoid parallel edges
+	uint32_t predGen = newGeneration();
+	uint32_t succGen = newGeneration();
+	for (V3GraphEdge* edgep = intop->inBeginp(); edgep; edgep = edgep->inNextp()) {
+	    intop->fromp(edgep)->mark(predGen);
+	}
+	for (V3GraphEdge* edgep = intop->outBeginp(); edgep; edgep = edgep->outNextp()) {
+	    intop->top(edgep)->mark(succGen);
+	}
+	for (V3GraphEdge* edgep = fromp->inBeginp(); edgep; edgep = edgep->inNextp()) {
+	    LogicMTask* predp = fromp->fromp(edgep);
+	    if (predp == intop || predp->mark() == predGen) continue;
+	    predp->mark(predGen);
+	    new V3GraphEdge(&m_mtasks, predp, intop, 1);
+	}
+	for (V3GraphEdge* edgep = fromp->outBeginp(); edgep; edgep = edgep->outNextp()) {
+	    LogicMTask* succp = fromp->top(edgep);
+	    if (succp == intop || succp->mark() == succGen) continue;
+	    succp->mark(succGen);
+	    new V3GraphEdge(&m_mtasks, intop, succp, 1);
+	}
+	intop->absorb(fromp);
+	intop->rank(std::max(intop->rank(), fromp->rank()));
+	fromp->unlinkDelete(&m_mtasks); VL_DANGLING(fromp);
+	rankPropagate(intop);
+    }
+    void mergeChains() {
+	for (V3GraphVertex* vxp = m_mtasks.verticesBeginp(); vxp; vxp = vxp->verticesNextp()) {
+	    LogicMTask* mtaskp = static_cast<LogicMTask*>(vxp);
+	    while (mtaskp->outSize1()) {
+		LogicMTask* succp = mtaskp->top(mtaskp->outBeginp());
+		if (!succp->inSize1()) break;
+		merge(mtaskp, succp);
+		++m_statChains;
+	    }
+	}
+    }
+    void addCandidate(MTaskVec& candidates, LogicMTask* mtaskp, LogicMTask* candp, uint32_t gen) {
+	if (candp == mtaskp || candp->mark() == gen) return;
+	candp->mark(gen);
+	candidates.push_back(candp);
+    }
+    void mergeSmall(uint32_t minCost, uint32_t maxCost) {
+	// Repeatedly merge the cheapest mtask into its cheapest legal partner
+	enum { SIBLING_PARENTS = 4, SIBLINGS = 32 };
+	CostSet small;
+	for (V3GraphVertex* vxp = m_mtasks.verticesBeginp(); vxp; vxp = vxp->verticesNextp()) {
+	    small.insert(static_cast<LogicMTask*>(vxp));
+	}
+	while (!small.empty()) {
+	    LogicMTask* mtaskp = *small.begin();
+	    if (mtaskp->cost() >= minCost) break;
+	    small.erase(small.begin());
+	    // Candidates: neighbors, then siblings sharing a neighbor
+	    MTaskVec candidates;
+	    uint32_t gen = newGeneration();
+	    for (V3GraphEdge* edgep = mtaskp->inBeginp(); edgep; edgep = edgep->inNextp()) {
+		addCandidate(candidates, mtaskp, mtaskp->fromp(edgep), gen);
+	    }
+	    for (V3GraphEdge* edgep = mtaskp->outBeginp(); edgep; edgep = edgep->outNextp()) {
+		addCandidate(candidates, mtaskp, mtaskp->top(edgep), gen);
+	    }
+	    int parents = 0;
+	    for (V3GraphEdge* edgep = mtaskp->inBeginp();
+		 edgep && parents < SIBLING_PARENTS; edgep = edgep->inNextp(), ++parents) {
+		LogicMTask* parentp = mtaskp->fromp(edgep);
+		int sibs = 0;
+		for (V3GraphEdge* sedgep = parentp->outBeginp();
+		     sedgep && sibs < SIBLINGS; sedgep = sedgep->outNextp(), ++sibs) {
+		    addCandidate(candidates, mtaskp, parentp->top(sedgep), gen);
+		}
+	    }
+	    if (!mtaskp->inBeginp()) {
+		// Sources have no parent; their siblings are the other sources,
+		// which are always legal to merge.
+		int sibs = 0;
+		for (CostSet::iterator it = small.begin();
+		     it != small.end() && sibs < SIBLINGS; ++it, ++sibs) {
+		    if (!(*it)->inBeginp()) addCandidate(candidates, mtaskp, *it, gen);
+		}
+	    }
+	    std::sort(candidates.begin(), candidates.end(), LogicMTaskCmpCost());
+	    for (MTaskVec::iterator it = candidates.begin(); it != candidates.end(); ++it) {
+		LogicMTask* candp = *it;
+		if (candp->cost() + mtaskp->cost() > maxCost) break;  // Sorted, rest are worse
+		if (!mergeLegal(mtaskp, candp)) continue;
+		small.erase(candp);
+		merge(candp, mtaskp); VL_DANGLING(mtaskp);
+		small.insert(candp);
+		++m_statMerges;
+		break;
+	    }
+	}
+    }
+
+    // Scheduling
+    void computePriorities() {
+	MTaskVec order;
+	topoSort(order);
+	for (MTaskVec::reverse_iterator it = order.rbegin(); it != order.rend(); ++it) {
+	    uint32_t longest = 0;
+	    for (V3GraphEdge* edgep = (*it)->outBeginp(); edgep; edgep = edgep->outNextp()) {
+		longest = std::max(longest, (*it)->top(edgep)->priority());
+	    }
+	    (*it)->priority((*it)->cost() + longest);
+	}
+    }
+    void schedule(MTaskVec& scheduled) {
+	// Greedy list scheduling: take the ready mtask with the longest
+	// critical path, and start it on whichever thread can start it
+	// soonest, counting a handoff cost for inputs from other threads.
+	std::vector<uint32_t> threadFree (m_threads, 0);
+	std::set<LogicMTask*, LogicMTaskCmpPriority> ready;
+	for (V3GraphVertex* vxp = m_mtasks.verticesBeginp(); vxp; vxp = vxp->verticesNextp()) {
+	    uint32_t ins = 0;
+	    for (V3GraphEdge* edgep = vxp->inBeginp(); edgep; edgep = edgep->inNextp()) ++ins;
+	    vxp->user(ins);
+	    if (!ins) ready.insert(static_cast<LogicMTask*>(vxp));
+	}
+	while (!ready.empty()) {
+	    LogicMTask* mtaskp = *ready.begin();
+	    ready.erase(ready.begin());
+	    uint32_t bestThread = 0;
+	    uint32_t bestStart = 0;
+	    for (uint32_t thread = 0; thread < m_threads; ++thread) {
+		uint32_t start = threadFree[thread];
+		for (V3GraphEdge* edgep = mtaskp->inBeginp(); edgep; edgep = edgep->inNextp()) {
+		    LogicMTask* predp = mtaskp->fromp(edgep);
+		    uint32_t avail = predp->finish() + ((predp->thread() == thread) ? 0 : PART_SYNC_COST);
+		    start = std::max(start, avail);
+		}
+		if (thread == 0 || start < bestStart) {
+		    bestThread = thread;
+		    bestStart = start;
+		}
+	    }
+	    mtaskp->thread(bestThread);
+	    mtaskp->finish(bestStart + mtaskp->cost());
+	    threadFree[bestThread] = mtaskp->finish();
+	    scheduled.push_back(mtaskp);
+	    for (V3GraphEdge* edgep = mtaskp->outBeginp(); edgep; edgep = edgep->outNextp()) {
+		V3GraphVertex* top = edgep->top();
+		top->user(top->user()-1);
+		if (!top->user()) ready.insert(static_cast<LogicMTask*>(top));
+	    }
+	}
+	UASSERT(scheduled.size() == mtaskCount(), "Cycle in mtask graph");
+    }
+
+    void buildExecGraph(const MTaskVec& scheduled, AstExecGraph* execGraphp) {
+	V3Graph* depGraphp = execGraphp->mutableDepGraphp();
+	uint32_t id = 0;
+	for (MTaskVec::const_iterator it = scheduled.begin(); it != scheduled.end(); ++it) {
+	    LogicMTask* mtaskp = *it;
+	    // Ids follow the schedule, so each thread runs its mtasks in id order
+	    // and message ordering by id follows a legal serial order.
+	    AstMTaskBody* bodyp = new AstMTaskBody(mtaskp->moveps()[0]->logicp()->nodep()->fileline());
+	    execGraphp->addMTaskBodyp(bodyp);
+	    ExecMTask* execp = new ExecMTask(depGraphp, bodyp, ++id);
+	    bodyp->execMTaskp(execp);
+	    execp->cost(mtaskp->cost());
+	    execp->priority(mtaskp->priority());
+	    execp->thread(mtaskp->thread());
+	    execp->startTime(mtaskp->finish() - mtaskp->cost());
+	    mtaskp->execp(execp);
+	    string profKeys;
+	    for (LogicMTask::MoveVec::const_iterator mit = mtaskp->moveps().begin();
+		 mit != mtaskp->moveps().end(); ++mit) {
+		(*mit)->mtaskp(execp);
+		if (v3Global.opt.profThreads()) {
+		    // Estimates, not profiled costs, so profiles don't compound
+		    profKeys += (profKeys.empty() ? "" : " ")+m_profKeys[*mit]
+			+":"+cvtToStr(m_estCosts[*mit]);
+		}
+	    }
+	    execp->profKeys(profKeys);
+	}
+	for (MTaskVec::const_iterator it = scheduled.begin(); it != scheduled.end(); ++it) {
+	    LogicMTask* mtaskp = *it;
+	    for (V3GraphEdge* edgep = mtaskp->outBeginp(); edgep; edgep = edgep->outNextp()) {
+		new V3GraphEdge(depGraphp, mtaskp->execp(), mtaskp->top(edgep)->execp(), 1);
+	    }
+	}
+    }
+
+public:
+    // CONSTUCTORS
+    PartitionVisitor(OrderGraph* orderGraphp, uint32_t threads) {
+	m_orderGraphp = orderGraphp;
+	m_threads = threads;
+	m_generation = 0;
+	m_statChains = 0;
+	m_statMerges = 0;
+	m_statHazards = 0;
+	m_statProfiled = 0;
+    }
+    ~PartitionVisitor() {
+	V3Stats::addStat("MTask, Hazard edges", m_statHazards);
+	V3Stats::addStat("MTask, Chain merges", m_statChains);
+	V3Stats::addStat("MTask, Other merges", m_statMerges);
+	if (v3Global.opt.profThreadsData() != "") {
+	    V3Stats::addStat("MTask, Profiled logic", m_statProfiled);
+	}
+    }
+    void main(const std::vector<OrderMoveVertex*>& vertices, AstExecGraph* execGraphp) {
+	buildGraph(vertices);
+	fixDataHazards();
+	rankAll();
+	m_mtasks.dumpDotFilePrefixed("partition_fine");
+
+	uint32_t totalCost = 0;
+	for (V3GraphVertex* vxp = m_mtasks.verticesBeginp(); vxp; vxp = vxp->verticesNextp()) {
+	    totalCost += static_cast<LogicMTask*>(vxp)->cost();
+	}
+	// Below minCost an mtask isn't worth a thread handoff; maxCost
+	// keeps merges from serializing too much of the eval.
+	uint32_t minCost = std::max(static_cast<uint32_t>(PART_SYNC_COST),
+				    totalCost / (m_threads * PART_TASKS_PER_THREAD));
+	uint32_t maxCost = std::max(minCost * 2, totalCost / (m_threads * 2));
+	UINFO(4,"  Partition total="<<totalCost<<" min="<<minCost<<" max="<<maxCost<<endl);
+	mergeChains();
+	mergeSmall(minCost, maxCost);
+	m_mtasks.dumpDotFilePrefixed("partition_merged");
+
+	computePriorities();
+	MTaskVec scheduled;
+	schedule(scheduled);
+	buildExecGraph(scheduled, execGraphp);
+	execGraphp->mutableDepGraphp()->dumpDotFilePrefixed("partition_exec");
+
+	uint32_t criticalPath = 0;
+	for (MTaskVec::iterator it = scheduled.begin(); it != scheduled.end(); ++it) {
+	    criticalPath = std::max(criticalPath, (*it)->priority());
+	}
+	V3Stats::addStat("MTask, Count", scheduled.size());
+	V3Stats::addStat("MTask, Total cost", totalCost);
+	V3Stats::addStat("MTask, Critical path cost", criticalPath);
+    }
+};
+
+//######################################################################
+// Partition class functions
+
+void V3Partition::partition(OrderGraph* orderGraphp,
+			    const std::vector<OrderMoveVertex*>& vertices,
+			    AstExecGraph* execGraphp) {
+    UINFO(2,__FUNCTION__<<": "<<endl);
+    PartitionVisitor visitor (orderGraphp, v3Global.opt.threads());
+    visitor.main(vertices, execGraphp);
+}
+
+void V3Partition::finalize(AstNetlist* nodep) {
+    UINFO(2,__FUNCTION__<<": "<<endl);
+    if (AstExecGraph* execGraphp = nodep->execGraphp()) {
+	if (!nodep->evalp()) execGraphp->v3fatalSrc("ExecGraph without _eval");
+	AstScope* scopep = nodep->evalp()->scopep();
+	for (AstMTaskBody* bodyp = execGraphp->mTaskBodiesp(); bodyp;
+	     bodyp = bodyp->nextp()->castMTaskBody()) {
+	    ExecMTask* mtaskp = bodyp->execMTaskp();
+	    AstCFunc* funcp = new AstCFunc(bodyp->fileline(), mtaskp->cFuncName(), scopep);
+	    funcp->argTypes(EmitCBaseVisitor::symClassVar());
+	    funcp->dontCombine(true);
+	    funcp->symProlog(true);
+	    funcp->isStatic(true);
+	    scopep->addActivep(funcp);
+	    if (bodyp->stmtsp()) funcp->addStmtsp(bodyp->stmtsp()->unlinkFrBackWithNext());
+	    AstCCall* callp = new AstCCall(bodyp->fileline(), funcp);
+	    callp->argTypes("vlSymsp");
+	    bodyp->addStmtsp(callp);
+	}
+    }
+    V3Global::dumpCheckGlobalTree("partition", 0, v3Global.opt.dumpTreeLevel(__FILE__) >= 3);
+}
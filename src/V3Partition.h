@@ -0,0 +1,48 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//*************************************************************************
+// DESCRIPTION: Verilator: Partition the eval logic into macro-tasks
+//
+// Code available from: http://www.veripool.org/verilator
+//
+//*************************************************************************
+//
+// Copyright 2003-2018 by Wilson Snyder.  This program is free software; you can
+// redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+//
+// Verilator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+//*************************************************************************
+
+#ifndef _V3PARTITION_H_
+#define _V3PARTITION_H_ 1
+#include "config_build.h"
+#include "verilatedos.h"
+#include <vector>
+
+#include "V3Error.h"
+#include "V3Ast.h"
+
+class OrderGraph;
+class OrderMoveVertex;
+
+//============================================================================
+
+class V3Partition {
+public:
+    // Coarsen the given logic vertices of V3Order's move graph into
+    // macro-tasks, and statically schedule them onto --threads threads.
+    // Fills in execGraphp with an ExecMTask and MTASKBODY per macro-task,
+    // and points each OrderMoveVertex at the ExecMTask that will run it.
+    static void partition(OrderGraph* orderGraphp,
+			  const std::vector<OrderMoveVertex*>& vertices,
+			  AstExecGraph* execGraphp);
+    // After V3Clock, wrap each MTASKBODY's statements into its own CFunc.
+    static void finalize(AstNetlist* nodep);
+};
+
+#endif // Guard
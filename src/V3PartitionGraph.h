@@ -0,0 +1,110 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//*************************************************************************
+// DESCRIPTION: Verilator: Macro-task graph classes for multithreaded eval
+//
+// Code available from: http://www.veripool.org/verilator
+//
+//*************************************************************************
+//
+// Copyright 2003-2018 by Wilson Snyder.  This program is free software; you can
+// redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+//
+// Verilator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+//*************************************************************************
+
+#ifndef _V3PARTITIONGRAPH_H_
+#define _V3PARTITIONGRAPH_H_
+
+#include "config_build.h"
+#include "verilatedos.h"
+#include <algorithm>
+#include <vector>
+
+#include "V3Ast.h"
+#include "V3Graph.h"
+
+//######################################################################
+// ExecMTask -- one macro-task of the final, scheduled eval graph.
+// These live in AstExecGraph::depGraphp(); edges are dependencies.
+
+class ExecMTask : public V3GraphVertex {
+private:
+    AstMTaskBody*	m_bodyp;	// Task body
+    uint32_t		m_id;		// Unique id of this mtask, also the message ordering key
+    uint32_t		m_cost;		// Predicted runtime cost of this mtask
+    uint32_t		m_priority;	// Predicted critical path from start of this mtask to end of eval
+    uint32_t		m_thread;	// Thread for static scheduling, 0 is the eval() caller
+    uint32_t		m_startTime;	// Predicted start time, in cost units
+    string		m_profKeys;	// Profile keys and costs of its logic, for --prof-threads
+    VL_UNCOPYABLE(ExecMTask);
+public:
+    ExecMTask(V3Graph* graphp, AstMTaskBody* bodyp, uint32_t id)
+	: V3GraphVertex(graphp), m_bodyp(bodyp), m_id(id)
+	, m_cost(0), m_priority(0), m_thread(0), m_startTime(0) {}
+    virtual ~ExecMTask() {}
+    // ACCESSORS
+    AstMTaskBody* bodyp() const { return m_bodyp; }
+    uint32_t	id() const { return m_id; }
+    uint32_t	cost() const { return m_cost; }
+    void	cost(uint32_t cost) { m_cost = cost; }
+    uint32_t	priority() const { return m_priority; }
+    void	priority(uint32_t pri) { m_priority = pri; }
+    uint32_t	thread() const { return m_thread; }
+    void	thread(uint32_t thread) { m_thread = thread; }
+    uint32_t	startTime() const { return m_startTime; }
+    void	startTime(uint32_t time) { m_startTime = time; }
+    const string& profKeys() const { return m_profKeys; }
+    void	profKeys(const string& keys) { m_profKeys = keys; }
+    virtual string name() const { return string("mt")+cvtToStr(id()); }
+    virtual string dotColor() const { return "cyan"; }
+    // C++ names
+    string cFuncName() const { return string("_mtask__")+cvtToStr(id()); }
+    string cVertexName() const { return string("__Vm_mt_")+cvtToStr(id()); }
+    static string cThreadFuncName(uint32_t thread) { return string("__Vthread_")+cvtToStr(thread); }
+    // METHODS
+    // Number of dependencies on mtasks run by other threads; those signal
+    // our vertex counter, same-thread dependencies are satisfied by order.
+    uint32_t crossThreadDeps() const {
+	uint32_t deps = 0;
+	for (V3GraphEdge* edgep = inBeginp(); edgep; edgep = edgep->inNextp()) {
+	    const ExecMTask* fromp = static_cast<const ExecMTask*>(edgep->fromp());
+	    if (fromp->thread() != thread()) ++deps;
+	}
+	return deps;
+    }
+};
+
+//######################################################################
+// ExecSchedule -- mtasks of an AstExecGraph arranged per thread, in the
+// order each thread runs them (ascending id; ids follow the schedule).
+
+class ExecSchedule {
+    typedef std::vector<const ExecMTask*> MTaskVec;
+    std::vector<MTaskVec>	m_threads;	// Per-thread ordered mtasks
+    struct CmpId {
+	inline bool operator() (const ExecMTask* lhsp, const ExecMTask* rhsp) const {
+	    return lhsp->id() < rhsp->id(); }
+    };
+public:
+    explicit ExecSchedule(const V3Graph* graphp) {
+	for (const V3GraphVertex* vxp = graphp->verticesBeginp(); vxp; vxp = vxp->verticesNextp()) {
+	    const ExecMTask* mtaskp = static_cast<const ExecMTask*>(vxp);
+	    if (mtaskp->thread() >= m_threads.size()) m_threads.resize(mtaskp->thread()+1);
+	    m_threads[mtaskp->thread()].push_back(mtaskp);
+	}
+	if (m_threads.empty()) m_threads.resize(1);  // Thread 0 always exists
+	for (std::vector<MTaskVec>::iterator it = m_threads.begin(); it != m_threads.end(); ++it) {
+	    std::sort(it->begin(), it->end(), CmpId());
+	}
+    }
+    uint32_t threads() const { return m_threads.size(); }
+    const MTaskVec& thread(uint32_t thread) const { return m_threads[thread]; }
+};
+
+#endif  // Guard
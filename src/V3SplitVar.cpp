@@ -0,0 +1,312 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//*************************************************************************
+// DESCRIPTION: Verilator: Split packed variables into independent slices
+//
+// Code available from: http://www.veripool.org/verilator
+//
+//*************************************************************************
+//
+// Copyright 2003-2018 by Wilson Snyder.  This program is free software; you can
+// redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+//
+// Verilator is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+//*************************************************************************
+// V3SplitVar's Transformations:
+//
+//	A packed vector whose bits are driven by different logic blocks
+//	is a single vertex to V3Order, so bits feeding each other through
+//	separate blocks look like a loop (UNOPTFLAT) even when no bit
+//	depends on itself.
+//
+//	For each VARSCOPE that is an internal packed signal:
+//	    Every reference must be a SEL with constant lsb and width,
+//	    and every write must be the lhs of an assignment.
+//	    Must be written by two or more logic blocks.
+//	If so, cut the variable at every written SEL boundary into new
+//	variables, one per slice:
+//	    Reads become the SEL or CONCAT of the slices covered.
+//	    Writes become one assignment per slice covered; a non-trivial
+//	    rhs is first assigned to a temporary so it is computed once.
+//
+//*************************************************************************
+
+#include "config_build.h"
+#include "verilatedos.h"
+#include <cstdio>
+#include <cstdarg>
+#include <unistd.h>
+#include <algorithm>
+#include <set>
+#include <map>
+#include <vector>
+
+#include "V3Global.h"
+#include "V3SplitVar.h"
+#include "V3Stats.h"
+#include "V3Ast.h"
+
+//######################################################################
+
+class SplitVarBaseVisitor : public AstNVisitor {
+public:
+    // METHODS
+    static int debug() {
+	static int level = -1;
+	if (VL_UNLIKELY(level < 0)) level = v3Global.opt.debugSrcLevel(__FILE__);
+	return level;
+    }
+};
+
+//######################################################################
+// Information about one candidate variable
+
+class SplitVarInfo {
+public:
+    // TYPES
+    struct Slice {
+	int		m_lsb;		// Low bit in original variable
+	int		m_width;	// Width of slice
+	AstVarScope*	m_vscp;		// New variable holding the slice
+	Slice(int lsb, int width, AstVarScope* vscp) : m_lsb(lsb), m_width(width), m_vscp(vscp) {}
+    };
+    typedef std::vector<Slice> SliceVec;
+    // MEMBERS
+    AstVarScope*	m_vscp;		// Original variable
+    bool		m_reject;	// Cannot be split
+    std::set<AstNode*>	m_writers;	// Logic blocks writing the variable
+    std::set<int>	m_bounds;	// Bit boundaries of written SELs
+    std::vector<AstVarRef*> m_refps;	// All references, each the fromp of a SEL
+    SliceVec		m_slices;	// Slices once split, ascending lsb
+    // CONSTRUCTORS
+    explicit SplitVarInfo(AstVarScope* vscp) : m_vscp(vscp), m_reject(false) {}
+};
+
+//######################################################################
+// SplitVar class functions
+
+class SplitVarVisitor : public SplitVarBaseVisitor {
+private:
+    // NODE STATE
+    //  AstVarScope::user1()	-> int.  Index+1 into m_infos, if a candidate
+    AstUser1InUse	m_inuser1;
+
+    // TYPES
+    typedef std::map<std::pair<AstNodeModule*,string>,AstVar*> VarMap;
+
+    // STATE
+    std::vector<SplitVarInfo> m_infos;	// Candidate variables
+    VarMap		m_modVarMap;	// Table of new var names created under module
+    AstNode*		m_logicp;	// Current logic block under an ACTIVE, or NULL
+    int			m_tempNum;	// Number of temporaries created
+    V3Double0		m_statSplitVars;	// Statistic tracking
+    V3Double0		m_statSlices;	// Statistic tracking
+
+    // METHODS
+    static bool isCandidate(AstVarScope* vscp) {
+	AstVar* varp = vscp->varp();
+	AstBasicDType* bdtypep = varp->dtypeSkipRefp()->castBasicDType();
+	return (bdtypep && !bdtypep->isOpaque()
+		&& varp->width() > 1
+		&& varp->isSignal()
+		&& !varp->isIO()
+		&& !varp->isSigPublic()
+		&& !varp->isUsedClock()
+		&& !varp->isSc()
+		&& !varp->attrClockEn()
+		&& !varp->attrIsolateAssign()
+		// The trace would show the unsplit variable, which is no longer written
+		&& !(v3Global.opt.trace() && varp->isTrace()));
+    }
+    SplitVarInfo* findInfop(AstVarScope* vscp) {
+	if (!vscp->user1()) return NULL;
+	return &m_infos[vscp->user1()-1];
+    }
+
+    AstVarScope* createVarSc(AstVarScope* oldvarscp, const string& name, int width) {
+	// Scoped already, so need both the AstVar and the AstVarScope;
+	// one AstVar per module is shared among all scopes of the module
+	AstNodeModule* addmodp = oldvarscp->scopep()->modp();
+	AstVar* varp;
+	VarMap::iterator it = m_modVarMap.find(make_pair(addmodp,name));
+	if (it != m_modVarMap.end()) {
+	    varp = it->second;
+	} else {
+	    varp = new AstVar(oldvarscp->fileline(), AstVarType::MODULETEMP, name,
+			      VFlagLogicPacked(), width);
+	    addmodp->addStmtp(varp);
+	    m_modVarMap.insert(make_pair(make_pair(addmodp, name), varp));
+	}
+	AstVarScope* varscp = new AstVarScope(oldvarscp->fileline(), oldvarscp->scopep(), varp);
+	oldvarscp->scopep()->addVarp(varscp);
+	return varscp;
+    }
+
+    AstNode* newSliceRef(const SplitVarInfo::Slice& slice, FileLine* fl,
+			 int lsb, int width, bool lvalue) {
+	// Reference bits [lsb+width-1:lsb] of the original, all within this slice
+	AstNode* refp = new AstVarRef(fl, slice.m_vscp, lvalue);
+	if (lsb == slice.m_lsb && width == slice.m_width) return refp;
+	return new AstSel(fl, refp, lsb - slice.m_lsb, width);
+    }
+
+    void splitVar(SplitVarInfo& info) {
+	AstVarScope* vscp = info.m_vscp;
+	UINFO(4,"  Split "<<vscp<<endl);
+	info.m_bounds.insert(0);
+	info.m_bounds.insert(vscp->width());
+	std::set<int>::iterator it = info.m_bounds.begin();
+	int lsb = *it;
+	for (++it; it != info.m_bounds.end(); ++it) {
+	    int width = *it - lsb;
+	    string name = vscp->varp()->name()+"__Vsplit"+cvtToStr(lsb+width-1)+"_"+cvtToStr(lsb);
+	    info.m_slices.push_back(SplitVarInfo::Slice(lsb, width, createVarSc(vscp, name, width)));
+	    lsb = *it;
+	}
+	++m_statSplitVars;
+	m_statSlices += info.m_slices.size();
+	for (std::vector<AstVarRef*>::iterator rit = info.m_refps.begin();
+	     rit != info.m_refps.end(); ++rit) {
+	    AstSel* selp = (*rit)->backp()->castSel();
+	    if ((*rit)->lvalue()) splitWrite(info, selp);
+	    else splitRead(info, selp);
+	}
+    }
+    void splitRead(const SplitVarInfo& info, AstSel* selp) {
+	// Concatenate the pieces of each slice covered, high slices to the left
+	FileLine* fl = selp->fileline();
+	int lsb = selp->lsbConst();
+	int msb = selp->msbConst();
+	AstNode* newp = NULL;
+	for (SplitVarInfo::SliceVec::const_iterator it = info.m_slices.begin();
+	     it != info.m_slices.end(); ++it) {
+	    int lo = std::max(lsb, it->m_lsb);
+	    int hi = std::min(msb, it->m_lsb + it->m_width - 1);
+	    if (lo > hi) continue;
+	    AstNode* partp = newSliceRef(*it, fl, lo, hi-lo+1, false);
+	    newp = newp ? new AstConcat(fl, partp, newp) : partp;
+	}
+	selp->replaceWith(newp);
+	pushDeletep(selp); VL_DANGLING(selp);
+    }
+    void splitWrite(const SplitVarInfo& info, AstSel* selp) {
+	AstNodeAssign* assp = selp->backp()->castNodeAssign();
+	FileLine* fl = assp->fileline();
+	int lsb = selp->lsbConst();
+	int msb = selp->msbConst();
+	std::vector<const SplitVarInfo::Slice*> slices;
+	for (SplitVarInfo::SliceVec::const_iterator it = info.m_slices.begin();
+	     it != info.m_slices.end(); ++it) {
+	    if (it->m_lsb <= msb && lsb < it->m_lsb + it->m_width) slices.push_back(&(*it));
+	}
+	if (slices.size() == 1) {
+	    // Slice boundaries include all written SELs, so it covers exactly
+	    selp->replaceWith(newSliceRef(*slices[0], fl, lsb, msb-lsb+1, true));
+	    pushDeletep(selp); VL_DANGLING(selp);
+	    return;
+	}
+	// The written SEL spans several slices; compute the rhs once
+	AstNode* rhsp = assp->rhsp()->unlinkFrBack();
+	if (!rhsp->castConst() && !rhsp->castVarRef()) {
+	    AstVarScope* tempVscp = createVarSc(info.m_vscp, "__Vsplittemp"+cvtToStr(m_tempNum++),
+						rhsp->width());
+	    AstNode* tempAssp;
+	    if (assp->castAssignW()) {
+		tempAssp = new AstAssignW(fl, new AstVarRef(fl, tempVscp, true), rhsp);
+	    } else {
+		tempAssp = new AstAssign(fl, new AstVarRef(fl, tempVscp, true), rhsp);
+	    }
+	    assp->addHereThisAsNext(tempAssp);
+	    rhsp = new AstVarRef(fl, tempVscp, false);
+	}
+	for (std::vector<const SplitVarInfo::Slice*>::iterator it = slices.begin();
+	     it != slices.end(); ++it) {
+	    int lo = (*it)->m_lsb;
+	    int width = (*it)->m_width;
+	    AstNode* newp = assp->cloneType(newSliceRef(**it, fl, lo, width, true),
+					    new AstSel(fl, rhsp->cloneTree(false), lo - lsb, width));
+	    assp->addNextHere(newp);
+	}
+	rhsp->deleteTree(); VL_DANGLING(rhsp);
+	assp->unlinkFrBack(); pushDeletep(assp); VL_DANGLING(assp);
+    }
+
+    // VISITORS
+    virtual void visit(AstNetlist* nodep) {
+	nodep->iterateChildren(*this);
+	for (std::vector<SplitVarInfo>::iterator it = m_infos.begin(); it != m_infos.end(); ++it) {
+	    if (!it->m_reject && it->m_writers.size() > 1) splitVar(*it);
+	}
+    }
+    virtual void visit(AstVarScope* nodep) {
+	if (isCandidate(nodep)) {
+	    m_infos.push_back(SplitVarInfo(nodep));
+	    nodep->user1(m_infos.size());
+	}
+    }
+    virtual void visit(AstActive* nodep) {
+	if (nodep->sensesStorep()) nodep->sensesStorep()->accept(*this);
+	for (AstNode* stmtp = nodep->stmtsp(); stmtp; stmtp = stmtp->nextp()) {
+	    m_logicp = stmtp;
+	    stmtp->accept(*this);
+	}
+	m_logicp = NULL;
+    }
+    virtual void visit(AstVarRef* nodep) {
+	SplitVarInfo* infop = findInfop(nodep->varScopep());
+	if (!infop || infop->m_reject) return;
+	// Only constant selects of the whole variable
+	AstSel* selp = nodep->backp()->castSel();
+	if (!selp || selp->fromp() != nodep
+	    || !selp->lsbp()->castConst() || !selp->widthp()->castConst()
+	    || selp->lsbConst() < 0 || selp->msbConst() >= nodep->width()) {
+	    UINFO(5,"  Reject, not constant select: "<<nodep<<endl);
+	    infop->m_reject = true;
+	    return;
+	}
+	if (nodep->lvalue()) {
+	    AstNodeAssign* assp = selp->backp()->castNodeAssign();
+	    if (!m_logicp || !assp || assp->lhsp() != selp) {
+		UINFO(5,"  Reject, not assignment lhs: "<<nodep<<endl);
+		infop->m_reject = true;
+		return;
+	    }
+	    infop->m_writers.insert(m_logicp);
+	    infop->m_bounds.insert(selp->lsbConst());
+	    infop->m_bounds.insert(selp->msbConst()+1);
+	}
+	infop->m_refps.push_back(nodep);
+    }
+    virtual void visit(AstNode* nodep) {
+	nodep->iterateChildren(*this);
+    }
+
+public:
+    // CONSTUCTORS
+    explicit SplitVarVisitor(AstNetlist* nodep) {
+	m_logicp = NULL;
+	m_tempNum = 0;
+	AstNode::user1ClearTree();	// user1p() used on entire tree
+	nodep->accept(*this);
+    }
+    virtual ~SplitVarVisitor() {
+	V3Stats::addStat("Optimizations, Split packed variables", m_statSplitVars);
+	V3Stats::addStat("Optimizations, Split packed variable slices", m_statSlices);
+    }
+};
+
+//######################################################################
+// SplitVar class functions
+
+void V3SplitVar::splitVarAll(AstNetlist* nodep) {
+    UINFO(2,__FUNCTION__<<": "<<endl);
+    {
+	SplitVarVisitor visitor (nodep);
+    }  // Destruct before checking
+    V3Global::dumpCheckGlobalTree("splitvar", 0, v3Global.opt.dumpTreeLevel(__FILE__) >= 3);
+}
@@ -306,6 +306,10 @@ private:
 			// If all functions in the calls are slow, we'll share the same code.
 			// This makes us need less activityNumbers and so speeds up the fast path.
 			vvertexp->activityCode(TraceActivityVertex::ACTIVITY_SLOW);
+		    } else if (v3Global.opt.mtasks()) {
+			// Mtasks would race setting bits of the shared activity
+			// word, so with threads the fast path always traces
+			vvertexp->activityCode(TraceActivityVertex::ACTIVITY_ALWAYS);
 		    } else {
 			vvertexp->activityCode(activityNumber++);
 		    }
@@ -29,6 +29,7 @@
 #include "V3AssertPre.h"
 #include "V3Begin.h"
 #include "V3Branch.h"
+#include "V3BranchProf.h"
 #include "V3Case.h"
 #include "V3Cast.h"
 #include "V3Changed.h"
@@ -73,12 +74,14 @@
 #include "V3Param.h"
 #include "V3Parse.h"
 #include "V3ParseSym.h"
+#include "V3Partition.h"
 #include "V3PreShell.h"
 #include "V3Premit.h"
 #include "V3Scope.h"
 #include "V3Slice.h"
 #include "V3Split.h"
 #include "V3SplitAs.h"
+#include "V3SplitVar.h"
 #include "V3Stats.h"
 #include "V3String.h"
 #include "V3Subst.h"
@@ -289,6 +292,11 @@ void process () {
 	V3Dead::deadifyDTypesScoped(v3Global.rootp());
 	v3Global.checkTree();
 
+	// Count or apply profiled branch arms, before V3Case changes case statements
+	if (v3Global.opt.profBranches() || v3Global.opt.profBranchesData() != "") {
+	    V3BranchProf::branchProfAll(v3Global.rootp());
+	}
+
 	// Convert case statements to if() blocks.  Must be after V3Unknown
 	// Must be before V3Task so don't need to deal with task in case value compares
 	V3Case::caseAll(v3Global.rootp());
@@ -370,6 +378,11 @@ void process () {
 	    return;
 	}
 
+	// Split packed variables driven by separate blocks, to break false loops
+	if (v3Global.opt.oSplitVar()) {
+	    V3SplitVar::splitVarAll(v3Global.rootp());
+	}
+
 	// Reorder assignments in pipelined blocks
 	if (v3Global.opt.oReorder()) {
 	    V3Split::splitReorderAll(v3Global.rootp());
@@ -394,13 +407,19 @@ void process () {
 	// Convert sense lists into IF statements.
 	V3Clock::clockAll(v3Global.rootp());
 
+	// Wrap each multithreaded macro-task into its own function
+	if (v3Global.opt.mtasks()) {
+	    V3Partition::finalize(v3Global.rootp());
+	}
+
 	// Cleanup any dly vars or other temps that are simple assignments
 	// Life must be done before Subst, as it assumes each CFunc under _eval is called only once.
 	if (v3Global.opt.oLife()) {
 	    V3Const::constifyAll(v3Global.rootp());
 	    V3Life::lifeAll(v3Global.rootp());
 	}
-	if (v3Global.opt.oLifePost()) {
+	// LifePost assumes _eval runs its logic serially, which isn't so with mtasks
+	if (v3Global.opt.oLifePost() && !v3Global.opt.mtasks()) {
 	    V3LifePost::lifepostAll(v3Global.rootp());
 	}
 
@@ -565,6 +584,9 @@ int main(int argc, char** argv, char** env) {
 	&& !v3Global.opt.cdc()) {
 	v3fatal("verilator: Need --cc, --sc, --cdc, --lint-only, --xml_only or --E option");
     }
+    if (v3Global.opt.profThreads() && !v3Global.opt.mtasks()) {
+	v3fatal("verilator: --prof-threads requires --threads 2 or more");
+    }
     // Check environment
     V3Options::getenvSYSTEMC();
     V3Options::getenvSYSTEMC_ARCH();
@@ -0,0 +1,65 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+#include <verilated.h>
+#include VM_PREFIX_INCLUDE
+#include <vector>
+
+vluint64_t main_time = 0;
+double sc_time_stamp() { return main_time; }
+
+// Records the regions it maps, to check the model's state lies in them
+class TestAllocator : public VerilatedHugePageAllocator {
+public:
+    std::vector<std::pair<char*, size_t> > m_regions;
+    explicit TestAllocator(int firstTouchThreads)
+        : VerilatedHugePageAllocator(firstTouchThreads) {}
+    virtual void* allocate(size_t size) {
+        void* memp = VerilatedHugePageAllocator::allocate(size);
+        m_regions.push_back(std::make_pair(static_cast<char*>(memp), size));
+        return memp;
+    }
+    bool contains(const void* startp, size_t size) const {
+        const char* cstartp = static_cast<const char*>(startp);
+        for (size_t i = 0; i < m_regions.size(); ++i) {
+            if (cstartp >= m_regions[i].first
+                && cstartp + size <= m_regions[i].first + m_regions[i].second) return true;
+        }
+        return false;
+    }
+};
+
+int main(int argc, char** argv, char** env) {
+    Verilated::commandArgs(argc, argv);
+    TestAllocator* allocp = new TestAllocator(2);
+    // The constructor picks up the allocator the model was placed with
+    VM_PREFIX* topp = new (allocp) VM_PREFIX("top");
+    // Both the top module, where inlining puts most state, and the rest
+    if (!allocp->contains(topp, sizeof(*topp))) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Top module not in allocator's region");
+    }
+    if (!allocp->contains(topp->__VlSymsp, 1)) {  // Syms class is incomplete here
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Symbol table not in allocator's region");
+    }
+    if (reinterpret_cast<uintptr_t>(topp) % VL_CACHE_LINE_BYTES) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Top module not cache line aligned");
+    }
+    topp->clk = 0;
+    topp->eval();
+    while (!Verilated::gotFinish() && main_time < 1000) {
+        main_time += 5;
+        topp->clk = !topp->clk;
+        topp->eval();
+    }
+    if (!Verilated::gotFinish()) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Timeout; never got a $finish");
+    }
+    topp->final();
+    delete topp; topp = NULL;
+    delete allocp; allocp = NULL;
+    return 0;
+}
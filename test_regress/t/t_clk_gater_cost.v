@@ -0,0 +1,75 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer 	cyc=0;
+   reg [63:0]	crc;
+
+   reg 		en = 1'b0;
+   reg 		qen = 1'b0;
+   always @ (posedge clk) begin
+      en <= crc[0];
+      qen <= crc[1];
+   end
+
+   // Register bank with enough logic behind its enable to be worth gating
+   reg [31:0] 	bank0 = 32'h0, bank1 = 32'h0, bank2 = 32'h0, bank3 = 32'h0;
+   always @ (posedge clk) begin
+      if (en) begin
+	 bank0 <= (bank0 * 32'd3) + (crc[31:0] ^ (bank1 >> 3));
+	 bank1 <= (bank1 * 32'd5) + (crc[63:32] ^ (bank2 << 2));
+	 bank2 <= (bank2 * 32'd7) + (crc[47:16] ^ (bank3 >> 1));
+	 bank3 <= (bank3 * 32'd9) + (crc[39:8] ^ (bank0 << 5));
+      end
+   end
+
+   // Single flop, cheaper than testing another clock domain
+   reg 		q = 1'b0;
+   always @ (posedge clk) begin
+      if (qen) q <= crc[2];
+   end
+
+   // Same logic, left ungated as the blocking assignment prevents it
+   reg [31:0] 	ref0 = 32'h0, ref1 = 32'h0, ref2 = 32'h0, ref3 = 32'h0;
+   reg 		refq = 1'b0;
+   reg 		refen;
+   always @ (posedge clk) begin
+      refen = en;
+      if (refen) begin
+	 ref0 <= (ref0 * 32'd3) + (crc[31:0] ^ (ref1 >> 3));
+	 ref1 <= (ref1 * 32'd5) + (crc[63:32] ^ (ref2 << 2));
+	 ref2 <= (ref2 * 32'd7) + (crc[47:16] ^ (ref3 >> 1));
+	 ref3 <= (ref3 * 32'd9) + (crc[39:8] ^ (ref0 << 5));
+      end
+      if (qen) refq <= crc[2];
+   end
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      crc <= {crc[62:0], crc[63]^crc[2]^crc[0]};
+      if (cyc==0) begin
+	 crc <= 64'h5aef0c8d_d70a4497;
+      end
+      else if (cyc<90) begin
+`ifdef TEST_VERBOSE
+	 $write("[%0t] cyc=%0d en=%b bank0=%x ref0=%x q=%b\n", $time, cyc, en, bank0, ref0, q);
+`endif
+	 if (bank0 !== ref0) $stop;
+	 if (bank1 !== ref1) $stop;
+	 if (bank2 !== ref2) $stop;
+	 if (bank3 !== ref3) $stop;
+	 if (q !== refq) $stop;
+      end
+      else if (cyc==99) begin
+	 $write("*-* All Finished *-*\n");
+	 $finish;
+      end
+   end
+endmodule
@@ -0,0 +1,98 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer 	cyc=0;
+   reg [63:0]	crc;
+
+   reg 		en = 1'b0;
+   reg 		pulse = 1'b0;
+   always @ (posedge clk) begin
+      en <= crc[0];
+   end
+   // Second clock, rising between posedges of clk
+   always @ (negedge clk) begin
+      pulse <= crc[3];
+   end
+
+   // Gated, as in t_clk_gater_cost
+   reg [31:0] 	bank0 = 32'h0, bank1 = 32'h0, bank2 = 32'h0, bank3 = 32'h0;
+   always @ (posedge clk) begin
+      if (en) begin
+	 bank0 <= (bank0 * 32'd3) + (crc[31:0] ^ (bank1 >> 3));
+	 bank1 <= (bank1 * 32'd5) + (crc[63:32] ^ (bank2 << 2));
+	 bank2 <= (bank2 * 32'd7) + (crc[47:16] ^ (bank3 >> 1));
+	 bank3 <= (bank3 * 32'd9) + (crc[39:8] ^ (bank0 << 5));
+      end
+   end
+
+   // Same enable, but two clocks; must update on edges of both
+   reg [31:0] 	mbank0 = 32'h0, mbank1 = 32'h0, mbank2 = 32'h0, mbank3 = 32'h0;
+   always @ (posedge clk or posedge pulse) begin
+      if (en) begin
+	 mbank0 <= (mbank0 * 32'd3) + (crc[31:0] ^ (mbank1 >> 3));
+	 mbank1 <= (mbank1 * 32'd5) + (crc[63:32] ^ (mbank2 << 2));
+	 mbank2 <= (mbank2 * 32'd7) + (crc[47:16] ^ (mbank3 >> 1));
+	 mbank3 <= (mbank3 * 32'd9) + (crc[39:8] ^ (mbank0 << 5));
+      end
+   end
+
+   // Same logic, left ungated as the blocking assignments prevent it
+   reg [31:0] 	ref0 = 32'h0, ref1 = 32'h0, ref2 = 32'h0, ref3 = 32'h0;
+   reg 		refen;
+   always @ (posedge clk) begin
+      refen = en;
+      if (refen) begin
+	 ref0 <= (ref0 * 32'd3) + (crc[31:0] ^ (ref1 >> 3));
+	 ref1 <= (ref1 * 32'd5) + (crc[63:32] ^ (ref2 << 2));
+	 ref2 <= (ref2 * 32'd7) + (crc[47:16] ^ (ref3 >> 1));
+	 ref3 <= (ref3 * 32'd9) + (crc[39:8] ^ (ref0 << 5));
+      end
+   end
+   reg [31:0] 	mref0 = 32'h0, mref1 = 32'h0, mref2 = 32'h0, mref3 = 32'h0;
+   reg 		mrefen;
+   always @ (posedge clk or posedge pulse) begin
+      mrefen = en;
+      if (mrefen) begin
+	 mref0 <= (mref0 * 32'd3) + (crc[31:0] ^ (mref1 >> 3));
+	 mref1 <= (mref1 * 32'd5) + (crc[63:32] ^ (mref2 << 2));
+	 mref2 <= (mref2 * 32'd7) + (crc[47:16] ^ (mref3 >> 1));
+	 mref3 <= (mref3 * 32'd9) + (crc[39:8] ^ (mref0 << 5));
+      end
+   end
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      crc <= {crc[62:0], crc[63]^crc[2]^crc[0]};
+      if (cyc==0) begin
+	 crc <= 64'h5aef0c8d_d70a4497;
+      end
+      else if (cyc<90) begin
+`ifdef TEST_VERBOSE
+	 $write("[%0t] cyc=%0d en=%b bank0=%x ref0=%x mbank0=%x mref0=%x\n",
+		$time, cyc, en, bank0, ref0, mbank0, mref0);
+`endif
+	 if (bank0 !== ref0) $stop;
+	 if (bank1 !== ref1) $stop;
+	 if (bank2 !== ref2) $stop;
+	 if (bank3 !== ref3) $stop;
+	 if (mbank0 !== mref0) $stop;
+	 if (mbank1 !== mref1) $stop;
+	 if (mbank2 !== mref2) $stop;
+	 if (mbank3 !== mref3) $stop;
+      end
+      else if (cyc==99) begin
+	 // The second clock's edges were seen
+	 if (mbank0 === bank0) $stop;
+	 $write("*-* All Finished *-*\n");
+	 $finish;
+      end
+   end
+endmodule
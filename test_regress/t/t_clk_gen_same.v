@@ -0,0 +1,50 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer 	cyc=0;
+   reg [63:0]	crc;
+
+   // Divided clock whose domain reads only its own state, so it
+   // evaluates in the same eval pass as the clock generating it
+   reg 		div = 1'b0;
+   reg [7:0] 	cnt = 8'h0;
+   always @ (posedge clk) div <= ~div;
+   always @ (posedge div) cnt <= cnt + 8'd1;
+
+   // Divided clock whose domain samples clk domain state, which must
+   // be seen after its update, so needs another eval pass
+   reg 		div2 = 1'b0;
+   reg [7:0] 	sample = 8'h0;
+   reg [7:0] 	last = 8'h0;
+   always @ (posedge clk) div2 <= ~div2;
+   always @ (posedge div2) sample <= crc[7:0];
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      crc <= {crc[62:0], crc[63]^crc[2]^crc[0]};
+      last <= crc[7:0];
+      if (cyc==0) begin
+	 crc <= 64'h5aef0c8d_d70a4497;
+      end
+      else if (cyc<90) begin
+`ifdef TEST_VERBOSE
+	 $write("[%0t] cyc=%0d cnt=%0d sample=%x last=%x\n", $time, cyc, cnt, sample, last);
+`endif
+	 if (cnt !== (cyc+1)/2) $stop;
+	 // div2 rose on the previous edge, and sampled crc after that edge's update
+	 if (cyc[0] && sample !== crc[7:0]) $stop;
+      end
+      else if (cyc==99) begin
+	 $write("*-* All Finished *-*\n");
+	 $finish;
+      end
+   end
+endmodule
@@ -0,0 +1,38 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+#include <verilated.h>
+#include VM_PREFIX_INCLUDE
+
+double sc_time_stamp() { return 0; }  // Unused, the context has its own time
+
+int main(int argc, char** argv, char** env) {
+    VerilatedContext* contextp = new VerilatedContext;
+    VM_PREFIX* topp = new VM_PREFIX("top", contextp);
+    topp->clk = 0;
+    topp->eval();
+    while (!contextp->gotFinish() && contextp->time() < 1000) {
+        contextp->timeInc(5);
+        topp->clk = !topp->clk;
+        topp->eval();
+    }
+    if (!contextp->gotFinish()) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Timeout; never got a $finish");
+    }
+    topp->final();
+    delete topp; topp = NULL;
+    // The model made contextp this thread's context; deleting the context
+    // must fall back to the default context rather than leave it dangling
+    delete contextp; contextp = NULL;
+    if (Verilated::threadContextp() != Verilated::defaultContextp()) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Deleted context still the thread's context");
+    }
+    if (Verilated::gotFinish()) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: $finish leaked into the default context");
+    }
+    exit(0);
+}
@@ -0,0 +1,50 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+#include <verilated.h>
+#include VM_PREFIX_INCLUDE
+#include <thread>
+
+double sc_time_stamp() { return 0; }  // Unused, each context has its own time
+
+// Run one simulation in its own context, as a separate test seed would
+static void runSeed(VerilatedContext* contextp, const char* plusargp, vluint64_t* finishTimep) {
+    const char* argv[] = { "t_context_multi", plusargp };
+    contextp->commandArgs(2, argv);
+    VM_PREFIX* topp = new VM_PREFIX("top", contextp);
+    topp->clk = 0;
+    topp->eval();
+    while (!contextp->gotFinish() && contextp->time() < 1000) {
+        contextp->timeInc(5);
+        topp->clk = !topp->clk;
+        topp->eval();
+    }
+    *finishTimep = contextp->time();
+    topp->final();
+    delete topp; topp = NULL;
+}
+
+int main(int argc, char** argv, char** env) {
+    VerilatedContext context2;
+    VerilatedContext context4;
+    vluint64_t finish2 = 0;
+    vluint64_t finish4 = 0;
+    std::thread thread2 (runSeed, &context2, "+seed=2", &finish2);
+    std::thread thread4 (runSeed, &context4, "+seed=4", &finish4);
+    thread2.join();
+    thread4.join();
+    if (!context2.gotFinish() || !context4.gotFinish()) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Timeout; never got a $finish");
+    }
+    if (finish2 != 205 || finish4 != 405) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Simulations finished at wrong times");
+    }
+    if (Verilated::defaultContextp()->gotFinish()) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: $finish leaked into the default context");
+    }
+    exit(0);
+}
@@ -0,0 +1,29 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+
+   input clk;
+
+   integer cyc = 0;
+   integer seed;
+
+   initial begin
+      if (!$value$plusargs("seed=%d", seed)) $stop;
+   end
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      // Each simulation's time is its own context's
+      if ($time != cyc*10 + 5) $stop;
+      if (cyc == seed*10) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
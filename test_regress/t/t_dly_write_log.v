@@ -0,0 +1,76 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer 	cyc=0;
+   reg [63:0]	crc;
+
+   // Written from several sites, so committed from a write log
+   reg [7:0] 	mem [0:15];
+   // Same writes, but bit selects keep the per-site delayed variables
+   wire [7:0] 	d0 = crc[15:8];
+   wire [7:0] 	d1 = crc[23:16];
+   wire [7:0] 	d2 = ~crc[39:32];
+   reg [7:0] 	memref [0:15];
+
+   integer 	i;
+   initial begin
+      for (i=0; i<16; i=i+1) begin
+	 mem[i] = 8'h0;
+	 memref[i] = 8'h0;
+      end
+   end
+
+   always @ (posedge clk) begin
+      if (cyc[0]) mem[{1'b0, crc[2:0]}] <= crc[15:8];
+      mem[{1'b0, crc[6:4]}] <= crc[23:16];  // Same address as above wins
+      if (crc[9]) mem[{1'b1, crc[26:24]}] <= ~crc[39:32];
+   end
+   always @ (posedge clk) begin
+      if (cyc[1]) mem[{1'b1, crc[12:10]}] <= 8'h5a;
+   end
+
+   always @ (posedge clk) begin
+      if (cyc[0]) begin
+	 memref[{1'b0, crc[2:0]}][7:4] <= d0[7:4];
+	 memref[{1'b0, crc[2:0]}][3:0] <= d0[3:0];
+      end
+      memref[{1'b0, crc[6:4]}][7:4] <= d1[7:4];
+      memref[{1'b0, crc[6:4]}][3:0] <= d1[3:0];
+      if (crc[9]) begin
+	 memref[{1'b1, crc[26:24]}][7:4] <= d2[7:4];
+	 memref[{1'b1, crc[26:24]}][3:0] <= d2[3:0];
+      end
+      if (cyc[1]) begin
+	 memref[{1'b1, crc[12:10]}][7:4] <= 4'h5;
+	 memref[{1'b1, crc[12:10]}][3:0] <= 4'ha;
+      end
+   end
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      crc <= {crc[62:0], crc[63]^crc[2]^crc[0]};
+      if (cyc==0) begin
+	 crc <= 64'h5aef0c8d_d70a4497;
+      end
+      else if (cyc<90) begin
+	 for (i=0; i<16; i=i+1) begin
+	    if (mem[i] !== memref[i]) begin
+	       $write("%%Error: cyc=%0d mem[%0d]=%x expected %x\n", cyc, i, mem[i], memref[i]);
+	       $stop;
+	    end
+	 end
+      end
+      else if (cyc==99) begin
+	 $write("*-* All Finished *-*\n");
+	 $finish;
+      end
+   end
+endmodule
@@ -0,0 +1,47 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+#include "Vt_eval_clk.h"
+#include "verilated.h"
+
+#define CHECK(got, exp) \
+    if ((got) != (exp)) { \
+	VL_PRINTF("%%Error: %s:%d: GOT = %u  EXP = %u\n", __FILE__, __LINE__, \
+		  static_cast<unsigned>(got), static_cast<unsigned>(exp)); \
+	return 1; \
+    }
+
+int main(int argc, char** argv, char** env) {
+    Vt_eval_clk* topp = new Vt_eval_clk;
+    topp->clka = 0;
+    topp->clkb = 0;
+    topp->in = 0;
+    topp->eval();
+    for (int i = 1; i <= 20; ++i) {
+	// clka twice as fast as clkb, each changing in its own eval
+	topp->clka = 1;
+	topp->in = i;
+	topp->eval_clk_clka();
+	topp->clka = 0;
+	topp->eval_clk_clka();
+	if (i % 2 == 0) {
+	    topp->clkb = !topp->clkb;
+	    topp->eval_clk_clkb();
+	}
+	CHECK(topp->cnta, i);
+	CHECK(topp->cntb, (i + 2) / 4);
+	CHECK(topp->cntdiv, (i + 1) / 2);
+	CHECK(topp->sum, topp->cnta + topp->cntb + topp->cntdiv + i);
+    }
+    // Full eval still agrees
+    topp->clka = 1;
+    topp->clkb = !topp->clkb;
+    topp->eval();
+    CHECK(topp->cnta, 21);
+    topp->final();
+    delete topp; topp = NULL;
+    VL_PRINTF("*-* All Finished *-*\n");
+    return 0;
+}
@@ -0,0 +1,36 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+module t (/*AUTOARG*/
+   // Outputs
+   cnta, cntb, cntdiv, sum,
+   // Inputs
+   clka, clkb, in
+   );
+   input clka;
+   input clkb;
+   input [7:0] in;
+   output reg [31:0] cnta;
+   output reg [31:0] cntb;
+   output reg [31:0] cntdiv;
+   output [31:0] sum;
+
+   reg 	      diva;	// Clock generated from clka
+   initial begin
+      cnta = 0;
+      cntb = 0;
+      cntdiv = 0;
+      diva = 0;
+   end
+
+   assign sum = cnta + cntb + cntdiv + {24'h0, in};
+
+   always @ (posedge clka) begin
+      cnta <= cnta + 1;
+      diva <= ~diva;
+   end
+   always @ (posedge clkb) cntb <= cntb + 1;
+   always @ (posedge diva) cntdiv <= cntdiv + 1;
+endmodule
@@ -0,0 +1,46 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+#include "Vt_eval_cycles.h"
+#include "verilated.h"
+
+double sc_time_stamp() { return 0; }  // Until eval_cycles advances the context's time
+
+#define CHECK(got, exp) \
+    if ((got) != (exp)) { \
+	VL_PRINTF("%%Error: %s:%d: GOT = %u  EXP = %u\n", __FILE__, __LINE__, \
+		  static_cast<unsigned>(got), static_cast<unsigned>(exp)); \
+	return 1; \
+    }
+
+static bool reached25(void* userp) {
+    Vt_eval_cycles* topp = static_cast<Vt_eval_cycles*>(userp);
+    return topp->cyc >= 25;
+}
+
+int main(int argc, char** argv, char** env) {
+    Vt_eval_cycles* topp = new Vt_eval_cycles;
+    topp->clk = 0;
+    topp->eval();
+    VerilatedContext* contextp = Verilated::defaultContextp();
+    CHECK(topp->eval_cycles(10), 10);
+    CHECK(topp->cyc, 10);
+    CHECK(topp->clk, 0);
+    CHECK(contextp->time(), 0);
+    // Stopped by the predicate, with time advancing 5 per edge
+    CHECK(topp->eval_cycles(100, reached25, topp, 5), 15);
+    CHECK(topp->cyc, 25);
+    CHECK(contextp->time(), 150);
+    CHECK(topp->posedge_time, 145);
+    // Stopped by $finish, without advancing time
+    CHECK(topp->eval_cycles(100), 25);
+    CHECK(topp->cyc, 50);
+    CHECK(contextp->time(), 150);
+    CHECK(topp->posedge_time, 150);
+    if (!Verilated::gotFinish()) return 1;
+    topp->final();
+    delete topp; topp = NULL;
+    return 0;
+}
@@ -0,0 +1,25 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+module t (/*AUTOARG*/
+   // Outputs
+   cyc, posedge_time,
+   // Inputs
+   clk
+   );
+   input clk;
+   output reg [31:0] cyc;
+   output reg [63:0] posedge_time;
+   initial cyc = 0;
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      posedge_time <= $time;
+      if (cyc == 49) begin
+	 $write("*-* All Finished *-*\n");
+	 $finish;
+      end
+   end
+endmodule
@@ -0,0 +1,65 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer 	cyc=0;
+   reg [63:0]	crc;
+
+   reg [543:0] 	a, b;
+   reg [543:0] 	small, single;
+   reg [1099:0] wa, wb;
+   reg [543:0] 	pow2;
+   reg signed [543:0] sa, sb;
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      crc <= {crc[62:0], crc[63]^crc[2]^crc[0]};
+      a <= {a[479:0], crc};
+      // Divisor grows from one limb to most of the dividend
+      b <= {b[510:0], crc[32:0]};
+      small <= {480'h0, crc | 64'h1};
+      single <= {512'h0, crc[31:0] | 32'h1};
+      wa <= {wa[1035:0], crc};
+      wb <= {wb[1067:0], ~crc[31:0]};
+      pow2 <= 544'h1 << crc[8:0];
+      sa <= {sa[479:0], crc};
+      sb <= {sb[511:0], ~crc[31:0]};
+      if (cyc==0) begin
+	 crc <= 64'h5aef0c8d_d70a4497;
+	 a <= 544'h0;
+	 b <= 544'h0;
+	 if ({544{1'b1}} / 544'h3 != {272{2'b01}}) $stop;
+	 if ({544{1'b1}} % (544'h1 << 300) != {244'h0, {300{1'b1}}}) $stop;
+      end
+      else if (cyc>2 && cyc<90) begin
+	 if ((a / b) * b + (a % b) != a) $stop;
+	 if (a % b >= b) $stop;
+	 if ((a / small) * small + (a % small) != a) $stop;
+	 if (a % small >= small) $stop;
+	 if ((a / single) * single + (a % single) != a) $stop;
+	 if ((wa / wb) * wb + (wa % wb) != wa) $stop;
+	 if (wa % wb >= wb) $stop;
+	 // Dividend smaller than divisor
+	 if (b / (b + 544'h1) != 544'h0) $stop;
+	 if (b % (b + 544'h1) != b) $stop;
+	 // Power of two divisor
+	 if (a / pow2 != a >> crc[8:0]) $stop;
+	 if (a % pow2 != (a & (pow2 - 544'h1))) $stop;
+	 if (a % (544'h1 << 200) != {344'h0, a[199:0]}) $stop;
+	 // Signed
+	 if ((sa / sb) * sb + (sa % sb) != sa) $stop;
+	 if ((-sa) / sb != -(sa / sb)) $stop;
+      end
+      else if (cyc==99) begin
+	 $write("*-* All Finished *-*\n");
+	 $finish;
+      end
+   end
+endmodule
@@ -0,0 +1,64 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer 	cyc=0;
+   reg [63:0]	crc;
+
+   // Odd and even word counts, so both the limb loop and the tail word run
+   reg [95:0] 	a96, b96;
+   reg [127:0] 	a128, b128;
+   reg [159:0] 	a160, b160;
+   reg [255:0] 	a256, b256;
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      crc <= {crc[62:0], crc[63]^crc[2]^crc[0]};
+      a96 <= {crc[31:0], crc};
+      b96 <= {~crc, crc[63:32]};
+      a128 <= {crc, ~crc};
+      b128 <= {crc[31:0], crc, crc[63:32]};
+      a160 <= {crc[31:0], ~crc, crc};
+      b160 <= {crc, crc, ~crc[31:0]};
+      a256 <= {crc, ~crc, crc, ~crc};
+      b256 <= {~crc, crc[31:0], crc, crc, crc[63:32]};
+      if (cyc==0) begin
+	 crc <= 64'h5aef0c8d_d70a4497;
+	 // Carry and borrow across every limb
+	 if (128'hffffffff_ffffffff_ffffffff_ffffffff + 128'h1 != 128'h0) $stop;
+	 if (160'h0 - 160'h1 != {160{1'b1}}) $stop;
+	 if (96'h0_00000000_ffffffff_ffffffff + 96'h1 != 96'h1_00000000_00000000) $stop;
+	 if (256'h1_00000000_00000000_00000000_00000000 - 256'h1
+	     != 256'hffffffff_ffffffff_ffffffff_ffffffff) $stop;
+	 if (-256'h1 != {256{1'b1}}) $stop;
+      end
+      else if (cyc>1 && cyc<90) begin
+	 if ((a96 + b96) - b96 != a96) $stop;
+	 if ((a128 + b128) - b128 != a128) $stop;
+	 if ((a160 + b160) - b160 != a160) $stop;
+	 if ((a256 + b256) - b256 != a256) $stop;
+	 if (a256 + (-a256) != 256'h0) $stop;
+	 if (a160 - b160 != -(b160 - a160)) $stop;
+	 if ((a128 < b128) != (b128 > a128)) $stop;
+	 if ((a128 < b128) == (a128 >= b128)) $stop;
+	 if ((a160 < b160) != ((a160 - b160) > a160)) $stop;
+	 if ((a96 < b96) != ((a96 - b96) > a96)) $stop;
+	 if ((a256 + 256'h1 > a256) != (a256 != {256{1'b1}})) $stop;
+	 if ($signed(a256) < $signed(b256)
+	     != (a256[255] != b256[255] ? a256[255] : a256 < b256)) $stop;
+	 if ((a160 == b160) != (a160 - b160 == 160'h0)) $stop;
+	 if (a128 != a128 + 128'h0) $stop;
+      end
+      else if (cyc==99) begin
+	 $write("*-* All Finished *-*\n");
+	 $finish;
+      end
+   end
+endmodule
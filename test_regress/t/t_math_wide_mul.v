@@ -0,0 +1,57 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer 	cyc=0;
+   reg [63:0]	crc;
+
+   // Odd word count, 64-bit limb schoolbook
+   reg [543:0] 	a, b, c;
+   // Wide enough for Karatsuba
+   reg [2111:0] ka, kb, kc;
+   // Signed, wider than the former VL_MULS_MAX_WORDS limit
+   reg signed [1023:0] sa, sb;
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      crc <= {crc[62:0], crc[63]^crc[2]^crc[0]};
+      a <= {a[479:0], crc};
+      b <= {b[479:0], ~crc};
+      c <= {c[511:0], crc[31:0]};
+      ka <= {ka[2047:0], crc};
+      kb <= {kb[2047:0], crc ^ {crc[31:0], crc[63:32]}};
+      kc <= {kc[2079:0], ~crc[31:0]};
+      sa <= {sa[959:0], crc};
+      sb <= {sb[959:0], crc[31:0], ~crc[63:32]};
+      if (cyc==0) begin
+	 crc <= 64'h5aef0c8d_d70a4497;
+	 // All-ones times all-ones is 1 in the low bits
+	 if ({544{1'b1}} * {544{1'b1}} != 544'h1) $stop;
+	 if ({2112{1'b1}} * {2112{1'b1}} != 2112'h1) $stop;
+      end
+      else if (cyc>1 && cyc<90) begin
+	 if (a * b != b * a) $stop;
+	 if (a * (b + c) != a * b + a * c) $stop;
+	 if (a * 544'h1 != a) $stop;
+	 if (a * (544'h1 << 100) != a << 100) $stop;
+	 if (ka * kb != kb * ka) $stop;
+	 if (ka * (kb + kc) != ka * kb + ka * kc) $stop;
+	 if ((ka * kb) * kc != ka * (kb * kc)) $stop;
+	 if (ka * (2112'h1 << 1500) != ka << 1500) $stop;
+	 if ((-sa) * sb != -(sa * sb)) $stop;
+	 if (sa * sb != $signed($unsigned(sa) * $unsigned(sb))) $stop;
+	 if ((sa * -1024'sd1) != -sa) $stop;
+      end
+      else if (cyc==99) begin
+	 $write("*-* All Finished *-*\n");
+	 $finish;
+      end
+   end
+endmodule
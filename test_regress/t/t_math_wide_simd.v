@@ -0,0 +1,70 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer 	cyc=0;
+   reg [63:0]	crc;
+
+   // Wide enough for the SIMD kernels; 1000 bits leaves a partial top word
+   reg [1023:0] a, b;
+   reg [999:0] 	c, d;
+
+   reg [1023:0] and_a, or_a, xor_a;
+   reg [999:0] 	xor_c;
+   integer 	ones;
+   reg 		par;
+   integer 	i;
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      crc <= {crc[62:0], crc[63]^crc[2]^crc[0]};
+      a <= {a[959:0], crc};
+      // Mostly equal to a, so compares must find a late difference
+      b <= (cyc[2:0] == 3'd0) ? a : {a[1023:64], crc ^ a[63:0]};
+      c <= {c[935:0], ~crc};
+      d <= (cyc[1:0] == 2'd0) ? {c[999:1], ~c[0]} : c;
+      if (cyc==0) begin
+	 crc <= 64'h5aef0c8d_d70a4497;
+	 a <= 1024'h0;
+	 c <= 1000'h0;
+      end
+      else if (cyc>20 && cyc<90) begin
+	 and_a = a & b;
+	 or_a = a | b;
+	 xor_a = a ^ b;
+	 xor_c = c ^ d;
+	 ones = 0;
+	 par = 1'b0;
+	 for (i=0; i<1024; i=i+1) begin
+	    if (and_a[i] != (a[i] & b[i])) $stop;
+	    if (or_a[i] != (a[i] | b[i])) $stop;
+	    if (xor_a[i] != (a[i] ^ b[i])) $stop;
+	    ones = ones + {31'b0, a[i]};
+	    par = par ^ a[i];
+	 end
+	 for (i=0; i<1000; i=i+1) begin
+	    if (xor_c[i] != (c[i] ^ d[i])) $stop;
+	 end
+	 if ($countones(a) != ones) $stop;
+	 if (^a != par) $stop;
+	 if ((a == b) != (xor_a == 1024'h0)) $stop;
+	 if ((a != b) != (|xor_a)) $stop;
+	 if ((c == d) != (xor_c == 1000'h0)) $stop;
+	 if ((a < b) != ((a - b) > a)) $stop;
+	 if ((a > b) != (b < a)) $stop;
+	 if ((c < d) != ((c - d) > c)) $stop;
+	 if ((c >= d) == (c < d)) $stop;
+      end
+      else if (cyc==99) begin
+	 $write("*-* All Finished *-*\n");
+	 $finish;
+      end
+   end
+endmodule
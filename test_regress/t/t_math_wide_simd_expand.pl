@@ -0,0 +1,26 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2003-2018 by Wilson Snyder. This program is free software; you can
+# redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+
+scenarios(vlt_all => 1);
+
+top_filename("t/t_math_wide_simd.v");
+
+compile(
+    verilator_flags2 => ["--no-wide-simd -CFLAGS -DVL_NO_SIMD"],
+    );
+
+# Expanded per word, as for targets without the kernels
+file_grep_not ("$Self->{obj_dir}/$Self->{VM_PREFIX}.cpp", qr/VL_(AND|OR|XOR)_W/);
+
+execute(
+    check_finished => 1,
+    );
+
+ok(1);
+1;
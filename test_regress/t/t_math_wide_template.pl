@@ -0,0 +1,23 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2018 by Wilson Snyder. This program is free software; you can
+# redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+
+scenarios(vlt => 1);
+
+compile(
+    );
+
+file_grep ("$Self->{obj_dir}/$Self->{VM_PREFIX}.cpp", qr/VL_ADD_W<4>\(/);
+file_grep ("$Self->{obj_dir}/$Self->{VM_PREFIX}.cpp", qr/VL_MUL_W<4>\(/);
+
+execute(
+    check_finished => 1,
+    );
+
+ok(1);
+1;
@@ -0,0 +1,58 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer 	cyc=0;
+   reg [63:0]	crc;
+
+   reg [127:0] 	a, b;
+   reg [127:0] 	sum, diff, prod, neg;
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      crc <= {crc[62:0], crc[63]^crc[2]^crc[0]};
+      a <= {crc, ~crc};
+      b <= {crc[31:0], crc, crc[63:32]};
+      if (cyc==0) begin
+	 crc <= 64'h5aef0c8d_d70a4497;
+      end
+      else if (cyc==2) begin
+	 // a = {crc, ~crc}, b = {crc[31:0], crc, crc[63:32]} with crc=5aef0c8d_d70a4497
+	 if (a != 128'h5aef0c8d_d70a4497_a510f372_28f5bb68) $stop;
+	 if (b != 128'hd70a4497_5aef0c8d_d70a4497_5aef0c8d) $stop;
+	 if (a + b != 128'h31f95125_31f95125_7c1b3809_83e4c7f5) $stop;
+	 if (a - b != 128'h83e4c7f6_7c1b3809_ce06aeda_ce06aedb) $stop;
+	 if ($countones(a) != 64) $stop;
+	 if ($clog2(b) != 128) $stop;
+      end
+      else if (cyc>2 && cyc<90) begin
+	 sum = a + b;
+	 diff = a - b;
+	 prod = a * b;
+	 neg = -a;
+	 if (sum - b != a) $stop;
+	 if (diff + b != a) $stop;
+	 if (neg + a != 128'h0) $stop;
+	 if (prod != b * a) $stop;
+	 if ((a == b) == (a != b)) $stop;
+	 if ((a < b) != (b > a)) $stop;
+	 if ((a <= b) != (b >= a)) $stop;
+	 if ((a <= b) != ((a < b) || (a == b))) $stop;
+	 if ($countones(a ^ b) != $countones(a & ~b) + $countones(~a & b)) $stop;
+	 if (^(a ^ b) != (^a ^ ^b)) $stop;
+	 if ($onehot(a) || !$onehot0(a & ~a)) $stop;
+	 if (~(a | b) != (~a & ~b)) $stop;
+      end
+      else if (cyc==99) begin
+	 $write("*-* All Finished *-*\n");
+	 $finish;
+      end
+   end
+endmodule
@@ -0,0 +1,72 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer 	cyc=0;
+   reg [63:0]	crc;
+   reg [31:0]	slow;	// Changes every 8th cycle, so its logic is mostly skipped
+   reg [31:0]	fast;
+
+   wire [31:0]	slow_mix;
+   wire [31:0]	fast_mix;
+   mix mslow (.in(slow), .out(slow_mix));
+   mix mfast (.in(fast), .out(fast_mix));
+
+   function [31:0] f_mix;
+      input [31:0] in;
+      integer i;
+      begin
+	 f_mix = in;
+	 for (i=0; i<8; i=i+1) begin
+	    f_mix = {f_mix[26:0], f_mix[31:27]} ^ (f_mix + 32'h9e3779b9);
+	 end
+      end
+   endfunction
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      crc <= {crc[62:0], crc[63]^crc[2]^crc[0]};
+      fast <= crc[31:0];
+      if (cyc[2:0] == 3'd0) slow <= crc[63:32];
+      if (cyc==0) begin
+	 crc <= 64'h5aef0c8d_d70a4497;
+	 slow <= 32'h0;
+	 fast <= 32'h0;
+      end
+      else if (cyc > 2) begin
+`ifdef TEST_VERBOSE
+	 $write("[%0t] cyc=%0d slow=%x %x fast=%x %x\n", $time, cyc, slow, slow_mix, fast, fast_mix);
+`endif
+	 if (slow_mix != f_mix(slow)) $stop;
+	 if (fast_mix != f_mix(fast)) $stop;
+      end
+      if (cyc == 99) begin
+	 $write("*-* All Finished *-*\n");
+	 $finish;
+      end
+   end
+endmodule
+
+module mix (/*AUTOARG*/
+   // Outputs
+   out,
+   // Inputs
+   in
+   );
+   input [31:0] in;
+   output reg [31:0] out;
+   integer i;
+   always @* begin
+      out = in;
+      for (i=0; i<8; i=i+1) begin
+	 out = {out[26:0], out[31:27]} ^ (out + 32'h9e3779b9);
+      end
+   end
+endmodule
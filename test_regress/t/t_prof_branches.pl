@@ -0,0 +1,41 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2018 by Wilson Snyder. This program is free software; you can
+# redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+
+scenarios(vlt_all => 1);
+
+compile(
+    make_top_shell => 0,
+    make_main => 0,
+    verilator_flags2 => ["--exe $Self->{t_dir}/$Self->{name}.cpp --prof-branches"],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+file_grep("$Self->{obj_dir}/profile_branches.dat", qr/^VLPROF branch \w+ \d+ \d+ \d+ \d+ \d+$/m);
+file_grep("$Self->{obj_dir}/profile_branches.dat", qr/^VLPROF branch \w+ [1-9]\d* [1-9]\d*$/m);
+
+# Recompile using the counts
+compile(
+    make_top_shell => 0,
+    make_main => 0,
+    verilator_flags2 => ["--exe $Self->{t_dir}/$Self->{name}.cpp --prof-branches --stats",
+                         "--prof-branches-data $Self->{obj_dir}/profile_branches.dat"],
+    );
+
+file_grep($Self->{stats}, qr/Optimizations, Branch hints from profile\s+[1-9]\d*/i);
+file_grep($Self->{stats}, qr/Optimizations, Cases reordered by profile\s+1/i);
+
+execute(
+    check_finished => 1,
+    );
+
+ok(1);
+1;
@@ -0,0 +1,54 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer 	cyc=0;
+
+   // Mostly 3, rarely 1, never 0 or 2
+   wire [1:0] 	op = (cyc[3:0] == 4'd0) ? 2'd1 : 2'd3;
+
+   reg [7:0] 	acc = 8'h0;
+   reg [7:0] 	accref = 8'h0;
+   reg [7:0] 	rare = 8'h0;
+   reg [7:0] 	rareref = 8'h0;
+
+   always @ (posedge clk) begin
+      case (op)
+	2'd0: acc <= acc + 8'd1;
+	2'd1: acc <= acc + 8'd2;
+	2'd2: acc <= acc + 8'd3;
+	2'd3: acc <= acc ^ 8'h5a;
+	default: acc <= 8'h0;
+      endcase
+      if (cyc == 50) rare <= acc;
+   end
+
+   // Same function without if or case statements
+   always @ (posedge clk) begin
+      accref <= ((op == 2'd0) ? accref + 8'd1
+		 : (op == 2'd1) ? accref + 8'd2
+		 : (op == 2'd2) ? accref + 8'd3
+		 : accref ^ 8'h5a);
+      rareref <= (cyc == 50) ? accref : rareref;
+   end
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+`ifdef TEST_VERBOSE
+      $write("[%0t] cyc=%0d op=%0d acc=%x accref=%x\n", $time, cyc, op, acc, accref);
+`endif
+      if (acc !== accref) $stop;
+      if (rare !== rareref) $stop;
+      if (cyc == 99) begin
+	 $write("*-* All Finished *-*\n");
+	 $finish;
+      end
+   end
+endmodule
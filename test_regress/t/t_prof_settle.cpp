@@ -0,0 +1,42 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+#include <verilated.h>
+#include VM_PREFIX_INCLUDE
+
+#define STRINGIFY(x) STRINGIFY2(x)
+#define STRINGIFY2(x) #x
+
+vluint64_t main_time = 0;
+double sc_time_stamp() { return main_time; }
+
+int main(int argc, char** argv, char** env) {
+    Verilated::commandArgs(argc, argv);
+    VM_PREFIX* topp = new VM_PREFIX("top");
+    topp->clk = 0;
+    topp->eval();
+    while (!Verilated::gotFinish() && main_time < 1000) {
+        main_time += 5;
+        topp->clk = !topp->clk;
+        topp->eval();
+    }
+    if (!Verilated::gotFinish()) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Timeout; never got a $finish");
+    }
+    // Every eval of the loop needs at least a second iteration
+    vluint64_t evals = 0;
+    for (int i = 0; i < VerilatedSettleProf::ITERATION_BUCKETS; ++i) {
+        evals += topp->settleProf().evalIterations(i);
+    }
+    if (!evals || topp->settleProf().evalIterations(1) == evals) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: No settle iterations counted");
+    }
+    Verilated::profSettleDump(STRINGIFY(TEST_OBJ_DIR) "/profile_settle.dat");
+    topp->final();
+    delete topp; topp = NULL;
+    return 0;
+}
@@ -0,0 +1,30 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2003-2018 by Wilson Snyder. This program is free software; you can
+# redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+
+scenarios(vlt_all => 1);
+
+top_filename("t/t_unopt_combo.v");
+
+compile(
+    make_top_shell => 0,
+    make_main => 0,
+    v_flags2 => ['+define+ALLOW_UNOPT'],
+    verilator_flags2 => ["--exe $Self->{t_dir}/$Self->{name}.cpp --prof-settle"],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+file_grep ("$Self->{obj_dir}/profile_settle.dat", qr/Settle profile of model top/);
+file_grep ("$Self->{obj_dir}/profile_settle.dat", qr/Initial settle: [1-9]\d* iterations/);
+file_grep ("$Self->{obj_dir}/profile_settle.dat", qr/^\s+[1-9]\d*\s+TOP\.t\./m);
+
+ok(1);
+1;
@@ -0,0 +1,35 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+#include <verilated.h>
+#include VM_PREFIX_INCLUDE
+
+#define STRINGIFY(x) STRINGIFY2(x)
+#define STRINGIFY2(x) #x
+
+vluint64_t main_time = 0;
+double sc_time_stamp() { return main_time; }
+
+int main(int argc, char** argv, char** env) {
+    VM_PREFIX* topp = new VM_PREFIX;
+    topp->clk = 0;
+    topp->eval();
+    while (!Verilated::gotFinish() && main_time < 1000) {
+        main_time += 5;
+        topp->clk = !topp->clk;
+        topp->eval();
+    }
+    if (!Verilated::gotFinish()) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Timeout; never got a $finish");
+    }
+    Verilated::profThreadsDump(STRINGIFY(TEST_OBJ_DIR) "/profile_threads.json",
+                               STRINGIFY(TEST_OBJ_DIR) "/profile_threads.txt",
+                               STRINGIFY(TEST_OBJ_DIR) "/profile_threads.dat");
+    topp->final();
+    delete topp; topp = NULL;
+    exit(0);
+}
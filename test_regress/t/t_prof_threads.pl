@@ -0,0 +1,46 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2003-2018 by Wilson Snyder. This program is free software; you can
+# redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+
+scenarios(vlt_all => 1);
+$Self->cfg_with_threaded or skip("No thread support");
+
+top_filename("t/t_threads_partition.v");
+
+compile(
+    make_top_shell => 0,
+    make_main => 0,
+    verilator_flags2 => ["--exe $Self->{t_dir}/$Self->{name}.cpp --threads 2 --prof-threads"],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+file_grep("$Self->{obj_dir}/profile_threads.json", qr/"traceEvents"/);
+file_grep("$Self->{obj_dir}/profile_threads.json", qr/"name":"mt1"/);
+file_grep("$Self->{obj_dir}/profile_threads.txt", qr/Evals recorded: +\d+/);
+file_grep("$Self->{obj_dir}/profile_threads.txt", qr/Thread 1 +utilization/);
+file_grep("$Self->{obj_dir}/profile_threads.dat", qr/^VLPROF mtask 1 ticks [0-9.]+ cost \d+ blocks \w+:\d+/m);
+
+# Repartition using the measured costs
+compile(
+    make_top_shell => 0,
+    make_main => 0,
+    verilator_flags2 => ["--exe $Self->{t_dir}/$Self->{name}.cpp --threads 2 --prof-threads --stats",
+                         "--prof-threads-data $Self->{obj_dir}/profile_threads.dat"],
+    );
+
+file_grep($Self->{stats}, qr/MTask, Profiled logic\s+[1-9]\d*/i);
+
+execute(
+    check_finished => 1,
+    );
+
+ok(1);
+1;
@@ -0,0 +1,24 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2018 by Wilson Snyder. This program is free software; you can
+# redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+
+scenarios(vlt_all => 1);
+
+# Without splitting, x and w would give UNOPTFLAT warnings, failing the compile
+compile(
+    verilator_flags2 => ["--stats"],
+    );
+
+file_grep ($Self->{stats}, qr/Optimizations, Split packed variables\s+2/i);
+
+execute(
+    check_finished => 1,
+    );
+
+ok(1);
+1;
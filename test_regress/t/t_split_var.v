@@ -0,0 +1,55 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer 	cyc=0;
+   reg [63:0]	crc;
+   wire [7:0]	in = crc[7:0];
+
+   // Bits of x feed each other only through different blocks; unless x is
+   // split this is an UNOPTFLAT loop
+   reg [11:0]	x;
+   always @* begin
+      x[11:4] = {in[3:0], in[7:4]} + 8'd3;  // Spans two slices
+      x[7:4] = x[11:8] ^ in[3:0];
+   end
+   always @* x[3:0] = in[3:0] ^ x[7:4];
+
+   wire [7:0]	w;
+   assign w[7:4] = in[7:4] + {2'b0, w[1:0]};
+   assign w[3:0] = in[3:0];
+
+   wire [7:0] 	a = {in[3:0], in[7:4]} + 8'd3;
+   wire [3:0] 	x_7_4 = a[7:4] ^ in[3:0];
+   wire [3:0] 	x_3_0 = in[3:0] ^ x_7_4;
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      crc <= {crc[62:0], crc[63]^crc[2]^crc[0]};
+      if (cyc==0) begin
+	 crc <= 64'h5aef0c8d_d70a4497;
+      end
+      else if (cyc<90) begin
+`ifdef TEST_VERBOSE
+	 $write("[%0t] in=%x x=%x%x%x w=%x%x\n", $time, in, x[11:8], x[7:4], x[3:0], w[7:4], w[3:0]);
+`endif
+	 if (x[11:8] !== a[7:4]) $stop;
+	 if (x[7:4] !== x_7_4) $stop;
+	 if (x[3:0] !== x_3_0) $stop;
+	 if (x[5:2] !== {x_7_4[1:0], x_3_0[3:2]}) $stop;
+	 if (w[7:4] !== in[7:4] + {2'b0, in[1:0]}) $stop;
+	 if (w[3:0] !== in[3:0]) $stop;
+      end
+      else if (cyc==99) begin
+	 $write("*-* All Finished *-*\n");
+	 $finish;
+      end
+   end
+endmodule
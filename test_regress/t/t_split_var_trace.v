@@ -0,0 +1,25 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+module t
+  (
+   input wire clk
+   );
+
+   integer    cyc; initial cyc = 0;
+   wire [7:0] in = cyc[7:0] * 8'd29;
+
+   // Would be split as in t_split_var, but is traced, so must stay whole
+   reg [11:0] x;
+   always @* begin
+      x[11:4] = {in[3:0], in[7:4]} + 8'd3;
+      x[7:4] = x[11:8] ^ in[3:0];
+   end
+   always @* x[3:0] = in[3:0] ^ x[7:4];
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+   end
+endmodule
@@ -0,0 +1,26 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2003-2018 by Wilson Snyder. This program is free software; you can
+# redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+
+scenarios(simulator => 1);
+
+unlink("$Self->{obj_dir}/t_sys_file_buffer.log");
+unlink("$Self->{obj_dir}/t_sys_file_buffer2.log");
+
+compile(
+    v_flags2 => ['+incdir+../include'],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+file_grep("$Self->{obj_dir}/t_sys_file_buffer.log", qr/^line 0\nline 1\n.*line 9999\nlast\n$/s);
+
+ok(1);
+1;
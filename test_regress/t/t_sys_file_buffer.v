@@ -0,0 +1,73 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+`include "verilated.v"
+
+`define STRINGIFY(x) `"x`"
+`define LOG {`STRINGIFY(`TEST_OBJ_DIR),"/t_sys_file_buffer.log"}
+// Lines written; over 64KB, so the write buffer fills more than once
+`define LINES 10000
+
+module t;
+   `verilator_file_descriptor file;
+   `verilator_file_descriptor rfile;
+   `verilator_file_descriptor closed;
+
+   integer	i;
+   integer	chars;
+   reg [16*8:1]	line;
+   reg [16*8:1]	expline;
+
+   initial begin
+      file = $fopen(`LOG, "w");
+      if (file == 0) $stop;
+      for (i = 0; i < `LINES; i = i + 1) begin
+         $fwrite(file, "line %0d\n", i);
+      end
+      $fflush(file);
+
+      // After $fflush, another reader sees every line, in order
+      rfile = $fopen(`LOG, "r");
+      if (rfile == 0) $stop;
+      for (i = 0; i < `LINES; i = i + 1) begin
+         chars = $fgets(line, rfile);
+         $sformat(expline, "line %0d\n", i);
+         if (chars == 0 || line != expline) begin
+            $write("%%Error: line %0d read as '%0s'\n", i, line);
+            $stop;
+         end
+      end
+      $fclose(rfile);
+
+      // Written by $fclose, after the earlier lines
+      $fwrite(file, "last\n");
+      closed = file;
+      $fclose(file);
+
+      rfile = $fopen(`LOG, "r");
+      for (i = 0; i < `LINES; i = i + 1) chars = $fgets(line, rfile);
+      chars = $fgets(line, rfile);
+      if (chars != 5 || line != "last\n") $stop;
+      chars = $fgets(line, rfile);
+      if (chars != 0) $stop;
+      $fclose(rfile);
+
+`ifdef verilator
+      // A closed descriptor is reused by the next $fopen
+      file = $fopen({`STRINGIFY(`TEST_OBJ_DIR),"/t_sys_file_buffer2.log"}, "w");
+      if (file != closed) $stop;
+      $fwrite(file, "reused\n");
+      $fclose(file);
+      // Its old file is unaffected
+      rfile = $fopen(`LOG, "r");
+      chars = $fgets(line, rfile);
+      if (line != "line 0\n") $stop;
+      $fclose(rfile);
+`endif
+
+      $write("*-* All Finished *-*\n");
+      $finish;
+   end
+endmodule
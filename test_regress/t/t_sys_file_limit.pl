@@ -0,0 +1,28 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2003-2018 by Wilson Snyder. This program is free software; you can
+# redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+
+scenarios(vlt_all => 1);
+
+# The descriptor table fills at 1021 files, unless the process's own limit
+# on open files is hit first, in which case just check $fopen fails cleanly
+my $nofile = `sh -c 'ulimit -n'`;
+chomp $nofile;
+my $expect = ($nofile eq "unlimited" || $nofile >= 1100) ? 1021 : 0;
+
+compile(
+    v_flags2 => ['+incdir+../include'],
+    );
+
+execute(
+    check_finished => 1,
+    all_run_flags => ["+expected=$expect"],
+    );
+
+ok(1);
+1;
@@ -0,0 +1,50 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+`include "verilated.v"
+
+`define STRINGIFY(x) `"x`"
+`define MAX_OPEN 1100
+
+module t;
+   `verilator_file_descriptor files [0:`MAX_OPEN-1];
+   `verilator_file_descriptor file;
+
+   integer	i;
+   integer	opened;
+   integer	expected;
+
+   initial begin
+      if (!$value$plusargs("expected=%d", expected)) $stop;
+
+      // Open until the table is full, which $fopen reports by returning 0
+      opened = 0;
+      for (i = 0; i < `MAX_OPEN; i = i + 1) begin
+         files[i] = $fopen("t/t_sys_file_limit.v", "r");
+         if (files[i] != 0) opened = opened + 1;
+      end
+      if (expected != 0 && opened != expected) begin
+         $write("%%Error: opened %0d files, expected %0d\n", opened, expected);
+         $stop;
+      end
+      if (opened == 0 || opened > 1021) $stop;
+      // Every later open failed
+      for (i = opened; i < `MAX_OPEN; i = i + 1) if (files[i] != 0) $stop;
+
+      // Closing one frees a descriptor for the next $fopen
+      file = files[0];
+      $fclose(files[0]);
+      files[0] = $fopen("t/t_sys_file_limit.v", "r");
+      if (files[0] != file) $stop;
+
+      for (i = 0; i < opened; i = i + 1) $fclose(files[i]);
+      file = $fopen("t/t_sys_file_limit.v", "r");
+      if (file == 0) $stop;
+      $fclose(file);
+
+      $write("*-* All Finished *-*\n");
+      $finish;
+   end
+endmodule
@@ -0,0 +1,41 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2003-2018 by Wilson Snyder. This program is free software; you can
+# redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+
+scenarios(vlt_all => 1);
+$Self->cfg_with_threaded or skip("No thread support");
+
+unlink("$Self->{obj_dir}/t_sys_file_threads.log");
+
+compile(
+    v_flags2 => ['+incdir+../include'],
+    verilator_flags2 => ['--threads 4'],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+# Writers' lines may interleave, but each is whole and each writer's are in order
+my %next;
+foreach my $line (split /\n/, file_contents("$Self->{obj_dir}/t_sys_file_threads.log")) {
+    if ($line !~ /^([a-d]) (\d+)$/) {
+        error("Garbled line: '$line'");
+        last;
+    }
+    my ($writer, $cyc) = ($1, $2);
+    $next{$writer} ||= 0;
+    error("Writer $writer line $cyc out of order") if $cyc != $next{$writer};
+    $next{$writer} = $cyc + 1;
+}
+foreach my $writer (qw(a b c d)) {
+    error("Writer $writer wrote ".($next{$writer}||0)." lines") if ($next{$writer}||0) != 100;
+}
+
+ok(1);
+1;
@@ -0,0 +1,63 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+`include "verilated.v"
+
+`define STRINGIFY(x) `"x`"
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+
+   input clk;
+
+   `verilator_file_descriptor file;
+   integer cyc = 0;
+
+   initial begin
+      file = $fopen({`STRINGIFY(`TEST_OBJ_DIR),"/t_sys_file_threads.log"}, "w");
+      if (file == 0) $stop;
+   end
+
+   // Independent writers to one descriptor, so may run as concurrent mtasks
+   reg [31:0] suma = 0;
+   reg [31:0] sumb = 0;
+   reg [31:0] sumc = 0;
+   reg [31:0] sumd = 0;
+   always @ (posedge clk) begin
+      if (cyc < 100) begin
+         suma <= suma * 3 + cyc;
+         $fwrite(file, "a %0d\n", cyc);
+      end
+   end
+   always @ (posedge clk) begin
+      if (cyc < 100) begin
+         sumb <= sumb * 5 + cyc;
+         $fwrite(file, "b %0d\n", cyc);
+      end
+   end
+   always @ (posedge clk) begin
+      if (cyc < 100) begin
+         sumc <= sumc * 7 + cyc;
+         $fwrite(file, "c %0d\n", cyc);
+      end
+   end
+   always @ (posedge clk) begin
+      if (cyc < 100) begin
+         sumd <= sumd * 9 + cyc;
+         $fwrite(file, "d %0d\n", cyc);
+      end
+   end
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      if (cyc == 101) begin
+         $fclose(file);
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
@@ -0,0 +1,28 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2003-2018 by Wilson Snyder. This program is free software; you can
+# redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+
+scenarios(simulator => 1);
+$Self->cfg_with_threaded or skip("No thread support");
+
+compile(
+    verilator_flags2 => ['--cc --threads 2'],
+    );
+
+execute(
+    check_finished => 1,
+    expect => quotemeta(
+'[0] a0=00000000 a1=00000000 sum=00000000
+[1] a0=00000000 a1=00000001 sum=00000001
+[2] a0=00000001 a1=00000007 sum=00000008
+[3] a0=00000005 a1=00000026 sum=0000002b
+*-* All Finished *-*'),
+    );
+
+ok(1);
+1;
@@ -0,0 +1,32 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+
+   input clk;
+
+   integer cyc = 0;
+
+   // Independent accumulators, so the displays run in an mtask
+   reg [31:0] a0 = 0;
+   reg [31:0] a1 = 0;
+   always @ (posedge clk) a0 <= a0 * 32'd3 + cyc;
+   always @ (posedge clk) a1 <= a1 * 32'd5 + cyc + 1;
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      // Partial lines, which are buffered together
+      $write("[%0d] a0=%x", cyc, a0);
+      $write(" a1=%x", a1);
+      $display(" sum=%x", a0 + a1);
+      if (cyc==3) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
@@ -0,0 +1,26 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2003-2018 by Wilson Snyder. This program is free software; you can
+# redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+
+scenarios(simulator => 1);
+$Self->cfg_with_threaded or skip("No thread support");
+
+compile(
+    verilator_flags2 => ['--cc --threads 4 --stats'],
+    );
+
+if ($Self->{vlt}) {
+    file_grep ($Self->{stats}, qr/MTask, Count\s+(\d+)/i);
+}
+
+execute(
+    check_finished => 1,
+    );
+
+ok(1);
+1;
@@ -0,0 +1,45 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+
+   input clk;
+
+   integer cyc = 0;
+
+   // Independent accumulators, which may each land in their own mtask
+   reg [31:0] a0 = 0;
+   reg [31:0] a1 = 0;
+   reg [31:0] a2 = 0;
+   reg [31:0] a3 = 0;
+   always @ (posedge clk) a0 <= a0 * 32'd3 + cyc;
+   always @ (posedge clk) a1 <= a1 * 32'd5 + cyc + 1;
+   always @ (posedge clk) a2 <= a2 * 32'd7 + cyc + 2;
+   always @ (posedge clk) a3 <= a3 * 32'd11 + cyc + 3;
+
+   // Joins them all back together
+   wire [31:0] sum = a0 ^ a1 ^ a2 ^ a3;
+   reg [31:0]  b = 0;
+   always @ (posedge clk) b <= b + sum;
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      if (cyc==99) begin
+`ifdef TEST_VERBOSE
+         $write("[%0t] b=%x a=%x %x %x %x\n", $time, b, a0, a1, a2, a3);
+`endif
+         if (a0 !== 32'h269a0175) $stop;
+         if (a1 !== 32'h08a82e76) $stop;
+         if (a2 !== 32'h5161792b) $stop;
+         if (a3 !== 32'h9571f5cc) $stop;
+         if (b !== 32'hacf7b312) $stop;
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
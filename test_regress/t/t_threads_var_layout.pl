@@ -0,0 +1,32 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2003-2018 by Wilson Snyder. This program is free software; you can
+# redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+
+scenarios(simulator => 1);
+$Self->cfg_with_threaded or skip("No thread support");
+
+top_filename("t/t_threads_partition.v");
+
+compile(
+    verilator_flags2 => ['--cc --threads 4 --threads-var-layout'],
+    );
+
+if ($Self->{vlt}) {
+    file_grep ("$Self->{obj_dir}/$Self->{VM_PREFIX}.h", qr/__Vpad\d+\[VL_CACHE_LINE_BYTES\]/);
+    file_grep ("$Self->{obj_dir}/$Self->{VM_PREFIX}__Syms.h", qr/_pad\[VL_CACHE_LINE_BYTES\]/);
+    # Padded before the first counter too
+    file_grep ("$Self->{obj_dir}/$Self->{VM_PREFIX}__Syms.h",
+               qr/__Vm_mt_pad\[VL_CACHE_LINE_BYTES\];\s*VlMTaskVertex __Vm_mt_final;/);
+}
+
+execute(
+    check_finished => 1,
+    );
+
+ok(1);
+1;
@@ -0,0 +1,27 @@
+#!/usr/bin/perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2003-2018 by Wilson Snyder. This program is free software; you can
+# redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+
+scenarios(vlt_all => 1);
+
+top_filename("t/t_unopt_combo.v");
+
+compile(
+    v_flags2 => ['+define+ALLOW_UNOPT'],
+    verilator_flags2 => ["--stats"],
+    );
+
+file_grep ($Self->{stats}, qr/Optimizations, Changed dirty flags\s+[1-9]/i);
+file_grep ("$Self->{obj_dir}/$Self->{VM_PREFIX}.cpp", qr/_change_request_dirty/);
+
+execute(
+    check_finished => 1,
+    );
+
+ok(1);
+1;
@@ -0,0 +1,74 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+#include <verilated.h>
+#include <verilated_vpi.h>
+#include VM_PREFIX_INCLUDE
+#include <thread>
+
+double sc_time_stamp() { return 0; }  // Unused, each context has its own time
+
+static int valueCb(p_cb_data cb_data) {
+    ++*reinterpret_cast<int*>(cb_data->user_data);
+    return 0;
+}
+
+// Run one simulation in its own context, counting changes of its cyc
+// through a VPI callback, which must not see the other context's changes
+static void runSeed(VerilatedContext* contextp, const char* plusargp, int* countp) {
+    const char* argv[] = { "t_vpi_context", plusargp };
+    contextp->commandArgs(2, argv);
+    VM_PREFIX* topp = new VM_PREFIX("", contextp);  // Null name, so scope is "t"
+    topp->clk = 0;
+    topp->eval();
+
+    vpiHandle cych = vpi_handle_by_name((PLI_BYTE8*)"t.cyc", NULL);
+    if (!cych) vl_fatal(__FILE__, __LINE__, "main", "%Error: No handle for t.cyc");
+    s_vpi_value v;
+    v.format = vpiIntVal;
+    t_cb_data cb_data;
+    cb_data.reason = cbValueChange;
+    cb_data.cb_rtn = valueCb;
+    cb_data.obj = cych;
+    cb_data.value = &v;
+    cb_data.time = NULL;
+    cb_data.user_data = reinterpret_cast<PLI_BYTE8*>(countp);
+    vpiHandle cbh = vpi_register_cb(&cb_data);
+    if (!cbh) vl_fatal(__FILE__, __LINE__, "main", "%Error: vpi_register_cb failed");
+
+    while (!contextp->gotFinish() && contextp->time() < 1000) {
+        contextp->timeInc(5);
+        topp->clk = !topp->clk;
+        topp->eval();
+        VerilatedVpi::callValueCbs();
+    }
+    vpi_get_value(cych, &v);
+    if (*countp != v.value.integer) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Callback count differs from changes");
+    }
+    vpi_remove_cb(cbh);
+    topp->final();
+    delete topp; topp = NULL;
+}
+
+int main(int argc, char** argv, char** env) {
+    VerilatedContext context2;
+    VerilatedContext context4;
+    int count2 = 0;
+    int count4 = 0;
+    std::thread thread2 (runSeed, &context2, "+seed=2", &count2);
+    std::thread thread4 (runSeed, &context4, "+seed=4", &count4);
+    thread2.join();
+    thread4.join();
+    if (!context2.gotFinish() || !context4.gotFinish()) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Timeout; never got a $finish");
+    }
+    if (count2 != 21 || count4 != 41) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Callbacks ran in the wrong context");
+    }
+    exit(0);
+}
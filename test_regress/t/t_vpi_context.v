@@ -0,0 +1,27 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed into the Public Domain, for any use,
+// without warranty, 2018 by Wilson Snyder.
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+
+   input clk;
+
+   integer cyc /*verilator public_flat_rw @(posedge clk) */ = 0;
+   integer seed;
+
+   initial begin
+      if (!$value$plusargs("seed=%d", seed)) $stop;
+   end
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      if (cyc == seed*10) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule